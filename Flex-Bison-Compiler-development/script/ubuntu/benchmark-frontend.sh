@@ -0,0 +1,72 @@
+#! /bin/bash
+
+set -u
+
+BASE_PATH="$(dirname "$0")/../.."
+cd "$BASE_PATH"
+
+# Compiles two long pages with the compiler in "build", and shows how long each compilation takes with each
+# way of lexing and parsing them: a structure-heavy page (many small elements, with short strings), and a
+# text-heavy one (fewer elements, with long strings). The structural lexer splits them in chunks, and the
+# parallel parser splits the elements of the body among workers (both up to one per processor, so with a
+# single one nothing is parsed ahead), so the number of chunks and of elements parsed ahead are shown too.
+# The pipeline needs more than one processor too (otherwise, the page is compiled as with Flex).
+# The size of the pages and the repetitions are the arguments (by default, 20000 elements and 5
+# repetitions, of which the fastest is shown).
+ELEMENTS="${1:-20000}"
+REPETITIONS="${2:-5}"
+CORPUS="$(mktemp --directory)"
+
+TEXT="lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor incididunt ut labore et dolore"
+TEXT="$TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT $TEXT"
+{
+	echo '{ type: html, { type: head, content: { type: title, content: "Structure" } }, { type: body, content: ['
+	for ((k = 0; k < ELEMENTS; ++k)); do
+		echo "{ type: div, style: { color: \"navy\", margin: $((k % 50)) }, content: [ { type: h1, content: \"Section $k\" }, { type: p, content: \"Paragraph $k\" } ] },"
+	done
+	echo '{ type: p, content: "End" } ] } }'
+} >"$CORPUS/structure-heavy"
+{
+	echo '{ type: html, { type: head, content: { type: title, content: "Text" } }, { type: body, content: ['
+	for ((k = 0; k < ELEMENTS / 4; ++k)); do
+		echo "        { type: p, content: \"$k $TEXT\" },"
+	done
+	echo '{ type: p, content: "End" } ] } }'
+} >"$CORPUS/text-heavy"
+
+# The fastest compilation of the repetitions, in milliseconds.
+measure() {
+	local BEST=""
+	for ((r = 0; r < REPETITIONS; ++r)); do
+		local START
+		START=$(date +%s%N)
+		if ! build/Compiler "${@:2}" <"$CORPUS/$1" >/dev/null 2>&1; then
+			echo "failed"
+			return
+		fi
+		local ELAPSED=$((($(date +%s%N) - START) / 1000))
+		if [ -z "$BEST" ] || [ "$ELAPSED" -lt "$BEST" ]; then
+			BEST="$ELAPSED"
+		fi
+	done
+	echo "$((BEST / 1000)).$(printf "%03d" $((BEST % 1000))) ms"
+}
+
+# The value of a statistic of a compilation (see "LOG_STATISTICS"), or zero if it wasn't recorded.
+statistic() {
+	LOG_STATISTICS=true LOGGING_LEVEL=INFORMATION build/Compiler "${@:3}" <"$CORPUS/$2" 2>/dev/null \
+		| awk -v name="$1" '$0 ~ name " = " { value = $NF } END { print value == "" ? 0 : value }'
+}
+
+for page in structure-heavy text-heavy; do
+	echo "Compiling the $page page, of $(($(stat --format=%s "$CORPUS/$page") / 1024)) KiB (the fastest of $REPETITIONS)..."
+	echo ""
+	echo "    With Flex: $(measure $page)"
+	echo "    With the structural lexer: $(measure $page --structural-lexer) ($(statistic lexer.chunks $page --structural-lexer) chunks)"
+	echo "    With the parallel parser: $(measure $page --parallel-parser) ($(statistic parser.speculative-children $page --parallel-parser) elements parsed ahead)"
+	echo "    With the pipeline: $(measure $page --pipeline)"
+	echo ""
+done
+
+rm --force --recursive "$CORPUS"
+echo "All done."
@@ -0,0 +1,61 @@
+#! /bin/bash
+
+set -u
+
+BASE_PATH="$(dirname "$0")/../.."
+cd "$BASE_PATH"
+
+# Compiles a style-heavy page (every element has a style) with the compiler in "build", and shows how long
+# the generation takes (see "LOG_STATISTICS") with each way of writing the styles: as shared classes, inline
+# (each style serialized once, while parsing, and copied on every element), and inline but serialized on
+# every element (since the style uses a loop variable). The size of the page and the repetitions are the
+# arguments (by default, 20000 elements and 5 repetitions, of which the fastest is shown).
+ELEMENTS="${1:-20000}"
+REPETITIONS="${2:-5}"
+CORPUS="$(mktemp --directory)"
+
+# The contents are distinct, so each element is generated on its own (and not replayed).
+{
+	echo '{ type: html, { type: head, content: { type: title, content: "Styles" } }, { type: body, content: ['
+	for ((k = 0; k < ELEMENTS; ++k)); do
+		echo "{ type: p, style: { color: \"navy\", margin: 8, fontWeight: \"bold\" }, content: \"Paragraph $k\" },"
+	done
+	echo '{ type: p, content: "End" } ] } }'
+} >"$CORPUS/serialized-once"
+{
+	echo '{ type: html, { type: head, content: { type: title, content: "Styles" } }, { type: body, content: ['
+	echo -n 'for color : ['
+	for ((k = 0; k < ELEMENTS; ++k)); do
+		echo -n '"navy", '
+	done
+	echo '"navy" ] then { type: p, style: { color: color, margin: 8, fontWeight: "bold" }, content: "Paragraph" }'
+	echo '] } }'
+} >"$CORPUS/serialized-each-time"
+
+# The fastest generation of the repetitions, in milliseconds.
+measure() {
+	local BEST=""
+	for ((r = 0; r < REPETITIONS; ++r)); do
+		local ELAPSED
+		ELAPSED=$(LOG_STATISTICS=true LOGGING_LEVEL=INFORMATION build/Compiler "${@:2}" <"$CORPUS/$1" 2>/dev/null \
+			| awk '/generator.time = / { printf "%d", $NF * 1000000 }')
+		if [ -z "$ELAPSED" ]; then
+			echo "failed"
+			return
+		fi
+		if [ -z "$BEST" ] || [ "$ELAPSED" -lt "$BEST" ]; then
+			BEST="$ELAPSED"
+		fi
+	done
+	echo "$((BEST / 1000)).$(printf "%03d" $((BEST % 1000))) ms"
+}
+
+echo "Generating the styles of $ELEMENTS elements (the fastest of $REPETITIONS)..."
+echo ""
+echo "    As shared classes: $(measure serialized-once)"
+echo "    Inline, serialized once: $(measure serialized-once --inline-styles)"
+echo "    Inline, serialized on each element: $(measure serialized-each-time --inline-styles)"
+echo ""
+
+rm --force --recursive "$CORPUS"
+echo "All done."
@@ -0,0 +1,58 @@
+#! /bin/bash
+
+set -u
+
+BASE_PATH="$(dirname "$0")/../.."
+cd "$BASE_PATH"
+
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+OFF='\033[0m'
+STATUS=0
+
+# Builds the compiler with the hand-written parser next to the usual one (in "build"), and compiles every
+# source of the tests (or of the directories given) with both: the outputs, the logs and the status must be
+# the same. The tests are calculator programs and pages (with loops, conditionals, declarations, partials,
+# expressions, and syntax errors, whose locations must match too). The time each one takes is summed, as a
+# rough benchmark.
+cmake -S . -B build-descent -DDESCENT_PARSER=ON >/dev/null && cmake --build build-descent >/dev/null || exit 1
+
+DIRECTORIES=("$@")
+if [ "${#DIRECTORIES[@]}" == "0" ]; then
+	DIRECTORIES=("src/test/c/accept" "src/test/c/reject")
+fi
+
+BISON_TIME=0
+DESCENT_TIME=0
+OUTPUT="$(mktemp --directory)"
+
+echo "Both parsers should agree..."
+echo ""
+
+for directory in "${DIRECTORIES[@]}"; do
+	for test in $(ls "$directory"); do
+		START=$(date +%s%N)
+		build/Compiler --partials src/test/c/partials <"$directory/$test" >"$OUTPUT/bison" 2>&1
+		BISON_RESULT="$?"
+		MIDDLE=$(date +%s%N)
+		build-descent/Compiler --partials src/test/c/partials <"$directory/$test" >"$OUTPUT/descent" 2>&1
+		DESCENT_RESULT="$?"
+		END=$(date +%s%N)
+		BISON_TIME=$((BISON_TIME + MIDDLE - START))
+		DESCENT_TIME=$((DESCENT_TIME + END - MIDDLE))
+		if [ "$BISON_RESULT" == "$DESCENT_RESULT" ] && cmp --silent "$OUTPUT/bison" "$OUTPUT/descent"; then
+			echo -e "    $directory/$test, ${GREEN}and they do${OFF} (status $BISON_RESULT)"
+		else
+			STATUS=1
+			echo -e "    $directory/$test, ${RED}but they differ${OFF} (status $BISON_RESULT and $DESCENT_RESULT)"
+		fi
+	done
+done
+echo ""
+
+rm --force --recursive "$OUTPUT"
+echo "Bison took $((BISON_TIME / 1000000)) ms, and the descent parser $((DESCENT_TIME / 1000000)) ms."
+echo ""
+
+echo "All done."
+exit $STATUS
@@ -14,7 +14,7 @@ echo "Compiler should accept..."
 echo ""
 
 for test in $(ls src/test/c/accept/); do
-	cat "src/test/c/accept/$test" | build/Compiler >/dev/null 2>&1
+	cat "src/test/c/accept/$test" | build/Compiler --partials src/test/c/partials >/dev/null 2>&1
 	RESULT="$?"
 	if [ "$RESULT" == "0" ]; then
 		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
@@ -29,7 +29,7 @@ echo "Compiler should reject..."
 echo ""
 
 for test in $(ls src/test/c/reject/); do
-	cat "src/test/c/reject/$test" | build/Compiler >/dev/null 2>&1
+	cat "src/test/c/reject/$test" | build/Compiler --partials src/test/c/partials >/dev/null 2>&1
 	RESULT="$?"
 	if [ "$RESULT" != "0" ]; then
 		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
@@ -40,5 +40,118 @@ for test in $(ls src/test/c/reject/); do
 done
 echo ""
 
+# The same sources, only validated (see "--check"): it must accept and reject
+# exactly what a full compilation does.
+echo "Compiler should accept, with --check..."
+echo ""
+
+for test in $(ls src/test/c/accept/); do
+	cat "src/test/c/accept/$test" | build/Compiler --check --partials src/test/c/partials >/dev/null 2>&1
+	RESULT="$?"
+	if [ "$RESULT" == "0" ]; then
+		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it rejects${OFF} (status $RESULT)"
+	fi
+done
+echo ""
+
+echo "Compiler should reject, with --check..."
+echo ""
+
+for test in $(ls src/test/c/reject/); do
+	cat "src/test/c/reject/$test" | build/Compiler --check --partials src/test/c/partials >/dev/null 2>&1
+	RESULT="$?"
+	if [ "$RESULT" != "0" ]; then
+		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it accepts${OFF} (status $RESULT)"
+	fi
+done
+echo ""
+
+# The sections of this page share a style (in any order), so it's declared
+# once, as a single class.
+echo "Compiler should share the style of repeated sections..."
+echo ""
+
+test="09-shared-section-styles"
+OUTPUT="$(cat "src/test/c/accept/$test" | build/Compiler 2>/dev/null)"
+RULES="$(echo "$OUTPUT" | grep --count '^ *\.s[0-9]*{')"
+CLASSES="$(echo "$OUTPUT" | grep --count 'class="s0"')"
+RULE="$(echo "$OUTPUT" | grep --only-matching '\.s0{.*}')"
+if [ "$RULES" == "1" ] && [ "$CLASSES" == "3" ] && [ "$RULE" == ".s0{color:navy;margin:8px}" ]; then
+	echo -e "    $test, ${GREEN}and it does${OFF} ($RULES rule, $CLASSES elements)"
+else
+	STATUS=1
+	echo -e "    $test, ${RED}but it doesn't${OFF} ($RULES rules, $CLASSES elements, \"$RULE\")"
+fi
+echo ""
+
+echo "Compiler should write the same style inline on each section, with --inline-styles..."
+echo ""
+
+test="09-shared-section-styles"
+OUTPUT="$(cat "src/test/c/accept/$test" | build/Compiler --inline-styles 2>/dev/null)"
+ATTRIBUTES="$(echo "$OUTPUT" | grep --count '<div style="color:navy;margin:8px">')"
+if [ "$ATTRIBUTES" == "3" ] && [ "$(echo "$OUTPUT" | grep --count '<style>')" == "0" ]; then
+	echo -e "    $test, ${GREEN}and it does${OFF} ($ATTRIBUTES elements)"
+else
+	STATUS=1
+	echo -e "    $test, ${RED}but it doesn't${OFF} ($ATTRIBUTES elements)"
+fi
+echo ""
+
+# While watching, saving this page again (with a paragraph edited) reparses
+# only that paragraph, and rewrites the output.
+echo "Compiler should reparse only what changed, when watching..."
+echo ""
+
+test="10-watched-page"
+WATCHED="$(mktemp --directory)"
+mkdir "$WATCHED/source" "$WATCHED/output"
+cp "src/test/c/accept/$test" "$WATCHED/source/$test"
+LOG_STATISTICS=true LOGGING_LEVEL=INFORMATION timeout --signal=INT 3 build/Compiler --watch "$WATCHED/source" \
+	--output-dir "$WATCHED/output" >"$WATCHED/log" 2>&1 &
+sleep 1
+sed 's/Before the edit/After the edit/' "src/test/c/accept/$test" >"$WATCHED/source/$test"
+wait
+EDITED="$(grep --count '<p>After the edit</p>' "$WATCHED/output/$test.html" 2>/dev/null)"
+REPARSED="$(awk '/incremental.reparsed-bytes = / { print $NF }' "$WATCHED/log")"
+if [ "$EDITED" == "1" ] && [ -n "$REPARSED" ] && [ "$REPARSED" -lt 64 ]; then
+	echo -e "    $test, ${GREEN}and it does${OFF} ($REPARSED bytes reparsed)"
+else
+	STATUS=1
+	echo -e "    $test, ${RED}but it doesn't${OFF} (${REPARSED:-no} bytes reparsed)"
+fi
+rm --force --recursive "$WATCHED"
+echo ""
+
+# And only the output of that paragraph is generated again, and patched into
+# the output file, that ends up like the one of a full compilation.
+echo "Compiler should patch only the output of what changed, when watching..."
+echo ""
+
+WATCHED="$(mktemp --directory)"
+mkdir "$WATCHED/source" "$WATCHED/output"
+cp "src/test/c/accept/$test" "$WATCHED/source/$test"
+LOG_STATISTICS=true LOGGING_LEVEL=INFORMATION timeout --signal=INT 3 build/Compiler --watch "$WATCHED/source" \
+	--output-dir "$WATCHED/output" >"$WATCHED/log" 2>&1 &
+sleep 1
+sed 's/Before the edit/After the edit/' "src/test/c/accept/$test" >"$WATCHED/source/$test"
+wait
+cat "$WATCHED/source/$test" | build/Compiler >"$WATCHED/expected" 2>/dev/null
+PATCHES="$(awk '/file-patcher.patches = / { print $NF }' "$WATCHED/log")"
+if [ "$PATCHES" == "1" ] && cmp --quiet "$WATCHED/expected" "$WATCHED/output/$test.html"; then
+	echo -e "    $test, ${GREEN}and it does${OFF} ($PATCHES patch)"
+else
+	STATUS=1
+	echo -e "    $test, ${RED}but it doesn't${OFF} (${PATCHES:-no} patches)"
+fi
+rm --force --recursive "$WATCHED"
+echo ""
+
 echo "All done."
 exit $STATUS
@@ -9,7 +9,7 @@
 
 @set STATUS=0
 @for /f %%f in ('dir /b !BASE_PATH!\src\test\c\accept') do @(
-	@type !BASE_PATH!\src\test\c\accept\%%f | !BASE_PATH!\build\Debug\Compiler.exe >nul 2>&1
+	@type !BASE_PATH!\src\test\c\accept\%%f | !BASE_PATH!\build\Debug\Compiler.exe --partials !BASE_PATH!\src\test\c\partials >nul 2>&1
 	@set RESULT=!ERRORLEVEL!
 	if !RESULT! equ 0 (
 		@echo     "%%f", [92mand it does[0m ^(status !RESULT!^)
@@ -24,7 +24,7 @@
 @echo:
 
 @for /f %%f in ('dir /b !BASE_PATH!\src\test\c\reject') do @(
-	@type !BASE_PATH!\src\test\c\reject\%%f | !BASE_PATH!\build\Debug\Compiler.exe >nul 2>&1
+	@type !BASE_PATH!\src\test\c\reject\%%f | !BASE_PATH!\build\Debug\Compiler.exe --partials !BASE_PATH!\src\test\c\partials >nul 2>&1
 	@set RESULT=!ERRORLEVEL!
 	if !RESULT! neq 0 (
 		@echo     "%%f", [92mand it does[0m ^(status !RESULT!^)
@@ -34,6 +34,76 @@
 	)
 )
 
+@echo:
+
+@echo Compiler should accept, with --check...
+@echo:
+
+@for /f %%f in ('dir /b !BASE_PATH!\src\test\c\accept') do @(
+	@type !BASE_PATH!\src\test\c\accept\%%f | !BASE_PATH!\build\Debug\Compiler.exe --check --partials !BASE_PATH!\src\test\c\partials >nul 2>&1
+	@set RESULT=!ERRORLEVEL!
+	if !RESULT! equ 0 (
+		@echo     "%%f", [92mand it does[0m ^(status !RESULT!^)
+	) else (
+		@set STATUS=1
+		@echo     "%%f", [91mbut it rejects[0m ^(status !RESULT!^)
+	)
+)
+@echo:
+
+@echo Compiler should reject, with --check...
+@echo:
+
+@for /f %%f in ('dir /b !BASE_PATH!\src\test\c\reject') do @(
+	@type !BASE_PATH!\src\test\c\reject\%%f | !BASE_PATH!\build\Debug\Compiler.exe --check --partials !BASE_PATH!\src\test\c\partials >nul 2>&1
+	@set RESULT=!ERRORLEVEL!
+	if !RESULT! neq 0 (
+		@echo     "%%f", [92mand it does[0m ^(status !RESULT!^)
+	) else (
+		@set STATUS=1
+		@echo     "%%f", [91mbut it accepts[0m ^(status !RESULT!^)
+	)
+)
+
+@echo:
+
+@echo Compiler should share the style of repeated sections...
+@echo:
+
+@set TEST=09-shared-section-styles
+@type !BASE_PATH!\src\test\c\accept\!TEST! | !BASE_PATH!\build\Debug\Compiler.exe 2>nul >"%TEMP%\!TEST!.html"
+@for /f %%n in ('findstr /R /C:"^ *\.s[0-9]*{" "%TEMP%\!TEST!.html" ^| find /c /v ""') do @set RULES=%%n
+@for /f %%n in ('findstr /C:"class=\"s0\"" "%TEMP%\!TEST!.html" ^| find /c /v ""') do @set CLASSES=%%n
+@for /f %%n in ('findstr /C:".s0{color:navy;margin:8px}" "%TEMP%\!TEST!.html" ^| find /c /v ""') do @set CANONICAL=%%n
+@del "%TEMP%\!TEST!.html"
+@if "!RULES!" == "1" if "!CLASSES!" == "3" if "!CANONICAL!" == "1" (
+	@echo     "!TEST!", [92mand it does[0m ^(!RULES! rule, !CLASSES! elements^)
+	@goto :shared
+)
+@set STATUS=1
+@echo     "!TEST!", [91mbut it doesn't[0m ^(!RULES! rules, !CLASSES! elements^)
+:shared
+
+@echo:
+
+@echo Compiler should write the same style inline on each section, with --inline-styles...
+@echo:
+
+@set TEST=09-shared-section-styles
+@type !BASE_PATH!\src\test\c\accept\!TEST! | !BASE_PATH!\build\Debug\Compiler.exe --inline-styles 2>nul >"%TEMP%\!TEST!.html"
+@for /f %%n in ('findstr /C:"style=\"color:navy;margin:8px\"" "%TEMP%\!TEST!.html" ^| find /c /v ""') do @set ATTRIBUTES=%%n
+@del "%TEMP%\!TEST!.html"
+@if "!ATTRIBUTES!" == "3" (
+	@echo     "!TEST!", [92mand it does[0m ^(!ATTRIBUTES! elements^)
+	@goto :inline
+)
+@set STATUS=1
+@echo     "!TEST!", [91mbut it doesn't[0m ^(!ATTRIBUTES! elements^)
+:inline
+
+@REM The incremental reparse and the patched outputs of a watch (see
+@REM "test.sh") aren't tested here, since "--watch" relies on inotify.
+
 @exit /B %STATUS%
 
 @ENDLOCAL
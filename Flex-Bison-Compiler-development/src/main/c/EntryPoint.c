@@ -1,13 +1,795 @@
 #include "backend/code-generation/Generator.h"
+#include "backend/code-generation/PartialCompiler.h"
+#include "backend/code-generation/StyleSheet.h"
 #include "backend/domain-specific/Calculator.h"
+#include "frontend/lexical-analysis/DependencyScanner.h"
 #include "frontend/lexical-analysis/FlexActions.h"
+#include "frontend/lexical-analysis/StructuralLexer.h"
 #include "frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "frontend/syntactic-analysis/AbstractSyntaxTreeCache.h"
 #include "frontend/syntactic-analysis/BisonActions.h"
+#include "frontend/syntactic-analysis/DescentParser.h"
+#include "frontend/syntactic-analysis/ElementSchema.h"
+#include "frontend/syntactic-analysis/HashConsing.h"
+#include "frontend/syntactic-analysis/IncrementalParser.h"
 #include "frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "shared/Buffer.h"
 #include "shared/CompilerState.h"
+#include "shared/DependencyGraph.h"
 #include "shared/Environment.h"
+#include "shared/FilePatcher.h"
+#include "shared/FileWatcher.h"
+#include "shared/Hash.h"
 #include "shared/Logger.h"
+#include "shared/ResultCache.h"
+#include "shared/RingBuffer.h"
+#include "shared/SharedResultCache.h"
+#include "shared/Statistics.h"
 #include "shared/String.h"
+#include "shared/SymbolTable.h"
+
+/* MODULE INTERNAL STATE */
+
+#define OUTPUT_EXTENSION ".html"
+#define PARTIAL_PREFIX '_'
+#define SITE_GRAPH_NAME ".site-graph"
+
+// The elements of the body are published to the generator in small batches,
+// since each one is worth a lot more work than a token.
+#define ELEMENT_RING_CAPACITY 1024
+#define ELEMENT_BATCH_SIZE 8
+
+// How much of a streamed source is read at once (at most).
+#define STREAM_CHUNK_SIZE (64 * 1024)
+
+/**
+ * What a watch session remembers of a source between compilations: its tree
+ * is kept in a document, so a save only reparses what changed, and its last
+ * output is kept with its output map (NULL if the output file may not match
+ * it), so only the output of what changed is generated and patched.
+ */
+typedef struct {
+	char * name;
+	uint64_t sourceHash;
+	uint64_t outputHash;
+	IncrementalDocument * document;
+	Buffer * output;
+	OutputSpan * outputMap;
+} WatchedSource;
+
+/**
+ * The state kept warm during a watch session.
+ */
+typedef struct {
+	Logger * logger;
+	const CompilerConfiguration * configuration;
+	Buffer * source;
+	WatchedSource * sources;
+	size_t count;
+	size_t capacity;
+} WatchSession;
+
+/**
+ * The pages of a site build (the node of a page in the dependency graph is
+ * its index).
+ */
+typedef struct {
+	Logger * logger;
+	const CompilerConfiguration * configuration;
+	DependencyGraph * graph;
+	char ** names;
+	Buffer ** sources;
+	unsigned int count;
+	unsigned int capacity;
+	unsigned int current;
+} Site;
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _buildPage(const unsigned int node, const char * name, void * context);
+static CompilationStatus _buildSite(Logger * logger, const CompilerConfiguration * configuration);
+static void _collectPage(const char * path, const FileEvent event, void * context);
+static int _compareNames(const void * left, const void * right);
+static CompilationStatus _compile(Logger * logger, CompilerState * compilerState);
+static CompilationStatus _compileDocument(Logger * logger, CompilerState * compilerState, WatchedSource * watchedSource);
+static boolean _editDocument(IncrementalDocument * document, const Buffer * source);
+static void * _generateAhead(void * elements);
+static boolean _isOutput(const char * name);
+static boolean _isPartial(const char * name);
+static void _linkPage(const DependencyKind kind, const char * target, void * context);
+static void _onFileEvent(const char * path, const FileEvent event, void * context);
+static boolean _parseArguments(Logger * logger, const int count, const char ** arguments, CompilerConfiguration * configuration);
+static SyntacticAnalysisStatus _parsePipelined(CompilerState * compilerState);
+static SyntacticAnalysisStatus _parseStream(CompilerState * compilerState);
+static CompilationStatus _watch(Logger * logger, const CompilerConfiguration * configuration);
+static WatchedSource * _watchedSource(WatchSession * session, const char * name);
+static boolean _writeFile(const char * path, const char * bytes, const size_t length);
+
+/**
+ * Compiles a page of a site into its output file (called in a worker, if the
+ * site is built with more than one job). Partials are only included by pages,
+ * so they have no output of their own.
+ */
+static boolean _buildPage(const unsigned int node, const char * name, void * context) {
+	Site * site = context;
+	if (_isPartial(name)) {
+		return true;
+	}
+	const double start = monotonicTime();
+	Buffer * output = createBuffer(64 * 1024);
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.succeed = false,
+		.source = site->sources[node]->bytes,
+		.sourceLength = site->sources[node]->length,
+		.output = output,
+		.configuration = *site->configuration,
+		.symbolTable = NULL,
+		.loopDepth = 0,
+		.arrayDepth = 0,
+		.elements = NULL,
+		.includedPartials = 0,
+		.value = 0
+	};
+	boolean succeed = _compile(site->logger, &compilerState) == SUCCEED;
+	char * outputPath = concatenate(4, site->configuration->outputDirectory, "/", name, OUTPUT_EXTENSION);
+	if (!succeed) {
+		logError(site->logger, "Cannot compile the page \"%s\".", name);
+	}
+	else if (_writeFile(outputPath, output->bytes, output->length)) {
+		logInformation(site->logger, "Compiled \"%s\" into \"%s\" in %.3f ms.", name, outputPath, 1000 * (monotonicTime() - start));
+	}
+	else {
+		logError(site->logger, "Cannot write the output: %s", outputPath);
+		succeed = false;
+	}
+	free(outputPath);
+	destroyBuffer(output);
+	return succeed;
+}
+
+/**
+ * Builds the pages of a site that changed since the last build, and every
+ * page that depends on them (through "ref" links). The dependency graph of
+ * each build is stored next to the outputs, and compared with the previous
+ * one to find the affected pages.
+ */
+static CompilationStatus _buildSite(Logger * logger, const CompilerConfiguration * configuration) {
+	Site site = {
+		.logger = logger,
+		.configuration = configuration,
+		.graph = createDependencyGraph(),
+		.names = NULL,
+		.sources = NULL,
+		.count = 0,
+		.capacity = 0,
+		.current = 0
+	};
+	scanDirectory(configuration->siteDirectory, _collectPage, &site);
+	qsort(site.names, site.count, sizeof(char *), _compareNames);
+	for (unsigned int k = 0; k < site.count; ++k) {
+		char * path = concatenate(3, configuration->siteDirectory, "/", site.names[k]);
+		FILE * file = fopen(path, "rb");
+		site.sources[k] = createBuffer(16 * 1024);
+		if (file != NULL) {
+			appendStreamToBuffer(site.sources[k], file);
+			fclose(file);
+		}
+		free(path);
+		// A zero hash is reserved for the pages that must be built.
+		const uint64_t hash = hashBytes(site.sources[k]->bytes, site.sources[k]->length, 0);
+		addGraphNode(site.graph, site.names[k], hash == 0 ? 1 : hash);
+	}
+	for (site.current = 0; site.current < site.count; ++site.current) {
+		scanDependencies(site.sources[site.current]->bytes, site.sources[site.current]->length, _linkPage, &site);
+	}
+	char * graphPath = concatenate(3, configuration->outputDirectory, "/", SITE_GRAPH_NAME);
+	DependencyGraph * previousGraph = loadDependencyGraph(graphPath);
+	boolean * marked = calloc(site.count + 1, sizeof(boolean));
+	boolean * failed = calloc(site.count + 1, sizeof(boolean));
+	for (unsigned int k = 0; k < site.count; ++k) {
+		char * outputPath = concatenate(4, configuration->outputDirectory, "/", site.names[k], OUTPUT_EXTENSION);
+		marked[k] = !_isPartial(site.names[k]) && access(outputPath, F_OK) != 0;
+		free(outputPath);
+	}
+	for (unsigned int k = 0; previousGraph != NULL && k < graphNodeCount(previousGraph); ++k) {
+		const char * name = graphNodeName(previousGraph, k);
+		if (findGraphNode(site.graph, name) < 0) {
+			char * outputPath = concatenate(4, configuration->outputDirectory, "/", name, OUTPUT_EXTENSION);
+			if (remove(outputPath) == 0) {
+				logInformation(logger, "Removed \"%s\".", outputPath);
+			}
+			free(outputPath);
+		}
+	}
+	const double start = monotonicTime();
+	const unsigned int affected = markAffectedGraphNodes(site.graph, previousGraph, marked);
+	const unsigned int built = buildDependencyGraph(site.graph, marked, configuration->jobs, _buildPage, &site, failed);
+	for (unsigned int k = 0; k < site.count; ++k) {
+		if (failed[k]) {
+			setGraphNodeHash(site.graph, k, 0);
+		}
+	}
+	const boolean stored = storeDependencyGraph(site.graph, graphPath);
+	addToStatistic("site.pages", site.count);
+	logInformation(logger, "Built %u of %u pages (%u affected) in %.3f ms.", built, site.count, affected, 1000 * (monotonicTime() - start));
+	free(failed);
+	free(marked);
+	destroyDependencyGraph(previousGraph);
+	free(graphPath);
+	for (unsigned int k = 0; k < site.count; ++k) {
+		destroyBuffer(site.sources[k]);
+		free(site.names[k]);
+	}
+	free(site.sources);
+	free(site.names);
+	destroyDependencyGraph(site.graph);
+	return built == affected && stored ? SUCCEED : FAILED;
+}
+
+/**
+ * Collects the name of a page of a site (outputs are not pages).
+ */
+static void _collectPage(const char * path, const FileEvent event, void * context) {
+	(void) event;
+	Site * site = context;
+	const char * separator = strrchr(path, '/');
+	const char * name = separator == NULL ? path : separator + 1;
+	if (_isOutput(name)) {
+		return;
+	}
+	if (site->count == site->capacity) {
+		site->capacity = site->capacity == 0 ? 64 : 2 * site->capacity;
+		site->names = realloc(site->names, site->capacity * sizeof(char *));
+		site->sources = realloc(site->sources, site->capacity * sizeof(Buffer *));
+	}
+	site->names[site->count++] = concatenate(1, name);
+}
+
+/**
+ * Orders the names of the pages, so the graph doesn't depend on the order of
+ * the directory.
+ */
+static int _compareNames(const void * left, const void * right) {
+	return strcmp(*(char * const *) left, *(char * const *) right);
+}
+
+/**
+ * Compiles the source of the compiler state into its output buffer. Whole
+ * results and ASTs are looked up in the caches first (if enabled), and
+ * stored there after a successful compilation.
+ */
+static CompilationStatus _compile(Logger * logger, CompilerState * compilerState) {
+	const CompilerConfiguration * configuration = &compilerState->configuration;
+	// A streamed source is not known until it's parsed, so it can't be cached
+	// (and a check generates nothing to cache).
+	const boolean isCacheable = !configuration->stream && !configuration->check;
+	const char * astCacheDirectory = isCacheable ? getStringOrDefault("AST_CACHE_DIRECTORY", configuration->cacheDirectory) : NULL;
+	const size_t initialLength = compilerState->output->length;
+	const uint64_t resultKey = isCacheable ? resultCacheKey(compilerState->source, compilerState->sourceLength,
+		configuration->inlineStyles ? "--inline-styles" : "") : 0;
+	if (isCacheable && configuration->useSharedCache && loadSharedResult(resultKey, compilerState->output)) {
+		logDebugging(logger, "Using the shared result (the compilation is skipped).");
+		return SUCCEED;
+	}
+	if (isCacheable && configuration->cacheDirectory != NULL
+			&& loadCachedResult(configuration->cacheDirectory, resultKey, compilerState->output)) {
+		logDebugging(logger, "Using the cached result (the compilation is skipped).");
+		if (configuration->useSharedCache) {
+			storeSharedResult(resultKey, compilerState->output->bytes + initialLength, compilerState->output->length - initialLength);
+		}
+		return SUCCEED;
+	}
+	const uint64_t sourceHash = isCacheable ? hashBytes(compilerState->source, compilerState->sourceLength, 0) : 0;
+	SyntacticAnalysisStatus syntacticAnalysisStatus = REJECT;
+	Program * cachedProgram = NULL;
+	if (astCacheDirectory != NULL) {
+		cachedProgram = loadCachedAbstractSyntaxTree(astCacheDirectory, sourceHash);
+	}
+	if (cachedProgram != NULL) {
+		logDebugging(logger, "Using the cached AST (the frontend is skipped).");
+		compilerState->abstractSyntaxtTree = cachedProgram;
+		compilerState->succeed = true;
+		syntacticAnalysisStatus = ACCEPT;
+	}
+	else {
+		syntacticAnalysisStatus = configuration->pipeline && !configuration->check ? _parsePipelined(compilerState)
+			: configuration->stream ? _parseStream(compilerState) : parse(compilerState);
+		if (syntacticAnalysisStatus == ACCEPT && astCacheDirectory != NULL
+				&& storeCachedAbstractSyntaxTree(astCacheDirectory, sourceHash, compilerState->abstractSyntaxtTree)) {
+			// The images are bounded as the results (even in a directory of their own).
+			evictCachedArtifacts(astCacheDirectory, configuration->maximumCacheSize);
+		}
+	}
+	CompilationStatus compilationStatus = SUCCEED;
+	Program * program = compilerState->abstractSyntaxtTree;
+	if (syntacticAnalysisStatus == ACCEPT && configuration->check) {
+		checkProgram(compilerState);
+		if (!compilerState->succeed) {
+			logError(logger, "The generation phase rejects the input program.");
+			compilationStatus = FAILED;
+		}
+		else {
+			logDebugging(logger, "The input program is valid (the generation is skipped).");
+		}
+	}
+	else if (syntacticAnalysisStatus == ACCEPT) {
+		// ----------------------------------------------------------------------------------------
+		// Beginning of the Backend... ------------------------------------------------------------
+		logDebugging(logger, "Generating HTML output...");
+		generate(compilerState);
+		const char * result = compilerState->output->bytes + initialLength;
+		const size_t resultLength = compilerState->output->length - initialLength;
+		if (!compilerState->succeed) {
+			logError(logger, "The generation phase rejects the input program.");
+			compilationStatus = FAILED;
+		}
+		else if (isCacheable && compilerState->includedPartials == 0) {
+			// The key covers the source alone, so outputs with partials are not cached.
+			if (configuration->useSharedCache) {
+				storeSharedResult(resultKey, result, resultLength);
+			}
+			if (configuration->cacheDirectory != NULL) {
+				storeCachedResult(configuration->cacheDirectory, resultKey, result, resultLength, configuration->maximumCacheSize);
+			}
+		}
+		// ...end of the Backend. -----------------------------------------------------------------
+		// ----------------------------------------------------------------------------------------
+	}
+	else {
+		logError(logger, "The syntactic-analysis phase rejects the input program.");
+		compilationStatus = FAILED;
+	}
+	logDebugging(logger, "Releasing AST resources...");
+	releasePreparedElements();
+	if (cachedProgram != NULL) {
+		releaseCachedAbstractSyntaxTree(cachedProgram);
+	}
+	else {
+		releaseProgram(program);
+	}
+	compilerState->abstractSyntaxtTree = NULL;
+	return compilationStatus;
+}
+
+/**
+ * Compiles the tree of the document of a watched source (see
+ * "IncrementalParser") into the output buffer of the compiler state, and
+ * records its output map. The frontend already ran (when the document was
+ * edited), so the caches are not used.
+ */
+static CompilationStatus _compileDocument(Logger * logger, CompilerState * compilerState, WatchedSource * watchedSource) {
+	releaseOutputMap(watchedSource->outputMap);
+	watchedSource->outputMap = NULL;
+	Program * program = createIncrementalProgram(watchedSource->document, compilerState);
+	if (program == NULL) {
+		logError(logger, "The syntactic-analysis phase rejects the input program.");
+		return FAILED;
+	}
+	compilerState->abstractSyntaxtTree = program;
+	compilerState->succeed = true;
+	OutputSpan * outputMap = generateWithOutputMap(compilerState);
+	CompilationStatus compilationStatus = SUCCEED;
+	if (compilerState->succeed) {
+		watchedSource->outputMap = outputMap;
+	}
+	else {
+		logError(logger, "The generation phase rejects the input program.");
+		releaseOutputMap(outputMap);
+		compilationStatus = FAILED;
+	}
+	releaseProgram(program);
+	compilerState->abstractSyntaxtTree = NULL;
+	return compilationStatus;
+}
+
+/**
+ * Applies a saved source to its document as a single edit: the bytes between
+ * the prefix and the suffix that both versions have in common. Returns whether
+ * the document accepted an edit (if nothing changed, it's kept as is).
+ */
+static boolean _editDocument(IncrementalDocument * document, const Buffer * source) {
+	const Buffer * previous = incrementalDocumentSource(document);
+	const size_t shortestLength = previous->length < source->length ? previous->length : source->length;
+	size_t prefixLength = 0;
+	while (prefixLength < shortestLength && previous->bytes[prefixLength] == source->bytes[prefixLength]) {
+		++prefixLength;
+	}
+	size_t suffixLength = 0;
+	while (suffixLength < shortestLength - prefixLength
+			&& previous->bytes[previous->length - suffixLength - 1] == source->bytes[source->length - suffixLength - 1]) {
+		++suffixLength;
+	}
+	if (prefixLength == previous->length && prefixLength == source->length) {
+		return false;
+	}
+	return editIncrementalDocument(document, prefixLength, previous->length - prefixLength - suffixLength,
+		source->bytes + prefixLength, source->length - prefixLength - suffixLength) == ACCEPT;
+}
+
+/**
+ * Generates ahead the elements of the body that the parser pushes into the
+ * ring, on a thread of its own, until the parse ends.
+ */
+static void * _generateAhead(void * elements) {
+	Value * element = NULL;
+	while (popFromRingBuffer(elements, &element)) {
+		prepareElement(element);
+	}
+	return NULL;
+}
+
+/**
+ * Whether the name belongs to an output (and not to a source).
+ */
+static boolean _isOutput(const char * name) {
+	const size_t nameLength = strlen(name);
+	const size_t extensionLength = strlen(OUTPUT_EXTENSION);
+	return extensionLength <= nameLength && strcmp(name + nameLength - extensionLength, OUTPUT_EXTENSION) == 0;
+}
+
+/**
+ * Whether the name belongs to a partial (that is included, and not compiled
+ * alone).
+ */
+static boolean _isPartial(const char * name) {
+	return name[0] == PARTIAL_PREFIX;
+}
+
+/**
+ * Records a "ref" link or an "include" of the current page of a site as a
+ * dependency on the linked page or the included partial (by name, with or
+ * without the extension of the outputs). Links to the page itself, or
+ * outside of the site, are ignored.
+ */
+static void _linkPage(const DependencyKind kind, const char * target, void * context) {
+	Site * site = context;
+	char * name = concatenate(1, target);
+	if (_isOutput(name)) {
+		name[strlen(name) - strlen(OUTPUT_EXTENSION)] = '\0';
+	}
+	const int node = findGraphNode(site->graph, name);
+	if (node < 0) {
+		logWarning(site->logger, "The page \"%s\" %s \"%s\", which is not in the site.", site->names[site->current],
+			kind == PAGE_REFERENCE ? "links to" : "includes", target);
+	}
+	else if ((unsigned int) node != site->current) {
+		addGraphDependency(site->graph, site->current, node);
+	}
+	free(name);
+}
+
+/**
+ * Recompiles a changed source of a watch session (or removes the output of a
+ * removed one). Only the part of the tree that the save changed is parsed
+ * again (see "IncrementalParser"), and if possible, only its output is
+ * generated again, and patched into the output file (see "FilePatcher").
+ * Otherwise, the output file is rewritten, but only if its content changed.
+ */
+static void _onFileEvent(const char * path, const FileEvent event, void * context) {
+	WatchSession * session = context;
+	const char * separator = strrchr(path, '/');
+	const char * name = separator == NULL ? path : separator + 1;
+	if (_isOutput(name)) {
+		return;
+	}
+	if (_isPartial(name)) {
+		// Any page may include it, so every one is compiled again (but only the
+		// outputs that change are written).
+		for (size_t k = 0; k < session->count; ++k) {
+			char * sourcePath = concatenate(3, session->configuration->watchDirectory, "/", session->sources[k].name);
+			session->sources[k].sourceHash = 0;
+			_onFileEvent(sourcePath, FILE_CHANGED, session);
+			free(sourcePath);
+		}
+		return;
+	}
+	const double start = monotonicTime();
+	WatchedSource * watchedSource = _watchedSource(session, name);
+	char * outputPath = concatenate(4, session->configuration->outputDirectory, "/", name, OUTPUT_EXTENSION);
+	if (event == FILE_REMOVED) {
+		if (remove(outputPath) == 0) {
+			logInformation(session->logger, "Removed \"%s\".", outputPath);
+		}
+		watchedSource->sourceHash = 0;
+		watchedSource->outputHash = 0;
+		destroyIncrementalDocument(watchedSource->document);
+		watchedSource->document = NULL;
+		releaseOutputMap(watchedSource->outputMap);
+		watchedSource->outputMap = NULL;
+		free(outputPath);
+		return;
+	}
+	FILE * file = fopen(path, "rb");
+	if (file == NULL) {
+		free(outputPath);
+		return;
+	}
+	clearBuffer(session->source);
+	appendStreamToBuffer(session->source, file);
+	fclose(file);
+	const uint64_t sourceHash = hashBytes(session->source->bytes, session->source->length, 0);
+	if (sourceHash == watchedSource->sourceHash) {
+		logDebugging(session->logger, "The source \"%s\" did not change.", path);
+		free(outputPath);
+		return;
+	}
+	boolean isEdited = false;
+	if (watchedSource->document == NULL) {
+		watchedSource->document = createIncrementalDocument(session->source->bytes, session->source->length);
+	}
+	else {
+		isEdited = _editDocument(watchedSource->document, session->source);
+	}
+	// The output map is only kept while the output file matches the output.
+	const IncrementalChange change = lastIncrementalChange(watchedSource->document);
+	OutputPatch patch;
+	const boolean isPatched = isEdited && change.isIncremental && watchedSource->outputMap != NULL
+		&& regenerateOutputSpan(watchedSource->outputMap, change.previousValue, change.value, watchedSource->output, &patch);
+	if (!isPatched) {
+		clearBuffer(watchedSource->output);
+		CompilerState compilerState = {
+			.abstractSyntaxtTree = NULL,
+			.succeed = false,
+			.source = session->source->bytes,
+			.sourceLength = session->source->length,
+			.output = watchedSource->output,
+			.configuration = *session->configuration,
+			.symbolTable = NULL,
+			.loopDepth = 0,
+			.arrayDepth = 0,
+			.elements = NULL,
+			.includedPartials = 0,
+			.value = 0
+		};
+		if (_compileDocument(session->logger, &compilerState, watchedSource) == FAILED) {
+			// Keeps the last output, and retries when the source changes again.
+			logError(session->logger, "Cannot compile \"%s\" (the last output is kept).", path);
+			watchedSource->sourceHash = 0;
+			free(outputPath);
+			return;
+		}
+	}
+	watchedSource->sourceHash = sourceHash;
+	const Buffer * output = watchedSource->output;
+	const uint64_t outputHash = hashBytes(output->bytes, output->length, 0);
+	if (outputHash == watchedSource->outputHash) {
+		logInformation(session->logger, "Compiled \"%s\" in %.3f ms (the output did not change).", path, 1000 * (monotonicTime() - start));
+	}
+	else if ((isPatched && patchFile(outputPath, patch.offset, patch.removedLength, output->bytes + patch.offset, patch.insertedLength))
+			|| _writeFile(outputPath, output->bytes, output->length)) {
+		watchedSource->outputHash = outputHash;
+		logInformation(session->logger, "Compiled \"%s\" into \"%s\" in %.3f ms%s.", path, outputPath, 1000 * (monotonicTime() - start),
+			isPatched ? " (patched)" : "");
+	}
+	else {
+		logError(session->logger, "Cannot write the output: %s", outputPath);
+		releaseOutputMap(watchedSource->outputMap);
+		watchedSource->outputMap = NULL;
+	}
+	free(outputPath);
+}
+
+/**
+ * Parses the command-line arguments into the configuration. Returns false if
+ * an argument is unknown or malformed. Available options:
+ *
+ *	--cache-dir <directory>	Enables the persistent caches in that directory.
+ *	--cache-size <MiB>		The maximum size of the result cache.
+ *	--shared-cache			Shares results with concurrent compilers.
+ *	--watch <directory>		Recompiles the sources of the directory as they change.
+ *	--site <directory>		Builds the pages of the directory that changed.
+ *	--jobs <count>			How many pages of a site are built at the same time.
+ *	--output-dir <directory>	Where the outputs of a watch or a site are written.
+ *	--partials <directory>	Where the included partials are looked up.
+ *	--inline-styles			Writes the styles inline, instead of as shared classes.
+ *	--structural-lexer		Lexes from a structural index built with SIMD.
+ *	--parallel-parser		Parses the children of the body in parallel.
+ *	--pipeline			Lexes, parses and generates at the same time, on three threads.
+ *	--stream			Parses the standard input while it's read, chunk by chunk.
+ *	--check			Only validates the standard input (nothing is generated).
+ */
+static boolean _parseArguments(Logger * logger, const int count, const char ** arguments, CompilerConfiguration * configuration) {
+	for (int k = 1; k < count; ++k) {
+		const boolean hasValue = k + 1 < count;
+		if (strcmp(arguments[k], "--cache-dir") == 0 && hasValue) {
+			configuration->cacheDirectory = arguments[++k];
+		}
+		else if (strcmp(arguments[k], "--cache-size") == 0 && hasValue) {
+			char * end = NULL;
+			const unsigned long long megabytes = strtoull(arguments[++k], &end, 10);
+			if (end == arguments[k] || *end != '\0') {
+				logError(logger, "Invalid cache size: \"%s\"", arguments[k]);
+				return false;
+			}
+			configuration->maximumCacheSize = megabytes * 1024 * 1024;
+		}
+		else if (strcmp(arguments[k], "--shared-cache") == 0) {
+			configuration->useSharedCache = true;
+		}
+		else if (strcmp(arguments[k], "--watch") == 0 && hasValue) {
+			configuration->watchDirectory = arguments[++k];
+		}
+		else if (strcmp(arguments[k], "--site") == 0 && hasValue) {
+			configuration->siteDirectory = arguments[++k];
+		}
+		else if (strcmp(arguments[k], "--jobs") == 0 && hasValue) {
+			char * end = NULL;
+			const unsigned long jobs = strtoul(arguments[++k], &end, 10);
+			if (end == arguments[k] || *end != '\0' || jobs == 0) {
+				logError(logger, "Invalid number of jobs: \"%s\"", arguments[k]);
+				return false;
+			}
+			configuration->jobs = jobs;
+		}
+		else if (strcmp(arguments[k], "--output-dir") == 0 && hasValue) {
+			configuration->outputDirectory = arguments[++k];
+		}
+		else if (strcmp(arguments[k], "--partials") == 0 && hasValue) {
+			configuration->partialDirectory = arguments[++k];
+		}
+		else if (strcmp(arguments[k], "--inline-styles") == 0) {
+			configuration->inlineStyles = true;
+		}
+		else if (strcmp(arguments[k], "--structural-lexer") == 0) {
+			configuration->structuralLexer = true;
+		}
+		else if (strcmp(arguments[k], "--parallel-parser") == 0) {
+			configuration->structuralLexer = true;
+			configuration->parallelParser = true;
+		}
+		else if (strcmp(arguments[k], "--pipeline") == 0) {
+			configuration->pipeline = true;
+		}
+		else if (strcmp(arguments[k], "--stream") == 0) {
+			configuration->stream = true;
+		}
+		else if (strcmp(arguments[k], "--check") == 0) {
+			configuration->check = true;
+		}
+		else {
+			logError(logger, "Unknown or incomplete argument: \"%s\"", arguments[k]);
+			return false;
+		}
+	}
+	if (configuration->check && (configuration->watchDirectory != NULL || configuration->siteDirectory != NULL)) {
+		logError(logger, "Only the standard input can be checked (not with \"--watch\" nor \"--site\").");
+		return false;
+	}
+	if (configuration->outputDirectory == NULL) {
+		configuration->outputDirectory = configuration->siteDirectory == NULL
+			? configuration->watchDirectory
+			: configuration->siteDirectory;
+	}
+	if (configuration->partialDirectory == NULL) {
+		configuration->partialDirectory = configuration->siteDirectory != NULL
+			? configuration->siteDirectory
+			: (configuration->watchDirectory != NULL ? configuration->watchDirectory : ".");
+	}
+	const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	if (configuration->jobs == 0) {
+		configuration->jobs = processors < 1 ? 1 : processors;
+	}
+	if (configuration->pipeline && processors < 2) {
+		// The stages would only take turns on the same processor.
+		logDebugging(logger, "The pipeline is disabled, since there is a single processor.");
+		configuration->pipeline = false;
+	}
+	return true;
+}
+
+/**
+ * Parses a source in a pipeline of three threads: the lexer pushes the
+ * tokens into a ring, the parser takes them and pushes the elements of the
+ * body into another one as soon as they are parsed, and the generator
+ * generates them ahead (so "generate" only has to copy them, see
+ * "prepareElement"). If the generator can't be started, it's just a parse.
+ * A streamed source is parsed by chunks instead (on this thread).
+ */
+static SyntacticAnalysisStatus _parsePipelined(CompilerState * compilerState) {
+	RingBuffer * elements = createRingBuffer(sizeof(Value *), ELEMENT_RING_CAPACITY, ELEMENT_BATCH_SIZE);
+	pthread_t generator;
+	prepareGeneration(&compilerState->configuration);
+	const boolean isGenerating = pthread_create(&generator, NULL, _generateAhead, elements) == 0;
+	compilerState->elements = isGenerating ? elements : NULL;
+	const SyntacticAnalysisStatus syntacticAnalysisStatus = compilerState->configuration.stream
+		? _parseStream(compilerState)
+		: parse(compilerState);
+	compilerState->elements = NULL;
+	closeRingBuffer(elements);
+	if (isGenerating) {
+		pthread_join(generator, NULL);
+	}
+	destroyRingBuffer(elements);
+	return syntacticAnalysisStatus;
+}
+
+/**
+ * Parses the standard input while it's read: each chunk is pushed to the
+ * parser as soon as it arrives (e.g., from a pipe or a socket), instead of
+ * waiting for the entire source. Once the source is rejected, the rest is
+ * not read.
+ */
+static SyntacticAnalysisStatus _parseStream(CompilerState * compilerState) {
+	PushParser * pushParser = createPushParser(compilerState);
+	char chunk[STREAM_CHUNK_SIZE];
+	ssize_t length = 0;
+	// An error while reading ends the source (so it's likely rejected).
+	while (0 < (length = read(STDIN_FILENO, chunk, STREAM_CHUNK_SIZE)) || (length < 0 && errno == EINTR)) {
+		if (0 < length && !pushToParser(pushParser, chunk, length)) {
+			break;
+		}
+	}
+	return closePushParser(pushParser);
+}
+
+/**
+ * Watches a directory until interrupted, keeping the compiler (and its
+ * caches) warm, and recompiling each source as soon as it is saved.
+ */
+static CompilationStatus _watch(Logger * logger, const CompilerConfiguration * configuration) {
+	WatchSession session = {
+		.logger = logger,
+		.configuration = configuration,
+		.source = createBuffer(64 * 1024),
+		.sources = NULL,
+		.count = 0,
+		.capacity = 0
+	};
+	const boolean succeed = watchDirectory(configuration->watchDirectory, _onFileEvent, &session);
+	for (size_t k = 0; k < session.count; ++k) {
+		destroyIncrementalDocument(session.sources[k].document);
+		releaseOutputMap(session.sources[k].outputMap);
+		destroyBuffer(session.sources[k].output);
+		free(session.sources[k].name);
+	}
+	free(session.sources);
+	destroyBuffer(session.source);
+	return succeed ? SUCCEED : FAILED;
+}
+
+/**
+ * Finds the state of a source of a watch session by name, creating it if
+ * needed.
+ */
+static WatchedSource * _watchedSource(WatchSession * session, const char * name) {
+	for (size_t k = 0; k < session->count; ++k) {
+		if (strcmp(session->sources[k].name, name) == 0) {
+			return &session->sources[k];
+		}
+	}
+	if (session->count == session->capacity) {
+		session->capacity = session->capacity == 0 ? 16 : 2 * session->capacity;
+		session->sources = realloc(session->sources, session->capacity * sizeof(WatchedSource));
+	}
+	WatchedSource * watchedSource = &session->sources[session->count++];
+	watchedSource->name = concatenate(1, name);
+	watchedSource->sourceHash = 0;
+	watchedSource->outputHash = 0;
+	watchedSource->document = NULL;
+	watchedSource->output = createBuffer(64 * 1024);
+	watchedSource->outputMap = NULL;
+	return watchedSource;
+}
+
+/**
+ * Writes a file aside and renames it, so readers never see half an output.
+ */
+static boolean _writeFile(const char * path, const char * bytes, const size_t length) {
+	char * temporaryPath = concatenate(2, path, ".tmp~");
+	FILE * file = fopen(temporaryPath, "wb");
+	boolean succeed = false;
+	if (file != NULL) {
+		succeed = fwrite(bytes, sizeof(char), length, file) == length;
+		succeed = fclose(file) == 0 && succeed;
+		succeed = succeed && rename(temporaryPath, path) == 0;
+	}
+	if (!succeed) {
+		remove(temporaryPath);
+	}
+	free(temporaryPath);
+	return succeed;
+}
 
 /**
  * The main entry-point of the entire application. If you use "strtok" to
@@ -16,12 +798,28 @@
  */
 const int main(const int count, const char ** arguments) {
 	Logger * logger = createLogger("EntryPoint");
+	initializeStatisticsModule();
+	initializeResultCacheModule();
+	initializeSharedResultCacheModule();
+	initializeFilePatcherModule();
+	initializeFileWatcherModule();
+	initializeDependencyGraphModule();
+	initializeSymbolTableModule();
 	initializeFlexActionsModule();
+	initializeStructuralLexerModule();
+	initializeDependencyScannerModule();
 	initializeBisonActionsModule();
+	initializeElementSchemaModule();
+	initializeDescentParserModule();
 	initializeSyntacticAnalyzerModule();
 	initializeAbstractSyntaxTreeModule();
+	initializeAbstractSyntaxTreeCacheModule();
+	initializeHashConsingModule();
+	initializeIncrementalParserModule();
 	initializeCalculatorModule();
+	initializeStyleSheetModule();
 	initializeGeneratorModule();
+	initializePartialCompilerModule();
 
 	// Logs the arguments of the application.
 	for (int k = 0; k < count; ++k) {
@@ -32,32 +830,83 @@ const int main(const int count, const char ** arguments) {
 	CompilerState compilerState = {
 		.abstractSyntaxtTree = NULL,
 		.succeed = false,
+		.source = NULL,
+		.sourceLength = 0,
+		.output = createBuffer(64 * 1024),
+		.configuration = {
+			.cacheDirectory = NULL,
+			.maximumCacheSize = 256 * 1024 * 1024,
+			.useSharedCache = false,
+			.watchDirectory = NULL,
+			.outputDirectory = NULL,
+			.siteDirectory = NULL,
+			.partialDirectory = NULL,
+			.jobs = 0,
+			.inlineStyles = false,
+			.structuralLexer = false,
+			.parallelParser = false,
+			.pipeline = false,
+			.stream = false,
+			.check = false
+		},
+		.symbolTable = NULL,
+		.loopDepth = 0,
+		.arrayDepth = 0,
+		.elements = NULL,
+		.includedPartials = 0,
 		.value = 0
 	};
-	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(&compilerState);
-	CompilationStatus compilationStatus = SUCCEED;
-	Program * program = compilerState.abstractSyntaxtTree;
-	if (syntacticAnalysisStatus == ACCEPT) {
-		// ----------------------------------------------------------------------------------------
-		// Beginning of the Backend... ------------------------------------------------------------
-		logDebugging(logger, "Generating HTML output...");
-		generate(&compilerState);
-		// ...end of the Backend. -----------------------------------------------------------------
-		// ----------------------------------------------------------------------------------------
+	CompilationStatus compilationStatus = FAILED;
+	if (_parseArguments(logger, count, arguments, &compilerState.configuration)) {
+		if (compilerState.configuration.useSharedCache && !attachSharedResultCache()) {
+			compilerState.configuration.useSharedCache = false;
+		}
+		setPartialDirectory(compilerState.configuration.partialDirectory);
+		if (compilerState.configuration.siteDirectory != NULL) {
+			compilationStatus = _buildSite(logger, &compilerState.configuration);
+		}
+		else if (compilerState.configuration.watchDirectory != NULL) {
+			compilationStatus = _watch(logger, &compilerState.configuration);
+		}
+		else {
+			// Reads the entire source up-front, so it can be hashed (unless
+			// it's parsed while it's read).
+			Buffer * source = createBuffer(64 * 1024);
+			if (!compilerState.configuration.stream) {
+				appendStreamToBuffer(source, stdin);
+				compilerState.source = source->bytes;
+				compilerState.sourceLength = source->length;
+			}
+			compilationStatus = _compile(logger, &compilerState);
+			fwrite(compilerState.output->bytes, sizeof(char), compilerState.output->length, stdout);
+			fflush(stdout);
+			destroyBuffer(source);
+		}
 	}
-	else {
-		logError(logger, "The syntactic-analysis phase rejects the input program.");
-		compilationStatus = FAILED;
-	}
-	logDebugging(logger, "Releasing AST resources...");
-	releaseProgram(program);
+	destroyBuffer(compilerState.output);
 	logDebugging(logger, "Releasing modules resources...");
+	shutdownPartialCompilerModule();
 	shutdownGeneratorModule();
+	shutdownStyleSheetModule();
 	shutdownCalculatorModule();
+	shutdownIncrementalParserModule();
+	shutdownHashConsingModule();
+	shutdownAbstractSyntaxTreeCacheModule();
 	shutdownAbstractSyntaxTreeModule();
 	shutdownSyntacticAnalyzerModule();
+	shutdownDescentParserModule();
+	shutdownElementSchemaModule();
 	shutdownBisonActionsModule();
+	shutdownDependencyScannerModule();
+	shutdownStructuralLexerModule();
 	shutdownFlexActionsModule();
+	shutdownSymbolTableModule();
+	shutdownDependencyGraphModule();
+	shutdownFileWatcherModule();
+	shutdownFilePatcherModule();
+	shutdownSharedResultCacheModule();
+	shutdownResultCacheModule();
+	shutdownStatisticsModule();
 	logDebugging(logger, "Compilation is done.");
 	destroyLogger(logger);
 	return compilationStatus;
@@ -1,5 +1,8 @@
 #include "Generator.h"
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../domain-specific/Calculator.h"
+#include "PartialCompiler.h"
+#include "StyleSheet.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
@@ -7,15 +10,90 @@
 
 /* MODULE INTERNAL STATE */
 
+/**
+ * An already emitted subtree: the range of the output buffer where a shared
+ * node was generated at a given indentation level, and how long it took.
+ */
+typedef struct {
+	const Value * value;
+	unsigned int indentationLevel;
+	size_t offset;
+	size_t length;
+	double elapsedTime;
+	OutputSpan * span;
+} Emission;
+
+/**
+ * An element generated ahead (see "prepareElement"): its output (NULL if it
+ * can't be generated ahead), whether it failed, and how many references to
+ * it the table holds.
+ */
+typedef struct {
+	Value * value;
+	char * bytes;
+	size_t length;
+	boolean failed;
+	unsigned int references;
+} PreparedElement;
+
+// The indentation level of the root element of a page, and the one of the
+// elements of its body (those generated ahead).
+#define ROOT_INDENTATION_LEVEL 0
+#define ELEMENT_INDENTATION_LEVEL (ROOT_INDENTATION_LEVEL + 2)
+
 const char _indentationCharacter = ' ';
 const char _indentationSize = 4;
+static Emission * _emissions = NULL;
+static unsigned int _emissionsCapacity = 0;
+static unsigned int _emissionsCount = 0;
 static Logger * _logger = NULL;
+static Buffer * _outputBuffer = NULL;
+
+// The span being generated (NULL if the output map is not recorded).
+static OutputSpan * _currentSpan = NULL;
+static size_t _currentSpanStart = 0;
+
+// The element bound to the variable of each enclosing loop, by slot.
+static Value * _bindings[MAXIMUM_LOOP_DEPTH];
+
+// The rules of the styles of the page, and where they are declared (inside
+// the head, once the entire page was generated).
+static StyleSheet * _styleSheet = NULL;
+static boolean _hasStyleSheetOffset = false;
+static size_t _styleSheetOffset = 0;
+static unsigned int _styleSheetIndentationLevel = 0;
+
+// Whether styles are written inline, instead of as shared classes.
+static boolean _inlineStyles = false;
+
+// Whether a partial could not be included, and how many were.
+static boolean _failed = false;
+static unsigned int _includedPartials = 0;
+
+// The elements generated ahead, by node (open-addressing, linear probing),
+// and whether one is being generated (then, it can't include a partial, nor
+// read the references of the nodes, that the parser may be updating).
+static PreparedElement * _preparedElements = NULL;
+static unsigned int _preparedElementsCapacity = 0;
+static unsigned int _preparedElementsCount = 0;
+static boolean _isPreparing = false;
+static boolean _isDeferred = false;
 
 void initializeGeneratorModule() {
 	_logger = createLogger("Generator");
+	_styleSheet = createStyleSheet();
 }
 
 void shutdownGeneratorModule() {
+	if (_emissions != NULL) {
+		free(_emissions);
+		_emissions = NULL;
+	}
+	releasePreparedElements();
+	free(_preparedElements);
+	_preparedElements = NULL;
+	destroyStyleSheet(_styleSheet);
+	_styleSheet = NULL;
 	if (_logger != NULL) {
 		destroyLogger(_logger);
 	}
@@ -23,15 +101,13 @@ void shutdownGeneratorModule() {
 
 /** PRIVATE FUNCTIONS */
 
-static const char _expressionTypeToCharacter(const ExpressionType type);
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant);
-static void _generateEpilogue(const int value);
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression);
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor);
 static void _generateProgram(Program * program);
 static void _generatePrologue(void);
 static char * _indentation(const unsigned int indentationLevel);
 static void _output(const unsigned int indentationLevel, const char * const format, ...);
+static void _outputIndentation(const unsigned int indentationLevel);
+static void _outputInteger(const unsigned int indentationLevel, const int64_t integer);
+static void _outputReal(const unsigned int indentationLevel, const double real);
 static void _generateHTMLElement(const unsigned int indentationLevel, HTMLElement * element);
 static void _generateHTMLElementHTML(const unsigned int indentationLevel, HTMLElementHTML * element);
 static void _generateHTMLElementHead(const unsigned int indentationLevel, HTMLElementHead * element);
@@ -43,145 +119,309 @@ static void _generateHTMLElementH1(const unsigned int indentationLevel, HTMLElem
 static void _generateHTMLElementImg(const unsigned int indentationLevel, HTMLElementImg * element);
 static void _generateHTMLElementA(const unsigned int indentationLevel, HTMLElementA * element);
 static void _generateHTMLElementCenter(const unsigned int indentationLevel, HTMLElementCenter * element);
+static void _generateAttributes(const HTMLElement * element);
+static void _generateContent(const unsigned int indentationLevel, const char * tag, Value * content);
+static void _generateStyleAttribute(const HTMLElement * element, const Value * className);
+static void _generateText(const Value * value);
+static boolean _isText(const Value * value);
+static void _serializeStyle(const StyleProperties * style, Buffer * declarations);
+static void _spliceStyleSheet(void);
+static Value * _chooseBranch(Conditional * conditional);
+static boolean _evaluate(const Evaluation * evaluation, Value * result);
+static void _generateChild(const unsigned int indentationLevel, Value * child);
+static void _generateElement(const unsigned int indentationLevel, Value * element, boolean * isFirst);
+static void _generateInclude(const unsigned int indentationLevel, Value * value);
+static void _generateLoop(const unsigned int indentationLevel, Loop * loop, boolean * isFirst);
+static void _checkLoop(Loop * loop);
+static void _checkValue(Value * value);
+static const Value * _resolveIterable(Loop * loop, Value * scratch);
+static const Value * _resolve(Value * value, Value * scratch);
 static void _generateValue(const unsigned int indentationLevel, Value * value);
+static void _generateSharedValue(const unsigned int indentationLevel, Value * value);
+static void _generateValueContent(const unsigned int indentationLevel, Value * value);
+static Emission * _findEmission(const Value * value, const unsigned int indentationLevel);
+static PreparedElement * _findPreparedElement(const Value * value);
+static void _insertEmission(const Emission emission);
+static void _insertPreparedElement(const PreparedElement preparedElement);
+static void _recordEmission(const Value * value, const unsigned int indentationLevel, const size_t offset, const double elapsedTime);
+static void _resetEmissions(void);
+static OutputSpan * _createSpan(OutputSpan * parent, const size_t offset, const size_t length, const unsigned int indentationLevel);
+static void _copySpans(OutputSpan * target, const OutputSpan * source);
+static OutputSpan * _findSpan(OutputSpan * span, const Value * value, unsigned int * count);
+static OutputSpan * _openSpan(const unsigned int indentationLevel, const Value * value);
+static void _closeSpan(OutputSpan * span);
 static void _generateObject(const unsigned int indentationLevel, Object * object);
 static void _generateArray(const unsigned int indentationLevel, Array * array);
 
 /**
- * Converts and expression type to the proper character of the operation
- * involved, or returns '\0' if that's not possible.
+ * Generates the output of the program.
  */
-static const char _expressionTypeToCharacter(const ExpressionType type) {
-	switch (type) {
-		case ADDITION: return '+';
-		case DIVISION: return '/';
-		case MULTIPLICATION: return '*';
-		case SUBTRACTION: return '-';
-		default:
-			logError(_logger, "The specified expression type cannot be converted into character: %d", type);
-			return '\0';
+static void _generateProgram(Program * program) {
+	if (program->root != NULL) {
+		_generateHTMLElement(ROOT_INDENTATION_LEVEL, program->root);
 	}
 }
 
 /**
- * Generates the output of a constant.
+ * Creates the prologue of the generated output, the doctype of an HTML5
+ * document.
  */
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant) {
-	_output(indentationLevel, "%s", "[ $C$, circle, draw, black!20\n");
-	_output(1 + indentationLevel, "%s%d%s", "[ $", constant->value, "$, circle, draw ]\n");
-	_output(indentationLevel, "%s", "]\n");
+static void _generatePrologue(void) {
+	_output(0, "%s", "<!DOCTYPE html>\n");
 }
 
 /**
- * Creates the epilogue of the generated output, that is, the final lines that
- * completes a valid Latex document.
+ * Generates an indentation string for the specified level.
  */
-static void _generateEpilogue(const int value) {
-	_output(0, "%s%d%s",
-		"            [ $", value, "$, circle, draw, blue ]\n"
-		"        ]\n"
-		"    \\end{forest}\n"
-		"\\end{document}\n\n"
-	);
+static char * _indentation(const unsigned int level) {
+	return indentation(_indentationCharacter, level, _indentationSize);
 }
 
 /**
- * Generates the output of an expression.
+ * Outputs a formatted string into the output buffer of the compiler state.
+ * Already emitted ranges of that buffer can be replayed later (see
+ * "_generateSharedValue").
  */
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression) {
-	_output(indentationLevel, "%s", "[ $E$, circle, draw, black!20\n");
-	switch (expression->type) {
-		case ADDITION:
-		case DIVISION:
-		case MULTIPLICATION:
-		case SUBTRACTION:
-			_generateExpression(1 + indentationLevel, expression->leftExpression);
-			_output(1 + indentationLevel, "%s%c%s", "[ $", _expressionTypeToCharacter(expression->type), "$, circle, draw, purple ]\n");
-			_generateExpression(1 + indentationLevel, expression->rightExpression);
-			break;
-		case FACTOR:
-			_generateFactor(1 + indentationLevel, expression->factor);
-			break;
-		default:
-			logError(_logger, "The specified expression type is unknown: %d", expression->type);
-			break;
+static void _output(const unsigned int indentationLevel, const char * const format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	char * indentation = _indentation(indentationLevel);
+	char * effectiveFormat = concatenate(2, indentation, format);
+	appendFormattedToBuffer(_outputBuffer, effectiveFormat, arguments);
+	free(effectiveFormat);
+	free(indentation);
+	va_end(arguments);
+}
+
+/**
+ * Outputs an indentation straight into the output buffer.
+ */
+static void _outputIndentation(const unsigned int indentationLevel) {
+	const size_t length = indentationLevel * _indentationSize;
+	reserveBuffer(_outputBuffer, length);
+	memset(_outputBuffer->bytes + _outputBuffer->length, _indentationCharacter, length);
+	_outputBuffer->length += length;
+}
+
+/**
+ * Analog to "_output", but numbers are formatted straight into the output
+ * buffer, without going through "printf" (see "NumberFormat.h").
+ */
+static void _outputInteger(const unsigned int indentationLevel, const int64_t integer) {
+	_outputIndentation(indentationLevel);
+	appendIntegerToBuffer(_outputBuffer, integer);
+}
+
+static void _outputReal(const unsigned int indentationLevel, const double real) {
+	_outputIndentation(indentationLevel);
+	appendRealToBuffer(_outputBuffer, real);
+}
+
+/**
+ * Finds a previous emission of the same (shared) node at the same
+ * indentation level, or returns NULL.
+ */
+static Emission * _findEmission(const Value * value, const unsigned int indentationLevel) {
+	if (_emissionsCount == 0) {
+		return NULL;
 	}
-	_output(indentationLevel, "%s", "]\n");
+	const unsigned int mask = _emissionsCapacity - 1;
+	const uint64_t hash = combineHashes(value->hash, indentationLevel);
+	for (unsigned int k = hash & mask; _emissions[k].value != NULL; k = (k + 1) & mask) {
+		if (_emissions[k].value == value && _emissions[k].indentationLevel == indentationLevel) {
+			return &_emissions[k];
+		}
+	}
+	return NULL;
 }
 
 /**
- * Generates the output of a factor.
+ * Inserts an emission in the table, without checking its load.
  */
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor) {
-	_output(indentationLevel, "%s", "[ $F$, circle, draw, black!20\n");
-	switch (factor->type) {
-		case CONSTANT:
-			_generateConstant(1 + indentationLevel, factor->constant);
-			break;
-		case EXPRESSION:
-			_output(1 + indentationLevel, "%s", "[ $($, circle, draw, purple ]\n");
-			_generateExpression(1 + indentationLevel, factor->expression);
-			_output(1 + indentationLevel, "%s", "[ $)$, circle, draw, purple ]\n");
-			break;
-		default:
-			logError(_logger, "The specified factor type is unknown: %d", factor->type);
-			break;
+static void _insertEmission(const Emission emission) {
+	const unsigned int mask = _emissionsCapacity - 1;
+	unsigned int k = combineHashes(emission.value->hash, emission.indentationLevel) & mask;
+	while (_emissions[k].value != NULL) {
+		k = (k + 1) & mask;
 	}
-	_output(indentationLevel, "%s", "]\n");
+	_emissions[k] = emission;
+	++_emissionsCount;
 }
 
 /**
- * Generates the output of the program.
+ * Finds an element generated ahead, or returns NULL.
  */
-static void _generateProgram(Program * program) {
-	if (program->root != NULL) {
-		_generateHTMLElement(3, program->root);
+static PreparedElement * _findPreparedElement(const Value * value) {
+	if (_preparedElementsCount == 0) {
+		return NULL;
+	}
+	const unsigned int mask = _preparedElementsCapacity - 1;
+	for (unsigned int k = value->hash & mask; _preparedElements[k].value != NULL; k = (k + 1) & mask) {
+		if (_preparedElements[k].value == value) {
+			return &_preparedElements[k];
+		}
 	}
+	return NULL;
 }
 
 /**
- * Creates the prologue of the generated output, a Latex document that renders
- * a tree thanks to the Forest package.
- *
- * @see https://ctan.dcc.uchile.cl/graphics/pgf/contrib/forest/forest-doc.pdf
+ * Inserts an element generated ahead in the table, growing it if needed.
  */
-static void _generatePrologue(void) {
-	_output(0, "%s",
-		"\\documentclass{standalone}\n\n"
-		"\\usepackage[utf8]{inputenc}\n"
-		"\\usepackage[T1]{fontenc}\n"
-		"\\usepackage{amsmath}\n"
-		"\\usepackage{forest}\n"
-		"\\usepackage{microtype}\n\n"
-		"\\begin{document}\n"
-		"    \\centering\n"
-		"    \\begin{forest}\n"
-		"        [ \\text{$=$}, circle, draw, purple\n"
-	);
+static void _insertPreparedElement(const PreparedElement preparedElement) {
+	if (_preparedElementsCapacity < 2 * (_preparedElementsCount + 1)) {
+		PreparedElement * oldElements = _preparedElements;
+		const unsigned int oldCapacity = _preparedElementsCapacity;
+		_preparedElementsCapacity = oldCapacity == 0 ? 64 : 2 * oldCapacity;
+		_preparedElements = calloc(_preparedElementsCapacity, sizeof(PreparedElement));
+		_preparedElementsCount = 0;
+		for (unsigned int k = 0; k < oldCapacity; ++k) {
+			if (oldElements[k].value != NULL) {
+				_insertPreparedElement(oldElements[k]);
+			}
+		}
+		free(oldElements);
+	}
+	const unsigned int mask = _preparedElementsCapacity - 1;
+	unsigned int k = preparedElement.value->hash & mask;
+	while (_preparedElements[k].value != NULL) {
+		k = (k + 1) & mask;
+	}
+	_preparedElements[k] = preparedElement;
+	++_preparedElementsCount;
 }
 
 /**
- * Generates an indentation string for the specified level.
+ * Remembers that a shared node was emitted from the specified offset up to
+ * the current end of the output buffer.
  */
-static char * _indentation(const unsigned int level) {
-	return indentation(_indentationCharacter, level, _indentationSize);
+static void _recordEmission(const Value * value, const unsigned int indentationLevel, const size_t offset, const double elapsedTime) {
+	if (_emissionsCapacity < 2 * (_emissionsCount + 1)) {
+		Emission * oldEmissions = _emissions;
+		const unsigned int oldCapacity = _emissionsCapacity;
+		_emissionsCapacity = oldCapacity == 0 ? 256 : 2 * oldCapacity;
+		_emissions = calloc(_emissionsCapacity, sizeof(Emission));
+		_emissionsCount = 0;
+		for (unsigned int k = 0; k < oldCapacity; ++k) {
+			if (oldEmissions[k].value != NULL) {
+				_insertEmission(oldEmissions[k]);
+			}
+		}
+		free(oldEmissions);
+	}
+	const Emission emission = {
+		.value = value,
+		.indentationLevel = indentationLevel,
+		.offset = offset,
+		.length = _outputBuffer->length - offset,
+		.elapsedTime = elapsedTime,
+		.span = _currentSpan
+	};
+	_insertEmission(emission);
 }
 
 /**
- * Outputs a formatted string to standard output. The "fflush" instruction
- * allows to see the output even close to a failure, because it drops the
- * buffering.
+ * Forgets every emission (their offsets are only valid during a generation).
  */
-static void _output(const unsigned int indentationLevel, const char * const format, ...) {
-	va_list arguments;
-	va_start(arguments, format);
-	char * indentation = _indentation(indentationLevel);
-	char * effectiveFormat = concatenate(2, indentation, format);
-	vfprintf(stdout, effectiveFormat, arguments);
-	fflush(stdout);
-	free(effectiveFormat);
-	free(indentation);
-	va_end(arguments);
+static void _resetEmissions(void) {
+	_emissionsCount = 0;
+	if (_emissions != NULL) {
+		memset(_emissions, 0, _emissionsCapacity * sizeof(Emission));
+	}
+}
+
+/**
+ * Creates a span, appending it to the children of its parent (if any).
+ */
+static OutputSpan * _createSpan(OutputSpan * parent, const size_t offset, const size_t length, const unsigned int indentationLevel) {
+	OutputSpan * span = calloc(1, sizeof(OutputSpan));
+	span->offset = offset;
+	span->length = length;
+	span->indentationLevel = indentationLevel;
+	if (parent != NULL) {
+		if (parent->count == parent->capacity) {
+			parent->capacity = parent->capacity == 0 ? 4 : 2 * parent->capacity;
+			parent->children = realloc(parent->children, parent->capacity * sizeof(OutputSpan *));
+		}
+		span->parent = parent;
+		span->index = parent->count;
+		parent->children[parent->count++] = span;
+	}
+	return span;
+}
+
+/**
+ * Copies the descendants of a span into another one (used when the output of
+ * a shared value is replayed, since the offsets are relative).
+ */
+static void _copySpans(OutputSpan * target, const OutputSpan * source) {
+	for (unsigned int k = 0; k < source->count; ++k) {
+		const OutputSpan * child = source->children[k];
+		OutputSpan * copy = _createSpan(target, child->offset, child->length, child->indentationLevel);
+		copy->value = child->value;
+		_copySpans(copy, child);
+	}
+}
+
+/**
+ * Finds a span generated from a value, among a span and its descendants, and
+ * counts how many there are (it stops counting at two).
+ */
+static OutputSpan * _findSpan(OutputSpan * span, const Value * value, unsigned int * count) {
+	OutputSpan * found = NULL;
+	if (span->value == value) {
+		found = span;
+		++*count;
+	}
+	for (unsigned int k = 0; k < span->count && *count < 2; ++k) {
+		OutputSpan * descendant = _findSpan(span->children[k], value, count);
+		if (found == NULL) {
+			found = descendant;
+		}
+	}
+	return found;
+}
+
+/**
+ * Opens the span of a composite value that begins at the end of the output.
+ */
+static OutputSpan * _openSpan(const unsigned int indentationLevel, const Value * value) {
+	OutputSpan * span = _createSpan(_currentSpan, _outputBuffer->length - _currentSpanStart, 0, indentationLevel);
+	span->value = value;
+	_currentSpan = span;
+	_currentSpanStart = _outputBuffer->length;
+	return span;
+}
+
+/**
+ * Closes the span opened last, at the end of the output.
+ */
+static void _closeSpan(OutputSpan * span) {
+	span->length = _outputBuffer->length - _currentSpanStart;
+	_currentSpanStart -= span->offset;
+	_currentSpan = span->parent;
+}
+
+/**
+ * Generates a node that is shared across the tree (thanks to hash-consing).
+ * The first time, the node is generated as usual and its output range is
+ * recorded; after that, the same bytes are replayed with a single copy.
+ */
+static void _generateSharedValue(const unsigned int indentationLevel, Value * value) {
+	Emission * emission = _findEmission(value, indentationLevel);
+	if (emission != NULL) {
+		appendRangeToBuffer(_outputBuffer, emission->offset, emission->length);
+		if (_currentSpan != NULL && emission->span != NULL) {
+			_copySpans(_currentSpan, emission->span);
+		}
+		addToStatistic("generator.replayed-emissions", 1);
+		addToStatistic("generator.replayed-bytes", emission->length);
+		addToStatistic("generator.saved-time", emission->elapsedTime);
+		return;
+	}
+	const size_t offset = _outputBuffer->length;
+	const double start = monotonicTime();
+	_generateValueContent(indentationLevel, value);
+	_recordEmission(value, indentationLevel, offset, monotonicTime() - start);
 }
 
 /**
@@ -230,10 +470,10 @@ static void _generateHTMLElement(const unsigned int indentationLevel, HTMLElemen
 static void _generateHTMLElementHTML(const unsigned int indentationLevel, HTMLElementHTML * element) {
 	_output(indentationLevel, "<html>\n");
 	if (element->head != NULL) {
-		_generateHTMLElementHead(indentationLevel + 1, (HTMLElementHead*)element->head);
+		_generateHTMLElementHead(indentationLevel + 1, element->head);
 	}
 	if (element->body != NULL) {
-		_generateHTMLElementBody(indentationLevel + 1, (HTMLElementBody*)element->body);
+		_generateHTMLElementBody(indentationLevel + 1, element->body);
 	}
 	_output(indentationLevel, "</html>\n");
 }
@@ -241,22 +481,28 @@ static void _generateHTMLElementHTML(const unsigned int indentationLevel, HTMLEl
 static void _generateHTMLElementHead(const unsigned int indentationLevel, HTMLElementHead * element) {
 	_output(indentationLevel, "<head>\n");
 	if (element->title != NULL) {
-		_generateHTMLElementTitle(indentationLevel + 1, (HTMLElementTitle*)element->title);
+		_generateHTMLElementTitle(indentationLevel + 1, element->title);
 	}
+	// The styles are known only after the body, so they are spliced later.
+	_hasStyleSheetOffset = true;
+	_styleSheetOffset = _outputBuffer->length;
+	_styleSheetIndentationLevel = indentationLevel + 1;
 	_output(indentationLevel, "</head>\n");
 }
 
 static void _generateHTMLElementTitle(const unsigned int indentationLevel, HTMLElementTitle * element) {
-	_output(indentationLevel, "<title>%s</title>\n", element->content);
+	_output(indentationLevel, "<title>%s</title>\n", element->content == NULL ? "" : element->content);
 }
 
 static void _generateHTMLElementBody(const unsigned int indentationLevel, HTMLElementBody * element) {
-	_output(indentationLevel, "<body>\n");
+	_output(indentationLevel, "<body");
+	_generateAttributes(&element->base);
+	_output(0, ">\n");
 	if (element->content != NULL) {
 		for (int i = 0; i < element->content->count; i++) {
 			Value * value = element->content->elements[i];
 			if (value != NULL) {
-				_generateValue(indentationLevel + 1, value);
+				_generateElement(indentationLevel, value, NULL);
 			}
 		}
 	}
@@ -264,71 +510,531 @@ static void _generateHTMLElementBody(const unsigned int indentationLevel, HTMLEl
 }
 
 static void _generateHTMLElementDiv(const unsigned int indentationLevel, HTMLElementDiv * element) {
-	_output(indentationLevel, "<div>\n");
-	if (element->content != NULL) {
-		for (int i = 0; i < element->content->count; i++) {
-			Value * value = element->content->elements[i];
-			if (value != NULL) {
-				_generateValue(indentationLevel + 1, value);
-			}
-		}
-	}
-	_output(indentationLevel, "</div>\n");
+	_output(indentationLevel, "<div");
+	_generateAttributes(&element->base);
+	_generateContent(indentationLevel, "div", element->content);
 }
 
 static void _generateHTMLElementP(const unsigned int indentationLevel, HTMLElementP * element) {
-	_output(indentationLevel, "<p>");
-	if (element->content != NULL) {
-		_generateValue(indentationLevel, element->content);
-	}
-	_output(indentationLevel, "</p>\n");
+	_output(indentationLevel, "<p");
+	_generateAttributes(&element->base);
+	_generateContent(indentationLevel, "p", element->content);
 }
 
 static void _generateHTMLElementH1(const unsigned int indentationLevel, HTMLElementH1 * element) {
-	_output(indentationLevel, "<h1>");
-	if (element->content != NULL) {
-		_generateValue(indentationLevel, element->content);
-	}
-	_output(indentationLevel, "</h1>\n");
+	_output(indentationLevel, "<h1");
+	_generateAttributes(&element->base);
+	_generateContent(indentationLevel, "h1", element->content);
 }
 
 static void _generateHTMLElementImg(const unsigned int indentationLevel, HTMLElementImg * element) {
-	_output(indentationLevel, "<img src=\"%s\" alt=\"%s\" />\n", element->src, element->alt);
+	_output(indentationLevel, "<img src=\"");
+	_generateText(element->src);
+	_output(0, "\" alt=\"");
+	_generateText(element->alt);
+	_output(0, "\"");
+	_generateAttributes(&element->base);
+	_output(0, " />\n");
 }
 
 static void _generateHTMLElementA(const unsigned int indentationLevel, HTMLElementA * element) {
-	_output(indentationLevel, "<a href=\"%s\">", element->href);
-	if (element->content != NULL) {
-		_generateValue(indentationLevel, element->content);
+	// An internal reference is an anchor of the page, and an external one is
+	// opened apart.
+	_output(indentationLevel, "<a href=\"");
+	if (element->ref != NULL) {
+		_output(0, "#");
+		_generateText(element->ref);
+	}
+	else {
+		_generateText(element->href != NULL ? element->href : element->extRef);
 	}
-	_output(indentationLevel, "</a>\n");
+	_output(0, element->extRef != NULL ? "\" target=\"_blank\"" : "\"");
+	_generateAttributes(&element->base);
+	_generateContent(indentationLevel, "a", element->content);
 }
 
 static void _generateHTMLElementCenter(const unsigned int indentationLevel, HTMLElementCenter * element) {
-	_output(indentationLevel, "<center>\n");
-	if (element->content != NULL) {
-		for (int i = 0; i < element->content->count; i++) {
-			Value * value = element->content->elements[i];
-			if (value != NULL) {
-				_generateValue(indentationLevel + 1, value);
+	_output(indentationLevel, "<center");
+	_generateAttributes(&element->base);
+	_generateContent(indentationLevel, "center", element->content);
+}
+
+/**
+ * Generates the attributes of an element that come from its entries (its
+ * identifier and its class), and its style.
+ */
+static void _generateAttributes(const HTMLElement * element) {
+	const Entry * identifier = element->attributes == NULL ? NULL : findElementEntry(element->attributes, "id");
+	const Entry * classEntry = element->attributes == NULL ? NULL : findElementEntry(element->attributes, "class");
+	if (identifier != NULL) {
+		_output(0, " id=\"");
+		_generateText(identifier->value);
+		_output(0, "\"");
+	}
+	_generateStyleAttribute(element, classEntry == NULL ? NULL : classEntry->value);
+}
+
+/**
+ * Generates the content of an element, and closes it: a scalar is written
+ * inline, as text, and anything else as a block of children (see
+ * "_generateElement").
+ */
+static void _generateContent(const unsigned int indentationLevel, const char * tag, Value * content) {
+	Value scratch;
+	const Value * resolved = _resolve(content, &scratch);
+	if (resolved == NULL || _isText(resolved)) {
+		_output(0, ">");
+		_generateText(resolved);
+		_output(0, "</%s>\n", tag);
+		return;
+	}
+	_output(0, ">\n");
+	_generateElement(indentationLevel, (Value *) resolved, NULL);
+	_output(indentationLevel, "</%s>\n", tag);
+}
+
+/**
+ * Generates a scalar value as text (a string without its quotes), resolving
+ * the loop variables it uses. Nothing is written if there is no value.
+ */
+static void _generateText(const Value * value) {
+	Value scratch;
+	const Value * resolved = _resolve((Value *) value, &scratch);
+	if (resolved == NULL) {
+		return;
+	}
+	if (resolved->type == STRING_VALUE) {
+		const size_t length = strlen(resolved->string);
+		const boolean isQuoted = 2 <= length && resolved->string[0] == '"';
+		appendToBuffer(_outputBuffer, isQuoted ? resolved->string + 1 : resolved->string, isQuoted ? length - 2 : length);
+	}
+	else {
+		_generateValueContent(0, (Value *) resolved);
+	}
+}
+
+/**
+ * Whether a (resolved) value is written as text, inside of an element.
+ */
+static boolean _isText(const Value * value) {
+	switch (value->type) {
+		case STRING_VALUE:
+		case INTEGER_VALUE:
+		case REAL_VALUE:
+		case BOOLEAN_VALUE:
+		case NULL_VALUE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Writes the canonical declarations of a style that uses a loop variable,
+ * with the values of the current iteration.
+ */
+static void _serializeStyle(const StyleProperties * style, Buffer * declarations) {
+	for (int k = 0; k < style->count; ++k) {
+		const StyleProperty * property = style->properties[k];
+		StyleValue resolved = *property->value;
+		if (resolved.type == EXPRESSION_STYLE) {
+			Value scratch;
+			const Value * value = _resolve(property->value->expression, &scratch);
+			if (value != NULL && value->type == STRING_VALUE) {
+				resolved = (StyleValue) { .type = STRING_STYLE, .string = value->string };
+			}
+			else if (value != NULL && value->type == INTEGER_VALUE) {
+				resolved = (StyleValue) { .type = INTEGER_STYLE, .integer = value->integer };
+			}
+			else if (value != NULL && value->type == REAL_VALUE) {
+				resolved = (StyleValue) { .type = REAL_STYLE, .real = value->real };
+			}
+			else {
+				logError(_logger, "The style property \"%s\" must be a string or a number.", property->key);
+				_failed = true;
+				continue;
 			}
 		}
+		appendStyleDeclaration(declarations, property->key, &resolved);
 	}
-	_output(indentationLevel, "</center>\n");
 }
 
+/**
+ * Generates the class and the style of an element (if any). By default,
+ * every element with the same canonical declarations shares a class (added
+ * to its own one), so each style is declared only once, in the head;
+ * otherwise, the style is written inline, with a single copy of the
+ * attribute serialized while parsing. A style that uses a loop variable is
+ * serialized on each iteration instead.
+ */
+static void _generateStyleAttribute(const HTMLElement * element, const Value * className) {
+	const StyleProperties * style = element->style;
+	const boolean hasStyle = style != NULL && 0 < style->count;
+	Buffer * declarations = NULL;
+	if (hasStyle && style->declarations == NULL) {
+		declarations = createBuffer(128);
+		_serializeStyle(style, declarations);
+	}
+	const char * styleClassName = NULL;
+	if (hasStyle && !_inlineStyles) {
+		styleClassName = declarations == NULL
+			? addStyleRule(_styleSheet, style->declarations, style->declarationsLength, style->hash)
+			: addStyleRule(_styleSheet, declarations->bytes, declarations->length, hashBytes(declarations->bytes, declarations->length, 0));
+	}
+	if (className != NULL || styleClassName != NULL) {
+		appendToBuffer(_outputBuffer, " class=\"", 8);
+		_generateText(className);
+		if (className != NULL && styleClassName != NULL) {
+			appendToBuffer(_outputBuffer, " ", 1);
+		}
+		if (styleClassName != NULL) {
+			appendToBuffer(_outputBuffer, styleClassName, strlen(styleClassName));
+		}
+		appendToBuffer(_outputBuffer, "\"", 1);
+	}
+	if (hasStyle && _inlineStyles) {
+		if (declarations == NULL) {
+			appendToBuffer(_outputBuffer, style->attribute, style->attributeLength);
+		}
+		else {
+			appendStyleAttribute(_outputBuffer, declarations->bytes, declarations->length);
+		}
+	}
+	if (declarations != NULL) {
+		destroyBuffer(declarations);
+	}
+}
+
+/**
+ * Inserts the rules of the styles used by the page in a single style block,
+ * at the end of the head. The output map (if any) is shifted accordingly.
+ */
+static void _spliceStyleSheet(void) {
+	if (countStyleRules(_styleSheet) == 0) {
+		return;
+	}
+	if (!_hasStyleSheetOffset) {
+		logError(_logger, "The styles cannot be declared without a head.");
+		_failed = true;
+		return;
+	}
+	char * outerIndentation = _indentation(_styleSheetIndentationLevel);
+	char * innerIndentation = _indentation(1 + _styleSheetIndentationLevel);
+	Buffer * block = createBuffer(1024);
+	appendToBuffer(block, outerIndentation, strlen(outerIndentation));
+	appendToBuffer(block, "<style>\n", 8);
+	appendStyleSheet(_styleSheet, block, innerIndentation);
+	appendToBuffer(block, outerIndentation, strlen(outerIndentation));
+	appendToBuffer(block, "</style>\n", 9);
+	free(innerIndentation);
+	free(outerIndentation);
+
+	reserveBuffer(_outputBuffer, block->length);
+	char * insertion = _outputBuffer->bytes + _styleSheetOffset;
+	memmove(insertion + block->length, insertion, _outputBuffer->length - _styleSheetOffset);
+	memcpy(insertion, block->bytes, block->length);
+	_outputBuffer->length += block->length;
+	if (_currentSpan != NULL) {
+		// Only the values of the body follow the head.
+		for (unsigned int k = 0; k < _currentSpan->count; ++k) {
+			if (_styleSheetOffset <= _currentSpanStart + _currentSpan->children[k]->offset) {
+				_currentSpan->children[k]->offset += block->length;
+			}
+		}
+	}
+	addToStatistic("generator.style-bytes", block->length);
+	destroyBuffer(block);
+}
+
+/**
+ * The branch of a conditional chosen by the current value of its condition,
+ * or NULL if it has no such branch (or if the condition is not a boolean).
+ */
+static Value * _chooseBranch(Conditional * conditional) {
+	Value scratch;
+	const Value * condition = _resolve(conditional->condition, &scratch);
+	if (condition == NULL || condition->type != BOOLEAN_VALUE) {
+		logError(_logger, "The condition of an if is not a boolean.");
+		_failed = true;
+		return NULL;
+	}
+	return condition->boolean ? conditional->consequent : conditional->alternative;
+}
+
+/**
+ * Evaluates an expression that depends on loop variables (everything else
+ * was folded while parsing) on a stack, and writes its result.
+ */
+static boolean _evaluate(const Evaluation * evaluation, Value * result) {
+	Value stack[evaluation->depth];
+	unsigned int top = 0;
+	for (unsigned int k = 0; k < evaluation->count; ++k) {
+		const Instruction * instruction = &evaluation->instructions[k];
+		boolean succeed = true;
+		if (instruction->type == FACTOR) {
+			const Value * operand = _resolve(instruction->operand, &stack[top]);
+			if (operand == NULL) {
+				logError(_logger, "An operand of an expression has no value.");
+				succeed = false;
+			}
+			else if (operand != &stack[top]) {
+				stack[top] = *operand;
+			}
+			++top;
+		}
+		else if (instruction->type == NEGATION || instruction->type == OPPOSITE) {
+			const Value operand = stack[top - 1];
+			succeed = computeValueOperation(instruction->type, &operand, NULL, &stack[top - 1]);
+		}
+		else {
+			const Value left = stack[top - 2];
+			const Value right = stack[top - 1];
+			succeed = computeValueOperation(instruction->type, &left, &right, &stack[--top - 1]);
+		}
+		if (!succeed) {
+			_failed = true;
+			return false;
+		}
+	}
+	*result = stack[0];
+	return true;
+}
+
+/**
+ * Generates an element of an array (or a child of an HTML element), preceded
+ * by a separator unless it's the first one (if "isFirst" is NULL, there are
+ * no separators). Loops and conditionals are spliced: they generate as many
+ * elements as iterations or branches they expand to, maybe none. A child of
+ * an HTML element is a line of its own: arrays are spliced too, and scalars
+ * are written as text.
+ */
+static void _generateElement(const unsigned int indentationLevel, Value * element, boolean * isFirst) {
+	if (element->type == FOR_VALUE) {
+		_generateLoop(indentationLevel, element->loop, isFirst);
+		return;
+	}
+	if (element->type == IF_VALUE || element->type == SLOT_VALUE) {
+		Value * resolved = element->type == IF_VALUE ? _chooseBranch(element->conditional) : _bindings[element->slot];
+		if (resolved != NULL) {
+			_generateElement(indentationLevel, resolved, isFirst);
+		}
+		return;
+	}
+	if (isFirst == NULL) {
+		_generateChild(indentationLevel, element);
+		return;
+	}
+	if (!*isFirst) {
+		_output(indentationLevel, ",");
+		_output(indentationLevel, "\n");
+	}
+	*isFirst = false;
+	_generateValue(indentationLevel + 1, element);
+}
+
+/**
+ * Generates a child of an HTML element (see "_generateElement"), one level
+ * deeper.
+ */
+static void _generateChild(const unsigned int indentationLevel, Value * child) {
+	if (child->type == ARRAY_VALUE) {
+		for (int i = 0; child->array != NULL && i < child->array->count; i++) {
+			if (child->array->elements[i] != NULL) {
+				_generateElement(indentationLevel, child->array->elements[i], NULL);
+			}
+		}
+		return;
+	}
+	if (child->type == OBJECT_VALUE || child->type == INCLUDE_VALUE) {
+		_generateValue(indentationLevel + 1, child);
+		if (child->type == OBJECT_VALUE && (child->object == NULL || child->object->element == NULL)) {
+			_output(0, "\n");
+		}
+		return;
+	}
+	_outputIndentation(indentationLevel + 1);
+	_generateText(child);
+	_output(0, "\n");
+}
+
+/**
+ * Splices the output of a partial, compiled once (see "compilePartial").
+ */
+static void _generateInclude(const unsigned int indentationLevel, Value * value) {
+	if (_isPreparing) {
+		// Partials are compiled with the parser, that is busy meanwhile.
+		_isDeferred = true;
+		return;
+	}
+	const Buffer * partial = compilePartial(value->string, indentationLevel);
+	if (partial == NULL) {
+		logError(_logger, "Cannot include the partial \"%s\".", value->string);
+		_failed = true;
+		return;
+	}
+	appendToBuffer(_outputBuffer, partial->bytes, partial->length);
+	++_includedPartials;
+}
+
+/**
+ * Expands a loop: the body (a template) is generated for each element of the
+ * iterable, with the variable of the loop bound to it, and streamed straight
+ * into the output. Nothing is built nor allocated per iteration. The output
+ * map doesn't record the spans inside a loop, since they don't match the
+ * tree of values.
+ */
+static void _generateLoop(const unsigned int indentationLevel, Loop * loop, boolean * isFirst) {
+	Value scratch;
+	const Value * iterable = _resolveIterable(loop, &scratch);
+	if (iterable == NULL || iterable->array == NULL) {
+		return;
+	}
+	// The variable may be bound already (e.g., a loop spliced from the iterable).
+	Value * outerBinding = _bindings[loop->slot];
+	OutputSpan * outerSpan = _currentSpan;
+	_currentSpan = NULL;
+	for (int k = 0; k < iterable->array->count; ++k) {
+		if (iterable->array->elements[k] != NULL) {
+			_bindings[loop->slot] = iterable->array->elements[k];
+			_generateElement(indentationLevel, loop->body, isFirst);
+		}
+	}
+	_bindings[loop->slot] = outerBinding;
+	_currentSpan = outerSpan;
+	addToStatistic("generator.loop-iterations", iterable->array->count);
+}
+
+/**
+ * Checks the iterations of a loop, like "_generateLoop" does.
+ */
+static void _checkLoop(Loop * loop) {
+	Value scratch;
+	const Value * iterable = _resolveIterable(loop, &scratch);
+	if (iterable == NULL || iterable->array == NULL) {
+		return;
+	}
+	Value * outerBinding = _bindings[loop->slot];
+	for (int k = 0; k < iterable->array->count; ++k) {
+		if (iterable->array->elements[k] != NULL) {
+			_bindings[loop->slot] = iterable->array->elements[k];
+			_checkValue(loop->body);
+		}
+	}
+	_bindings[loop->slot] = outerBinding;
+}
+
+/**
+ * Runs the checks of the generation over a value (see "checkProgram"): it's
+ * resolved as it would be generated, but nothing is written.
+ */
+static void _checkValue(Value * value) {
+	Value scratch;
+	const Value * resolved = _resolve(value, &scratch);
+	if (resolved == NULL) {
+		return;
+	}
+	switch (resolved->type) {
+		case OBJECT_VALUE:
+			for (int k = 0; resolved->object->entries != NULL && k < resolved->object->entries->count; ++k) {
+				const Entry * entry = resolved->object->entries->entries[k];
+				if (entry->style != NULL && entry->style->declarations == NULL) {
+					// Only the styles that use a loop variable are resolved while generating.
+					Buffer * declarations = createBuffer(128);
+					_serializeStyle(entry->style, declarations);
+					destroyBuffer(declarations);
+				}
+				_checkValue(entry->value);
+			}
+			break;
+		case ARRAY_VALUE:
+			for (int k = 0; resolved->array != NULL && k < resolved->array->count; ++k) {
+				_checkValue(resolved->array->elements[k]);
+			}
+			break;
+		case FOR_VALUE:
+			_checkLoop(resolved->loop);
+			break;
+		case INCLUDE_VALUE:
+			if (compilePartial(resolved->string, ELEMENT_INDENTATION_LEVEL) == NULL) {
+				logError(_logger, "Cannot include the partial \"%s\".", resolved->string);
+				_failed = true;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Resolves the iterable of a loop, that must be an array.
+ */
+static const Value * _resolveIterable(Loop * loop, Value * scratch) {
+	const Value * iterable = _resolve(loop->iterable, scratch);
+	if (iterable == NULL || iterable->type != ARRAY_VALUE) {
+		logError(_logger, "A loop can only iterate over an array.");
+		_failed = true;
+		return NULL;
+	}
+	return iterable;
+}
+
+/**
+ * Resolves the variables of the enclosing loops (and the conditionals and
+ * expressions that depend on them) to the value they stand for in the
+ * current iteration. The result of an expression is written in the scratch
+ * value.
+ */
+static const Value * _resolve(Value * value, Value * scratch) {
+	while (value != NULL && (value->type == SLOT_VALUE || value->type == IF_VALUE)) {
+		value = value->type == SLOT_VALUE ? _bindings[value->slot] : _chooseBranch(value->conditional);
+	}
+	if (value != NULL && value->type == EXPRESSION_VALUE) {
+		return _evaluate(value->evaluation, scratch) ? scratch : NULL;
+	}
+	return value;
+}
+
+/**
+ * Generates a value. Composite values shared by more than one parent are
+ * memoized, so each one is generated only once per indentation level (but
+ * not the ones that use a loop variable, since they change on each
+ * iteration).
+ */
 static void _generateValue(const unsigned int indentationLevel, Value * value) {
 	if (value == NULL) return;
 
+	const boolean isComposite = value->type == OBJECT_VALUE || value->type == ARRAY_VALUE;
+	if (isComposite && indentationLevel == ELEMENT_INDENTATION_LEVEL && _currentSpan == NULL && !_isPreparing) {
+		const PreparedElement * preparedElement = _findPreparedElement(value);
+		if (preparedElement != NULL && preparedElement->bytes != NULL) {
+			appendToBuffer(_outputBuffer, preparedElement->bytes, preparedElement->length);
+			_failed = _failed || preparedElement->failed;
+			addToStatistic("generator.prepared-bytes", preparedElement->length);
+			return;
+		}
+	}
+	OutputSpan * span = isComposite && _currentSpan != NULL ? _openSpan(indentationLevel, value) : NULL;
+	if (isComposite && !_isPreparing && 1 < value->references && value->freeSlots == 0) {
+		_generateSharedValue(indentationLevel, value);
+	}
+	else {
+		_generateValueContent(indentationLevel, value);
+	}
+	if (span != NULL) {
+		_closeSpan(span);
+	}
+}
+
+static void _generateValueContent(const unsigned int indentationLevel, Value * value) {
 	switch (value->type) {
 		case STRING_VALUE:
 			_output(indentationLevel, "%s", value->string);
 			break;
 		case INTEGER_VALUE:
-			_output(indentationLevel, "%d", value->integer);
+			_outputInteger(indentationLevel, value->integer);
 			break;
 		case REAL_VALUE:
-			_output(indentationLevel, "%f", value->real);
+			_outputReal(indentationLevel, value->real);
 			break;
 		case BOOLEAN_VALUE:
 			_output(indentationLevel, "%s", value->boolean ? "true" : "false");
@@ -337,7 +1043,10 @@ static void _generateValue(const unsigned int indentationLevel, Value * value) {
 			_output(indentationLevel, "null");
 			break;
 		case OBJECT_VALUE:
-			if (value->object != NULL) {
+			if (value->object != NULL && value->object->element != NULL) {
+				_generateHTMLElement(indentationLevel, value->object->element);
+			}
+			else if (value->object != NULL) {
 				_generateObject(indentationLevel, value->object);
 			}
 			break;
@@ -346,6 +1055,43 @@ static void _generateValue(const unsigned int indentationLevel, Value * value) {
 				_generateArray(indentationLevel, value->array);
 			}
 			break;
+		case INCLUDE_VALUE:
+			_generateInclude(indentationLevel, value);
+			break;
+		case FOR_VALUE: {
+			// Alone (not spliced into an array), a loop generates an array.
+			boolean isFirst = true;
+			_output(indentationLevel, "[\n");
+			_generateLoop(indentationLevel, value->loop, &isFirst);
+			if (!isFirst) {
+				_output(indentationLevel, "\n");
+			}
+			_output(indentationLevel, "]");
+			break;
+		}
+		case IF_VALUE: {
+			Value * branch = _chooseBranch(value->conditional);
+			if (branch != NULL) {
+				_generateValue(indentationLevel, branch);
+			}
+			else {
+				_output(indentationLevel, "null");
+			}
+			break;
+		}
+		case SLOT_VALUE:
+			_generateValue(indentationLevel, _bindings[value->slot]);
+			break;
+		case EXPRESSION_VALUE: {
+			Value result;
+			if (_evaluate(value->evaluation, &result)) {
+				_generateValueContent(indentationLevel, &result);
+			}
+			else {
+				_output(indentationLevel, "null");
+			}
+			break;
+		}
 		default:
 			logError(_logger, "Unknown value type: %d", value->type);
 			break;
@@ -355,20 +1101,28 @@ static void _generateValue(const unsigned int indentationLevel, Value * value) {
 static void _generateObject(const unsigned int indentationLevel, Object * object) {
 	if (object == NULL) return;
 
+	// Only an object that is not an element gets here (see "createObject"),
+	// so it has no style (nor elements without key, but only the page has
+	// them).
 	_output(indentationLevel, "{\n");
+	boolean isFirst = true;
 	if (object->entries != NULL) {
 		for (int i = 0; i < object->entries->count; i++) {
 			Entry * entry = object->entries->entries[i];
-			if (entry != NULL) {
-				_output(indentationLevel + 1, "\"%s\": ", entry->key);
-				_generateValue(indentationLevel + 1, entry->value);
-				if (i < object->entries->count - 1) {
+			if (entry != NULL && entry->key != NULL && entry->value != NULL) {
+				if (!isFirst) {
 					_output(indentationLevel, ",");
+					_output(indentationLevel, "\n");
 				}
-				_output(indentationLevel, "\n");
+				isFirst = false;
+				_output(indentationLevel + 1, "\"%s\": ", entry->key);
+				_generateValue(indentationLevel + 1, entry->value);
 			}
 		}
 	}
+	if (!isFirst) {
+		_output(indentationLevel, "\n");
+	}
 	_output(indentationLevel, "}");
 }
 
@@ -376,16 +1130,16 @@ static void _generateArray(const unsigned int indentationLevel, Array * array) {
 	if (array == NULL) return;
 
 	_output(indentationLevel, "[\n");
+	boolean isFirst = true;
 	for (int i = 0; i < array->count; i++) {
 		Value * value = array->elements[i];
 		if (value != NULL) {
-			_generateValue(indentationLevel + 1, value);
-			if (i < array->count - 1) {
-				_output(indentationLevel, ",");
-			}
-			_output(indentationLevel, "\n");
+			_generateElement(indentationLevel, value, &isFirst);
 		}
 	}
+	if (!isFirst) {
+		_output(indentationLevel, "\n");
+	}
 	_output(indentationLevel, "]");
 }
 
@@ -393,8 +1147,206 @@ static void _generateArray(const unsigned int indentationLevel, Array * array) {
 
 void generate(CompilerState * compilerState) {
 	logDebugging(_logger, "Generating final output...");
+	_outputBuffer = compilerState->output;
+	_failed = false;
+	_includedPartials = 0;
+	_hasStyleSheetOffset = false;
+	_inlineStyles = compilerState->configuration.inlineStyles;
+	const size_t initialLength = _outputBuffer->length;
+	const double start = monotonicTime();
 	_generatePrologue();
 	_generateProgram(compilerState->abstractSyntaxtTree);
-	_generateEpilogue(compilerState->value);
+	_spliceStyleSheet();
+	// The rules of the elements generated ahead are kept until the page is.
+	clearStyleSheet(_styleSheet);
+	addToStatistic("generator.output-bytes", _outputBuffer->length - initialLength);
+	addToStatistic("generator.time", monotonicTime() - start);
+	compilerState->includedPartials = _includedPartials;
+	if (_failed) {
+		compilerState->succeed = false;
+	}
+	_outputBuffer = NULL;
+	_resetEmissions();
 	logDebugging(_logger, "Generation is done.");
 }
+
+void checkProgram(CompilerState * compilerState) {
+	const Program * program = compilerState->abstractSyntaxtTree;
+	_failed = false;
+	if (program != NULL && program->content != NULL) {
+		_checkValue(program->content);
+	}
+	if (_failed) {
+		compilerState->succeed = false;
+	}
+}
+
+OutputSpan * generateWithOutputMap(CompilerState * compilerState) {
+	OutputSpan * outputMap = _createSpan(NULL, compilerState->output->length, 0, 0);
+	_currentSpan = outputMap;
+	_currentSpanStart = outputMap->offset;
+	generate(compilerState);
+	outputMap->length = compilerState->output->length - outputMap->offset;
+	_currentSpan = NULL;
+	_currentSpanStart = 0;
+	return outputMap;
+}
+
+boolean regenerateOutputSpan(OutputSpan * outputMap, const Value * previousValue, Value * value, Buffer * output, OutputPatch * patch) {
+	if (previousValue == NULL || value == NULL || (value->type != OBJECT_VALUE && value->type != ARRAY_VALUE)) {
+		return false;
+	}
+	unsigned int count = 0;
+	OutputSpan * span = _findSpan(outputMap, previousValue, &count);
+	if (count != 1 || span == outputMap) {
+		return false;
+	}
+	size_t offset = 0;
+	for (const OutputSpan * current = span; current != NULL; current = current->parent) {
+		offset += current->offset;
+	}
+	// Generates the value alone, into a scratch buffer.
+	Buffer * scratch = createBuffer(span->length + 64);
+	OutputSpan * scratchMap = _createSpan(NULL, 0, 0, 0);
+	_outputBuffer = scratch;
+	_currentSpan = scratchMap;
+	_currentSpanStart = 0;
+	_failed = false;
+	_generateValue(span->indentationLevel, value);
+	_outputBuffer = NULL;
+	_currentSpan = NULL;
+	_resetEmissions();
+	// A new rule would need a class that the style sheet of the output lacks.
+	const boolean isAlone = !_failed && countStyleRules(_styleSheet) == 0;
+	clearStyleSheet(_styleSheet);
+	if (!isAlone) {
+		destroyBuffer(scratch);
+		releaseOutputMap(scratchMap);
+		return false;
+	}
+
+	// Splices the new output, shifting the tail.
+	const size_t removedLength = span->length;
+	const size_t insertedLength = scratch->length;
+	reserveBuffer(output, insertedLength);
+	memmove(output->bytes + offset + insertedLength, output->bytes + offset + removedLength, output->length - offset - removedLength);
+	memcpy(output->bytes + offset, scratch->bytes, insertedLength);
+	output->length = output->length + insertedLength - removedLength;
+	destroyBuffer(scratch);
+
+	// Replaces the span, and resizes its ancestors.
+	OutputSpan * replacement = scratchMap->children[0];
+	replacement->offset = span->offset;
+	replacement->parent = span->parent;
+	replacement->index = span->index;
+	span->parent->children[span->index] = replacement;
+	scratchMap->count = 0;
+	releaseOutputMap(scratchMap);
+	releaseOutputMap(span);
+	for (OutputSpan * current = replacement; current->parent != NULL; current = current->parent) {
+		OutputSpan * parent = current->parent;
+		parent->value = NULL;
+		for (unsigned int k = current->index + 1; k < parent->count; ++k) {
+			parent->children[k]->offset += insertedLength;
+			parent->children[k]->offset -= removedLength;
+		}
+		parent->length = parent->length + insertedLength - removedLength;
+	}
+	patch->offset = offset;
+	patch->removedLength = removedLength;
+	patch->insertedLength = insertedLength;
+	addToStatistic("generator.regenerated-bytes", insertedLength);
+	return true;
+}
+
+boolean generateFragment(Value * value, const unsigned int indentationLevel, Buffer * output) {
+	// Emissions are offsets of the current output, so the fragment gets its own.
+	Buffer * outerBuffer = _outputBuffer;
+	Emission * outerEmissions = _emissions;
+	const unsigned int outerEmissionsCapacity = _emissionsCapacity;
+	const unsigned int outerEmissionsCount = _emissionsCount;
+	OutputSpan * outerSpan = _currentSpan;
+	const size_t outerSpanStart = _currentSpanStart;
+	const boolean outerFailed = _failed;
+	const boolean outerInlineStyles = _inlineStyles;
+	_outputBuffer = output;
+	_emissions = NULL;
+	_emissionsCapacity = 0;
+	_emissionsCount = 0;
+	_currentSpan = NULL;
+	_failed = false;
+	// The output of a partial is reused by every page (see "compilePartial"),
+	// so it can't use the style sheet of one of them.
+	_inlineStyles = _inlineStyles || !_isPreparing;
+	_generateValue(indentationLevel, value);
+	const boolean succeed = !_failed;
+	free(_emissions);
+	_outputBuffer = outerBuffer;
+	_emissions = outerEmissions;
+	_emissionsCapacity = outerEmissionsCapacity;
+	_emissionsCount = outerEmissionsCount;
+	_currentSpan = outerSpan;
+	_currentSpanStart = outerSpanStart;
+	_failed = outerFailed;
+	_inlineStyles = outerInlineStyles;
+	return succeed;
+}
+
+void prepareGeneration(const CompilerConfiguration * configuration) {
+	_inlineStyles = configuration->inlineStyles;
+	clearStyleSheet(_styleSheet);
+}
+
+void prepareElement(Value * element) {
+	PreparedElement * preparedElement = _findPreparedElement(element);
+	if (preparedElement != NULL) {
+		++preparedElement->references;
+		return;
+	}
+	Buffer * output = createBuffer(1024);
+	_isPreparing = true;
+	_isDeferred = false;
+	const boolean succeed = generateFragment(element, ELEMENT_INDENTATION_LEVEL, output);
+	_isPreparing = false;
+	_insertPreparedElement((PreparedElement) {
+		.value = element,
+		.bytes = _isDeferred ? NULL : output->bytes,
+		.length = _isDeferred ? 0 : output->length,
+		.failed = !succeed,
+		.references = 1
+	});
+	if (_isDeferred) {
+		destroyBuffer(output);
+	}
+	else {
+		// The table takes the bytes.
+		free(output);
+		addToStatistic("generator.prepared-elements", 1);
+	}
+}
+
+void releasePreparedElements(void) {
+	for (unsigned int k = 0; k < _preparedElementsCapacity; ++k) {
+		PreparedElement * preparedElement = &_preparedElements[k];
+		if (preparedElement->value != NULL) {
+			for (unsigned int r = 0; r < preparedElement->references; ++r) {
+				releaseValue(preparedElement->value);
+			}
+			free(preparedElement->bytes);
+			*preparedElement = (PreparedElement) { 0 };
+		}
+	}
+	_preparedElementsCount = 0;
+	clearStyleSheet(_styleSheet);
+}
+
+void releaseOutputMap(OutputSpan * outputMap) {
+	if (outputMap == NULL) {
+		return;
+	}
+	for (unsigned int k = 0; k < outputMap->count; ++k) {
+		releaseOutputMap(outputMap->children[k]);
+	}
+	free(outputMap->children);
+	free(outputMap);
+}
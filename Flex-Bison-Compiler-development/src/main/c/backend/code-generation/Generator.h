@@ -2,8 +2,13 @@
 #define GENERATOR_HEADER
 
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/ElementSchema.h"
+#include "../../shared/Buffer.h"
 #include "../../shared/CompilerState.h"
+#include "../../shared/Hash.h"
 #include "../../shared/Logger.h"
+#include "../../shared/NumberFormat.h"
+#include "../../shared/Statistics.h"
 #include "../../shared/String.h"
 #include <stdarg.h>
 #include <stdio.h>
@@ -15,8 +20,106 @@ void initializeGeneratorModule();
 void shutdownGeneratorModule();
 
 /**
- * Generates the final output using the current compiler state.
+ * The output map of a generation: a tree with the span of the output where
+ * each composite value (object or array) was generated, and the value. The
+ * children of a span are the spans of the composite values generated inside
+ * of it, in order. Offsets are relative to the offset of the parent (the root spans the
+ * entire output), so a change only shifts the spans that follow it inside
+ * each one of its ancestors.
+ */
+typedef struct OutputSpan OutputSpan;
+
+struct OutputSpan {
+	size_t offset;
+	size_t length;
+	unsigned int indentationLevel;
+	const Value * value;
+	OutputSpan * parent;
+	unsigned int index;
+	OutputSpan ** children;
+	unsigned int count;
+	unsigned int capacity;
+};
+
+/**
+ * A change of the output: the bytes in the range [offset, offset + removed)
+ * were replaced by the bytes in [offset, offset + inserted).
+ */
+typedef struct {
+	size_t offset;
+	size_t removedLength;
+	size_t insertedLength;
+} OutputPatch;
+
+/**
+ * Generates the final output using the current compiler state, appending it
+ * to the output buffer of that state.
  */
 void generate(CompilerState * compilerState);
 
+/**
+ * Runs the checks of the generation over the content of a page parsed with
+ * "--check", without generating anything: loops over values that are not
+ * arrays, conditions that are not booleans, expressions and styles without a
+ * value in some iteration, and partials that cannot be included (each one is
+ * compiled, once). If any fails, the compiler state doesn't succeed.
+ */
+void checkProgram(CompilerState * compilerState);
+
+/**
+ * Like "generate", but also records the output map, that must be released
+ * with "releaseOutputMap".
+ */
+OutputSpan * generateWithOutputMap(CompilerState * compilerState);
+
+/**
+ * Replaces the output of a single composite value (the previous one) with the
+ * one of a new value, without generating the rest again. The new value is
+ * generated at the same indentation level, spliced into the output (shifting
+ * its tail), and the map is updated (the values of the ancestors of the span
+ * are forgotten, since their output changed). Returns false, and changes
+ * nothing, if the previous value was not generated exactly once (e.g., it's
+ * repeated, or not composite), or if the new one cannot be generated alone
+ * (its styles need classes that the style sheet of the output lacks, or its
+ * generation fails).
+ */
+boolean regenerateOutputSpan(OutputSpan * outputMap, const Value * previousValue, Value * value, Buffer * output, OutputPatch * patch);
+
+/**
+ * Generates a value alone (e.g., a partial) at an indentation level, and
+ * appends it to the output buffer. It can be called while a generation is in
+ * progress. Returns false if the value includes a partial that cannot be
+ * compiled.
+ */
+boolean generateFragment(Value * value, const unsigned int indentationLevel, Buffer * output);
+
+/**
+ * Starts the generation of a page whose elements are generated ahead (see
+ * "prepareElement"), so they take the styles of the configuration, and share
+ * the style sheet of the page.
+ */
+void prepareGeneration(const CompilerConfiguration * configuration);
+
+/**
+ * Generates ahead an element of the body of a page (at the indentation
+ * level of those elements), so the next "generate" copies its output instead
+ * of generating it again. It's meant to run on a thread of its own while the
+ * rest of the source is parsed (see "pipeline" in the configuration), so
+ * nothing else can be generated meanwhile; an element that includes a
+ * partial is left to "generate". The generator takes a reference to the
+ * element.
+ */
+void prepareElement(Value * element);
+
+/**
+ * Drops the elements generated ahead, releasing their references (once the
+ * output that uses them was generated), and the styles they declared.
+ */
+void releasePreparedElements(void);
+
+/**
+ * Releases an output map.
+ */
+void releaseOutputMap(OutputSpan * outputMap);
+
 #endif
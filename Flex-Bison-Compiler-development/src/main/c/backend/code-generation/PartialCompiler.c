@@ -0,0 +1,341 @@
+#include "PartialCompiler.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * A partial source, by name: the hash of its content, and when it was read
+ * (so it's read again only if it changes).
+ */
+typedef struct {
+	char * name;
+	struct timespec modificationTime;
+	off_t size;
+	uint64_t hash;
+} Partial;
+
+/**
+ * A partial spliced into another one, and the hash of its content then.
+ */
+typedef struct {
+	const char * name;
+	uint64_t hash;
+} Dependency;
+
+/**
+ * The output of a partial, by the hash of its content and the indentation
+ * level where it was generated. It's valid while every partial spliced into
+ * it (transitively) keeps the same content.
+ */
+typedef struct {
+	uint64_t hash;
+	unsigned int indentationLevel;
+	Buffer * output;
+	Dependency * dependencies;
+	unsigned int count;
+} CompiledPartial;
+
+/**
+ * A partial being compiled, and the partials spliced into it so far.
+ */
+typedef struct {
+	const char * name;
+	Dependency * dependencies;
+	unsigned int count;
+	unsigned int capacity;
+} Inclusion;
+
+static const char * _directory = ".";
+static Logger * _logger = NULL;
+static Partial * _partials = NULL;
+static unsigned int _partialsCount = 0;
+static unsigned int _partialsCapacity = 0;
+static CompiledPartial * _compiledPartials = NULL;
+static unsigned int _compiledPartialsCount = 0;
+static unsigned int _compiledPartialsCapacity = 0;
+
+// The partials being compiled, from the outermost one (to detect cycles).
+static Inclusion * _chain = NULL;
+static unsigned int _chainDepth = 0;
+static unsigned int _chainCapacity = 0;
+
+void initializePartialCompilerModule() {
+	_logger = createLogger("PartialCompiler");
+}
+
+void shutdownPartialCompilerModule() {
+	for (unsigned int k = 0; k < _partialsCount; ++k) {
+		free(_partials[k].name);
+	}
+	for (unsigned int k = 0; k < _compiledPartialsCount; ++k) {
+		destroyBuffer(_compiledPartials[k].output);
+		free(_compiledPartials[k].dependencies);
+	}
+	free(_partials);
+	free(_compiledPartials);
+	free(_chain);
+	_partials = NULL;
+	_compiledPartials = NULL;
+	_chain = NULL;
+	_partialsCount = _partialsCapacity = 0;
+	_compiledPartialsCount = _compiledPartialsCapacity = 0;
+	_chainDepth = _chainCapacity = 0;
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _addDependency(Inclusion * inclusion, const char * name, const uint64_t hash);
+static CompiledPartial * _compile(const char * name, const uint64_t hash, Buffer * source, const unsigned int indentationLevel);
+static CompiledPartial * _findCompiledPartial(const uint64_t hash, const unsigned int indentationLevel);
+static Partial * _findPartial(const char * name);
+static boolean _isInChain(const char * name);
+static boolean _isSafeName(const char * name);
+static Partial * _loadPartial(const char * name, const boolean mustRead, Buffer ** source);
+static void _logCycle(const char * name);
+
+/**
+ * Records that a partial was spliced into the one being compiled (once).
+ */
+static void _addDependency(Inclusion * inclusion, const char * name, const uint64_t hash) {
+	for (unsigned int k = 0; k < inclusion->count; ++k) {
+		if (inclusion->dependencies[k].name == name) {
+			return;
+		}
+	}
+	if (inclusion->count == inclusion->capacity) {
+		inclusion->capacity = inclusion->capacity == 0 ? 4 : 2 * inclusion->capacity;
+		inclusion->dependencies = realloc(inclusion->dependencies, inclusion->capacity * sizeof(Dependency));
+	}
+	inclusion->dependencies[inclusion->count++] = (Dependency) {
+		.name = name,
+		.hash = hash
+	};
+}
+
+/**
+ * Parses and generates a partial whose content is in the source buffer, and
+ * memoizes its output.
+ */
+static CompiledPartial * _compile(const char * name, const uint64_t hash, Buffer * source, const unsigned int indentationLevel) {
+	Value * value = NULL;
+	if (parseValue(source->bytes, source->length, &value) != ACCEPT) {
+		logError(_logger, "The partial \"%s\" is not a single value.", name);
+		return NULL;
+	}
+	const char * pageElement = findPageElement(value);
+	if (pageElement != NULL) {
+		logError(_logger, "The partial \"%s\" cannot have a \"%s\" element.", name, pageElement);
+		releaseValue(value);
+		return NULL;
+	}
+	if (_chainDepth == _chainCapacity) {
+		_chainCapacity = _chainCapacity == 0 ? 8 : 2 * _chainCapacity;
+		_chain = realloc(_chain, _chainCapacity * sizeof(Inclusion));
+	}
+	_chain[_chainDepth++] = (Inclusion) {
+		.name = name,
+		.dependencies = NULL,
+		.count = 0,
+		.capacity = 0
+	};
+	Buffer * output = createBuffer(source->length + 256);
+	const boolean succeed = generateFragment(value, indentationLevel, output);
+	const Inclusion inclusion = _chain[--_chainDepth];
+	releaseValue(value);
+	if (!succeed) {
+		free(inclusion.dependencies);
+		destroyBuffer(output);
+		return NULL;
+	}
+	if (_compiledPartialsCount == _compiledPartialsCapacity) {
+		_compiledPartialsCapacity = _compiledPartialsCapacity == 0 ? 16 : 2 * _compiledPartialsCapacity;
+		_compiledPartials = realloc(_compiledPartials, _compiledPartialsCapacity * sizeof(CompiledPartial));
+	}
+	CompiledPartial * compiledPartial = &_compiledPartials[_compiledPartialsCount++];
+	*compiledPartial = (CompiledPartial) {
+		.hash = hash,
+		.indentationLevel = indentationLevel,
+		.output = output,
+		.dependencies = inclusion.dependencies,
+		.count = inclusion.count
+	};
+	addToStatistic("partials.compilations", 1);
+	return compiledPartial;
+}
+
+/**
+ * Finds the memoized output of a partial content at an indentation level, or
+ * returns NULL. Outputs that spliced a partial that changed since then are
+ * dropped.
+ */
+static CompiledPartial * _findCompiledPartial(const uint64_t hash, const unsigned int indentationLevel) {
+	for (unsigned int k = 0; k < _compiledPartialsCount; ++k) {
+		CompiledPartial * compiledPartial = &_compiledPartials[k];
+		if (compiledPartial->hash != hash || compiledPartial->indentationLevel != indentationLevel) {
+			continue;
+		}
+		boolean isValid = true;
+		for (unsigned int j = 0; j < compiledPartial->count && isValid; ++j) {
+			const Partial * dependency = _loadPartial(compiledPartial->dependencies[j].name, false, NULL);
+			isValid = dependency != NULL && dependency->hash == compiledPartial->dependencies[j].hash;
+		}
+		if (isValid) {
+			return compiledPartial;
+		}
+		destroyBuffer(compiledPartial->output);
+		free(compiledPartial->dependencies);
+		_compiledPartials[k] = _compiledPartials[--_compiledPartialsCount];
+		return NULL;
+	}
+	return NULL;
+}
+
+/**
+ * Finds a partial by name, creating it if needed.
+ */
+static Partial * _findPartial(const char * name) {
+	for (unsigned int k = 0; k < _partialsCount; ++k) {
+		if (strcmp(_partials[k].name, name) == 0) {
+			return &_partials[k];
+		}
+	}
+	if (_partialsCount == _partialsCapacity) {
+		_partialsCapacity = _partialsCapacity == 0 ? 16 : 2 * _partialsCapacity;
+		_partials = realloc(_partials, _partialsCapacity * sizeof(Partial));
+	}
+	Partial * partial = &_partials[_partialsCount++];
+	partial->name = concatenate(1, name);
+	partial->modificationTime = (struct timespec) {0, 0};
+	partial->size = -1;
+	partial->hash = 0;
+	return partial;
+}
+
+/**
+ * Whether the partial is being compiled (i.e., including it again would never
+ * end).
+ */
+static boolean _isInChain(const char * name) {
+	for (unsigned int k = 0; k < _chainDepth; ++k) {
+		if (strcmp(_chain[k].name, name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Whether the name stays inside of the directory of the partials.
+ */
+static boolean _isSafeName(const char * name) {
+	return name[0] != '\0' && name[0] != '/' && strstr(name, "..") == NULL;
+}
+
+/**
+ * Finds a partial by name, and reads it again if it changed on disk (or if
+ * it must be read), returning its content if the source is not NULL. Returns
+ * NULL if the partial cannot be read. The partial may move on the next call,
+ * but not its name.
+ */
+static Partial * _loadPartial(const char * name, const boolean mustRead, Buffer ** source) {
+	char * path = concatenate(3, _directory, "/", name);
+	struct stat status;
+	if (stat(path, &status) != 0 || !S_ISREG(status.st_mode)) {
+		logError(_logger, "Cannot find the partial \"%s\".", path);
+		free(path);
+		return NULL;
+	}
+	Partial * partial = _findPartial(name);
+	const boolean isModified = partial->modificationTime.tv_sec != status.st_mtim.tv_sec
+		|| partial->modificationTime.tv_nsec != status.st_mtim.tv_nsec
+		|| partial->size != status.st_size;
+	if (mustRead || isModified) {
+		FILE * file = fopen(path, "rb");
+		if (file == NULL) {
+			logError(_logger, "Cannot read the partial \"%s\".", path);
+			free(path);
+			return NULL;
+		}
+		Buffer * content = createBuffer(status.st_size + 1);
+		appendStreamToBuffer(content, file);
+		fclose(file);
+		partial->modificationTime = status.st_mtim;
+		partial->size = status.st_size;
+		partial->hash = hashBytes(content->bytes, content->length, 0);
+		if (source != NULL) {
+			*source = content;
+		}
+		else {
+			destroyBuffer(content);
+		}
+	}
+	free(path);
+	return partial;
+}
+
+/**
+ * Logs the includes that lead back to a partial.
+ */
+static void _logCycle(const char * name) {
+	Buffer * cycle = createBuffer(256);
+	for (unsigned int k = 0; k < _chainDepth; ++k) {
+		appendToBuffer(cycle, _chain[k].name, strlen(_chain[k].name));
+		appendToBuffer(cycle, " -> ", 4);
+	}
+	appendToBuffer(cycle, name, strlen(name));
+	appendToBuffer(cycle, "", 1);
+	logError(_logger, "The partials include each other: %s", cycle->bytes);
+	destroyBuffer(cycle);
+}
+
+/* PUBLIC FUNCTIONS */
+
+void setPartialDirectory(const char * directory) {
+	_directory = directory == NULL ? "." : directory;
+}
+
+const Buffer * compilePartial(const char * name, const unsigned int indentationLevel) {
+	if (!_isSafeName(name)) {
+		logError(_logger, "The partial \"%s\" is outside of \"%s\".", name, _directory);
+		return NULL;
+	}
+	if (_isInChain(name)) {
+		_logCycle(name);
+		return NULL;
+	}
+	Buffer * source = NULL;
+	Partial * partial = _loadPartial(name, false, &source);
+	if (partial == NULL) {
+		return NULL;
+	}
+	const char * partialName = partial->name;
+	uint64_t hash = partial->hash;
+	CompiledPartial * compiledPartial = _findCompiledPartial(hash, indentationLevel);
+	if (compiledPartial == NULL) {
+		if (source == NULL) {
+			// Known content, but never generated at this indentation level.
+			partial = _loadPartial(name, true, &source);
+			if (partial == NULL) {
+				return NULL;
+			}
+			hash = partial->hash;
+		}
+		compiledPartial = _compile(partialName, hash, source, indentationLevel);
+	}
+	destroyBuffer(source);
+	if (compiledPartial == NULL) {
+		return NULL;
+	}
+	if (0 < _chainDepth) {
+		// The partial that includes this one depends on it, and on its partials.
+		Inclusion * inclusion = &_chain[_chainDepth - 1];
+		_addDependency(inclusion, partialName, hash);
+		for (unsigned int k = 0; k < compiledPartial->count; ++k) {
+			_addDependency(inclusion, compiledPartial->dependencies[k].name, compiledPartial->dependencies[k].hash);
+		}
+	}
+	addToStatistic("partials.splices", 1);
+	return compiledPartial->output;
+}
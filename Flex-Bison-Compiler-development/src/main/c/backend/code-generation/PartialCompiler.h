@@ -0,0 +1,42 @@
+#ifndef PARTIAL_COMPILER_HEADER
+#define PARTIAL_COMPILER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "../../shared/Buffer.h"
+#include "../../shared/Hash.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Statistics.h"
+#include "../../shared/String.h"
+#include "../../shared/Type.h"
+#include "Generator.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/** Initialize module's internal state. */
+void initializePartialCompilerModule();
+
+/** Shutdown module's internal state. */
+void shutdownPartialCompilerModule();
+
+/**
+ * Sets the directory where the partials are looked up (by default, the
+ * current one).
+ */
+void setPartialDirectory(const char * directory);
+
+/**
+ * Compiles a partial (a source with a single value, included by other sources
+ * with 'include "name"') at an indentation level, and returns its output,
+ * that remains valid until the module is shutdown. The output is memoized by
+ * the hash of the content of the partial, so each one is parsed and generated
+ * once, and then spliced as-is in every source that includes it.
+ *
+ * Returns NULL if the partial cannot be read or compiled, or if it includes
+ * itself (directly or through other partials).
+ */
+const Buffer * compilePartial(const char * name, const unsigned int indentationLevel);
+
+#endif
@@ -0,0 +1,239 @@
+#include "StyleSheet.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * A rule: the class name, and the declarations it stands for.
+ */
+typedef struct {
+	uint64_t hash;
+	char * declarations;
+	size_t length;
+	char className[16];
+} StyleRule;
+
+struct StyleSheet {
+	// The rules, in the order they were declared.
+	StyleRule * rules;
+	unsigned int count;
+	unsigned int capacity;
+
+	// The index of each rule plus one, by hash (open-addressing, linear
+	// probing), where zero is an empty slot.
+	unsigned int * slots;
+	unsigned int slotsCapacity;
+};
+
+// The properties whose numbers have no unit (every other number is a length,
+// in pixels).
+static const char * _unitlessProperties[] = { "flex", "opacity", "order", "zoom" };
+
+static Logger * _logger = NULL;
+
+void initializeStyleSheetModule() {
+	_logger = createLogger("StyleSheet");
+}
+
+void shutdownStyleSheetModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _appendNormalizedString(Buffer * buffer, const char * string, const size_t length);
+static void _appendUnit(Buffer * buffer, const char * key);
+static void _insertSlot(StyleSheet * styleSheet, const unsigned int index);
+static void _rehash(StyleSheet * styleSheet);
+
+/**
+ * Appends a string value without leading nor trailing whitespace, with every
+ * run of whitespace collapsed to a single space, and with the hexadecimal
+ * colors in lowercase, so equivalent values are written the same way.
+ */
+static void _appendNormalizedString(Buffer * buffer, const char * string, const size_t length) {
+	boolean isFirst = true;
+	boolean pendingSpace = false;
+	boolean inColor = false;
+	for (const char * character = string; character < string + length; ++character) {
+		if (isspace((unsigned char) *character)) {
+			pendingSpace = true;
+			inColor = false;
+			continue;
+		}
+		if (pendingSpace && !isFirst) {
+			appendToBuffer(buffer, " ", 1);
+		}
+		isFirst = false;
+		pendingSpace = false;
+		inColor = *character == '#' || (inColor && isxdigit((unsigned char) *character));
+		const char normalized = inColor ? tolower((unsigned char) *character) : *character;
+		appendToBuffer(buffer, &normalized, 1);
+	}
+}
+
+/**
+ * Appends the unit of a number, unless the property has none.
+ */
+static void _appendUnit(Buffer * buffer, const char * key) {
+	for (size_t k = 0; k < sizeof(_unitlessProperties) / sizeof(_unitlessProperties[0]); ++k) {
+		if (strcmp(key, _unitlessProperties[k]) == 0) {
+			return;
+		}
+	}
+	appendToBuffer(buffer, "px", 2);
+}
+
+/**
+ * Inserts the index of a rule in the table, without checking its load.
+ */
+static void _insertSlot(StyleSheet * styleSheet, const unsigned int index) {
+	const unsigned int mask = styleSheet->slotsCapacity - 1;
+	unsigned int k = styleSheet->rules[index].hash & mask;
+	while (styleSheet->slots[k] != 0) {
+		k = (k + 1) & mask;
+	}
+	styleSheet->slots[k] = index + 1;
+}
+
+/**
+ * Doubles the capacity of the table, keeping the load under a half.
+ */
+static void _rehash(StyleSheet * styleSheet) {
+	free(styleSheet->slots);
+	styleSheet->slotsCapacity = styleSheet->slotsCapacity == 0 ? 64 : 2 * styleSheet->slotsCapacity;
+	styleSheet->slots = calloc(styleSheet->slotsCapacity, sizeof(unsigned int));
+	for (unsigned int k = 0; k < styleSheet->count; ++k) {
+		_insertSlot(styleSheet, k);
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+StyleSheet * createStyleSheet() {
+	StyleSheet * styleSheet = calloc(1, sizeof(StyleSheet));
+	_rehash(styleSheet);
+	return styleSheet;
+}
+
+void destroyStyleSheet(StyleSheet * styleSheet) {
+	if (styleSheet == NULL) {
+		return;
+	}
+	clearStyleSheet(styleSheet);
+	free(styleSheet->rules);
+	free(styleSheet->slots);
+	free(styleSheet);
+}
+
+void clearStyleSheet(StyleSheet * styleSheet) {
+	for (unsigned int k = 0; k < styleSheet->count; ++k) {
+		free(styleSheet->rules[k].declarations);
+	}
+	styleSheet->count = 0;
+	memset(styleSheet->slots, 0, styleSheet->slotsCapacity * sizeof(unsigned int));
+}
+
+const char * addStyleRule(StyleSheet * styleSheet, const char * declarations, const size_t length, const uint64_t hash) {
+	const unsigned int mask = styleSheet->slotsCapacity - 1;
+	for (unsigned int k = hash & mask; styleSheet->slots[k] != 0; k = (k + 1) & mask) {
+		StyleRule * rule = &styleSheet->rules[styleSheet->slots[k] - 1];
+		if (rule->hash == hash && rule->length == length && memcmp(rule->declarations, declarations, length) == 0) {
+			addToStatistic("styles.deduplicated", 1);
+			return rule->className;
+		}
+	}
+	if (styleSheet->count == styleSheet->capacity) {
+		styleSheet->capacity = styleSheet->capacity == 0 ? 16 : 2 * styleSheet->capacity;
+		styleSheet->rules = realloc(styleSheet->rules, styleSheet->capacity * sizeof(StyleRule));
+	}
+	StyleRule * rule = &styleSheet->rules[styleSheet->count];
+	rule->hash = hash;
+	rule->length = length;
+	rule->declarations = malloc(length);
+	memcpy(rule->declarations, declarations, length);
+	// The shortest name: the index of the rule, in base 36.
+	static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+	char reversed[16];
+	unsigned int size = 0;
+	for (unsigned int index = styleSheet->count; size == 0 || 0 < index; index /= 36) {
+		reversed[size++] = digits[index % 36];
+	}
+	rule->className[0] = 's';
+	for (unsigned int k = 0; k < size; ++k) {
+		rule->className[1 + k] = reversed[size - 1 - k];
+	}
+	rule->className[1 + size] = '\0';
+	if (styleSheet->slotsCapacity < 2 * ++styleSheet->count) {
+		_rehash(styleSheet);
+	}
+	else {
+		_insertSlot(styleSheet, styleSheet->count - 1);
+	}
+	addToStatistic("styles.rules", 1);
+	return rule->className;
+}
+
+unsigned int countStyleRules(const StyleSheet * styleSheet) {
+	return styleSheet->count;
+}
+
+void appendStyleSheet(const StyleSheet * styleSheet, Buffer * buffer, const char * indentation) {
+	const size_t indentationLength = strlen(indentation);
+	for (unsigned int k = 0; k < styleSheet->count; ++k) {
+		const StyleRule * rule = &styleSheet->rules[k];
+		appendToBuffer(buffer, indentation, indentationLength);
+		appendToBuffer(buffer, ".", 1);
+		appendToBuffer(buffer, rule->className, strlen(rule->className));
+		appendToBuffer(buffer, "{", 1);
+		appendToBuffer(buffer, rule->declarations, rule->length);
+		appendToBuffer(buffer, "}\n", 2);
+	}
+}
+
+void appendStyleAttribute(Buffer * buffer, const char * declarations, const size_t length) {
+	appendToBuffer(buffer, " style=\"", 8);
+	size_t start = 0;
+	for (size_t k = 0; k < length; ++k) {
+		const char * entity = declarations[k] == '"' ? "&quot;" : declarations[k] == '&' ? "&amp;" : NULL;
+		if (entity != NULL) {
+			appendToBuffer(buffer, declarations + start, k - start);
+			appendToBuffer(buffer, entity, strlen(entity));
+			start = k + 1;
+		}
+	}
+	appendToBuffer(buffer, declarations + start, length - start);
+	appendToBuffer(buffer, "\"", 1);
+}
+
+void appendStyleDeclaration(Buffer * buffer, const char * key, const StyleValue * value) {
+	if (0 < buffer->length) {
+		appendToBuffer(buffer, ";", 1);
+	}
+	appendToBuffer(buffer, key, strlen(key));
+	appendToBuffer(buffer, ":", 1);
+	switch (value->type) {
+		case STRING_STYLE: {
+			// The string is the lexeme, but its quotes are not part of the CSS value.
+			const size_t length = strlen(value->string);
+			const boolean isQuoted = 2 <= length && value->string[0] == '"';
+			_appendNormalizedString(buffer, isQuoted ? value->string + 1 : value->string, isQuoted ? length - 2 : length);
+			break;
+		}
+		case INTEGER_STYLE:
+			appendIntegerToBuffer(buffer, value->integer);
+			_appendUnit(buffer, key);
+			break;
+		case REAL_STYLE:
+			appendRealToBuffer(buffer, value->real);
+			_appendUnit(buffer, key);
+			break;
+		case CSS_KEYWORD_STYLE:
+			appendToBuffer(buffer, value->cssKeyword, strlen(value->cssKeyword));
+			break;
+		default:
+			logError(_logger, "The style property \"%s\" has no constant value.", key);
+			break;
+	}
+}
@@ -0,0 +1,70 @@
+#ifndef STYLE_SHEET_HEADER
+#define STYLE_SHEET_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Buffer.h"
+#include "../../shared/Hash.h"
+#include "../../shared/Logger.h"
+#include "../../shared/NumberFormat.h"
+#include "../../shared/Statistics.h"
+#include "../../shared/Type.h"
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeStyleSheetModule();
+
+/** Shutdown module's internal state. */
+void shutdownStyleSheetModule();
+
+/**
+ * The rules of the styles used by a page, one per distinct set of canonical
+ * declarations. Every element with the same style shares a single class, so
+ * each style is declared once, in the head, instead of being repeated inline
+ * on every element.
+ */
+typedef struct StyleSheet StyleSheet;
+
+StyleSheet * createStyleSheet();
+
+void destroyStyleSheet(StyleSheet * styleSheet);
+
+/**
+ * Forgets every rule (the next one will take the first class name again),
+ * but keeps the memory of the sheet.
+ */
+void clearStyleSheet(StyleSheet * styleSheet);
+
+/**
+ * The name of the class of some canonical declarations (see
+ * "appendStyleDeclaration"), declaring a new rule the first time they are
+ * seen. The name belongs to the sheet, and lives until it's cleared.
+ */
+const char * addStyleRule(StyleSheet * styleSheet, const char * declarations, const size_t length, const uint64_t hash);
+
+unsigned int countStyleRules(const StyleSheet * styleSheet);
+
+/**
+ * Appends every rule, in the order they were declared, one per line (each
+ * one preceded by the indentation).
+ */
+void appendStyleSheet(const StyleSheet * styleSheet, Buffer * buffer, const char * indentation);
+
+/**
+ * Appends the inline attribute of some canonical declarations
+ * (' style="..."'), escaping them as the value of an HTML attribute.
+ */
+void appendStyleAttribute(Buffer * buffer, const char * declarations, const size_t length);
+
+/**
+ * Appends the canonical declaration of a (constant) style property: its
+ * normalized value (a string without its quotes, a number in pixels unless
+ * the property has no unit), after the key and a colon, and without spaces.
+ * It's separated from the previous declaration in the buffer (if any) by a
+ * semicolon.
+ */
+void appendStyleDeclaration(Buffer * buffer, const char * key, const StyleValue * value);
+
+#endif
@@ -16,9 +16,73 @@ void shutdownCalculatorModule() {
 
 /** PRIVATE FUNCTIONS */
 
+static boolean _computeRealOperation(const ExpressionType type, const double x, const double y, Value * result);
+static boolean _equalValues(const Value * left, const Value * right);
 static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type);
-static ComputationResult _invalidBinaryOperator(const int x, const int y);
+static ComputationResult _invalidBinaryOperator(const int64_t x, const int64_t y);
 static ComputationResult _invalidComputation();
+static boolean _isNumber(const Value * value);
+static ComputationResult _overflow(const char * operation, const int64_t x, const int64_t y);
+static double _realOf(const Value * value);
+
+/**
+ * Applies an arithmetic operator or a comparison to reals. Fails if the
+ * divisor is zero, or if the result is not finite.
+ */
+static boolean _computeRealOperation(const ExpressionType type, const double x, const double y, Value * result) {
+	result->type = BOOLEAN_VALUE;
+	switch (type) {
+		case LESS_THAN: result->boolean = x < y; return true;
+		case LESS_OR_EQUAL: result->boolean = x <= y; return true;
+		case GREATER_THAN: result->boolean = x > y; return true;
+		case GREATER_OR_EQUAL: result->boolean = x >= y; return true;
+		default:
+			break;
+	}
+	result->type = REAL_VALUE;
+	switch (type) {
+		case ADDITION: result->real = x + y; break;
+		case SUBTRACTION: result->real = x - y; break;
+		case MULTIPLICATION: result->real = x * y; break;
+		case DIVISION:
+			if (y == 0.0) {
+				logError(_logger, "The divisor cannot be zero (the computation was %g/%g).", x, y);
+				return false;
+			}
+			result->real = x / y;
+			break;
+		default:
+			logError(_logger, "The specified expression type cannot be applied to reals: %d", type);
+			return false;
+	}
+	if (!isfinite(result->real)) {
+		logError(_logger, "The computation overflows a real (it was %g %c %g).", x,
+			type == ADDITION ? '+' : type == SUBTRACTION ? '-' : type == MULTIPLICATION ? '*' : '/', y);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Whether two values are equal. Composite values are hash-consed, so they're
+ * equal only if they're the same node.
+ */
+static boolean _equalValues(const Value * left, const Value * right) {
+	if (left->type != right->type) {
+		return false;
+	}
+	switch (left->type) {
+		case STRING_VALUE: return strcmp(left->string, right->string) == 0;
+		case INTEGER_VALUE: return left->integer == right->integer;
+		case REAL_VALUE: return left->real == right->real;
+		case BOOLEAN_VALUE: return left->boolean == right->boolean;
+		case NULL_VALUE: return true;
+		case OBJECT_VALUE: return left->object == right->object;
+		case ARRAY_VALUE: return left->array == right->array;
+		default:
+			return left == right;
+	}
+}
 
 /**
  * Converts and expression type to the proper binary operator. If that's not
@@ -40,7 +104,9 @@ static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type)
 /**
  * A binary operator that always returns an invalid computation result.
  */
-static ComputationResult _invalidBinaryOperator(const int x, const int y) {
+static ComputationResult _invalidBinaryOperator(const int64_t x, const int64_t y) {
+	(void) x;
+	(void) y;
 	return _invalidComputation();
 }
 
@@ -55,42 +121,76 @@ static ComputationResult _invalidComputation() {
 	return computationResult;
 }
 
+/**
+ * Whether a value is a number (an integer or a real).
+ */
+static boolean _isNumber(const Value * value) {
+	return value->type == INTEGER_VALUE || value->type == REAL_VALUE;
+}
+
+/**
+ * A computation that overflows 64 bits.
+ */
+static ComputationResult _overflow(const char * operation, const int64_t x, const int64_t y) {
+	logError(_logger, "The computation overflows 64 bits (it was %" PRId64 " %s %" PRId64 ").", x, operation, y);
+	return _invalidComputation();
+}
+
+/**
+ * The value of a number, as a real.
+ */
+static double _realOf(const Value * value) {
+	return value->type == REAL_VALUE ? value->real : (double) value->integer;
+}
+
 /** PUBLIC FUNCTIONS */
 
-ComputationResult add(const int leftAddend, const int rightAddend) {
+ComputationResult add(const int64_t leftAddend, const int64_t rightAddend) {
 	ComputationResult computationResult = {
 		.succeed = true,
-		.value = leftAddend + rightAddend
+		.value = 0
 	};
+	if (__builtin_add_overflow(leftAddend, rightAddend, &computationResult.value)) {
+		return _overflow("+", leftAddend, rightAddend);
+	}
 	return computationResult;
 }
 
-ComputationResult divide(const int dividend, const int divisor) {
+ComputationResult divide(const int64_t dividend, const int64_t divisor) {
 	const int sign = dividend < 0 ? -1 : +1;
 	const boolean divisionByZero = divisor == 0 ? true : false;
 	if (divisionByZero) {
-		logError(_logger, "The divisor cannot be zero (the computation was %d/%d).", dividend, divisor);
+		logError(_logger, "The divisor cannot be zero (the computation was %" PRId64 "/%" PRId64 ").", dividend, divisor);
+	}
+	else if (dividend == INT64_MIN && divisor == -1) {
+		return _overflow("/", dividend, divisor);
 	}
 	ComputationResult computationResult = {
 		.succeed = divisionByZero ? false : true,
-		.value = divisionByZero ? (sign * INT_MAX) : (dividend / divisor)
+		.value = divisionByZero ? (sign * INT64_MAX) : (dividend / divisor)
 	};
 	return computationResult;
 }
 
-ComputationResult multiply(const int multiplicand, const int multiplier) {
+ComputationResult multiply(const int64_t multiplicand, const int64_t multiplier) {
 	ComputationResult computationResult = {
 		.succeed = true,
-		.value = multiplicand * multiplier
+		.value = 0
 	};
+	if (__builtin_mul_overflow(multiplicand, multiplier, &computationResult.value)) {
+		return _overflow("*", multiplicand, multiplier);
+	}
 	return computationResult;
 }
 
-ComputationResult subtract(const int minuend, const int subtract) {
+ComputationResult subtract(const int64_t minuend, const int64_t subtract) {
 	ComputationResult computationResult = {
 		.succeed = true,
-		.value = minuend - subtract
+		.value = 0
 	};
+	if (__builtin_sub_overflow(minuend, subtract, &computationResult.value)) {
+		return _overflow("-", minuend, subtract);
+	}
 	return computationResult;
 }
 
@@ -134,3 +234,63 @@ ComputationResult computeFactor(Factor * factor) {
 			return _invalidComputation();
 	}
 }
+
+boolean computeValueOperation(const ExpressionType type, const Value * left, const Value * right, Value * result) {
+	switch (type) {
+		case EQUALITY:
+		case INEQUALITY:
+			result->type = BOOLEAN_VALUE;
+			result->boolean = _equalValues(left, right) == (type == EQUALITY);
+			return true;
+		case CONJUNCTION:
+		case DISJUNCTION:
+		case NEGATION:
+			if (left->type != BOOLEAN_VALUE || (right != NULL && right->type != BOOLEAN_VALUE)) {
+				logError(_logger, "Logical operations can only be applied to booleans.");
+				return false;
+			}
+			result->type = BOOLEAN_VALUE;
+			result->boolean = type == NEGATION ? !left->boolean
+				: type == CONJUNCTION ? left->boolean && right->boolean
+				: left->boolean || right->boolean;
+			return true;
+		case OPPOSITE:
+			if (!_isNumber(left)) {
+				logError(_logger, "An unary minus can only be applied to numbers.");
+				return false;
+			}
+			if (left->type == REAL_VALUE) {
+				result->type = REAL_VALUE;
+				result->real = -left->real;
+				return true;
+			}
+			const ComputationResult opposite = subtract(0, left->integer);
+			result->type = INTEGER_VALUE;
+			result->integer = opposite.value;
+			return opposite.succeed;
+		default:
+			break;
+	}
+	if (!_isNumber(left) || right == NULL || !_isNumber(right)) {
+		logError(_logger, "Arithmetic operations and comparisons can only be applied to numbers.");
+		return false;
+	}
+	if (left->type == REAL_VALUE || right->type == REAL_VALUE) {
+		return _computeRealOperation(type, _realOf(left), _realOf(right), result);
+	}
+	const int64_t x = left->integer;
+	const int64_t y = right->integer;
+	result->type = BOOLEAN_VALUE;
+	switch (type) {
+		case LESS_THAN: result->boolean = x < y; return true;
+		case LESS_OR_EQUAL: result->boolean = x <= y; return true;
+		case GREATER_THAN: result->boolean = x > y; return true;
+		case GREATER_OR_EQUAL: result->boolean = x >= y; return true;
+		default:
+			break;
+	}
+	const ComputationResult computationResult = _expressionTypeToBinaryOperator(type)(x, y);
+	result->type = INTEGER_VALUE;
+	result->integer = computationResult.value;
+	return computationResult.succeed;
+}
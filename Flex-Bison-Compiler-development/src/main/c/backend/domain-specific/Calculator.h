@@ -9,7 +9,11 @@
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
 #include "../../shared/Logger.h"
 #include "../../shared/Type.h"
+#include <inttypes.h>
 #include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
 
 /** Initialize module's internal state. */
 void initializeCalculatorModule();
@@ -23,17 +27,17 @@ void shutdownCalculatorModule();
  */
 typedef struct {
 	boolean succeed;
-	int value;
+	int64_t value;
 } ComputationResult;
 
-typedef ComputationResult (*BinaryOperator)(const int, const int);
+typedef ComputationResult (*BinaryOperator)(const int64_t, const int64_t);
 
-/** Arithmetic operations. */
+/** Arithmetic operations (64-bit, failing on overflow). */
 
-ComputationResult add(const int leftAddend, const int rightAddend);
-ComputationResult divide(const int dividend, const int divisor);
-ComputationResult multiply(const int multiplicand, const int multiplier);
-ComputationResult subtract(const int minuend, const int subtract);
+ComputationResult add(const int64_t leftAddend, const int64_t rightAddend);
+ComputationResult divide(const int64_t dividend, const int64_t divisor);
+ComputationResult multiply(const int64_t multiplicand, const int64_t multiplier);
+ComputationResult subtract(const int64_t minuend, const int64_t subtract);
 
 /**
  * Computes the final value of a mathematical constant.
@@ -50,4 +54,15 @@ ComputationResult computeExpression(Expression * expression);
  */
 ComputationResult computeFactor(Factor * factor);
 
+/**
+ * Applies an operator to values: arithmetic and ordering over numbers,
+ * equality over any value, and logical operations over booleans (the right
+ * value of a negation, or of an opposite, is NULL). Arithmetic is exact over
+ * integers, and if any operand is a real, both are taken as reals. The
+ * result, a number or a boolean, is written in "result". Returns false if the
+ * operands have the wrong types, or if the operation fails (e.g., it
+ * overflows, or it divides by zero).
+ */
+boolean computeValueOperation(const ExpressionType type, const Value * left, const Value * right, Value * result);
+
 #endif
@@ -0,0 +1,60 @@
+#include "DependencyScanner.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeDependencyScannerModule() {
+	_logger = createLogger("DependencyScanner");
+}
+
+void shutdownDependencyScannerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** IMPORTED FUNCTIONS */
+
+extern void flexScanBytes(const char * bytes, const unsigned int length, const Token startToken);
+extern void flexReleaseBytes(void);
+extern int yylex(void);
+
+// The semantic value of the last token of Flex.
+extern union SemanticValue yylval;
+
+/* PUBLIC FUNCTIONS */
+
+void scanDependencies(const char * source, const size_t length, DependencyHandler handler, void * context) {
+	flexScanBytes(source, length, 0);
+	// The tokens seen since the last "ref" keyword (a link is "ref: STRING"),
+	// or the "include" keyword (a partial is "include STRING").
+	unsigned int matched = 0;
+	Token token;
+	while ((token = yylex()) != 0) {
+		if (token == STRING || token == IDENTIFIER) {
+			char * string = yylval.string;
+			const size_t stringLength = strlen(string);
+			if (token == STRING && (matched == 2 || matched == 3) && 2 <= stringLength) {
+				// Strips the quotes of the lexeme.
+				string[stringLength - 1] = '\0';
+				handler(matched == 2 ? PAGE_REFERENCE : PARTIAL_INCLUSION, string + 1, context);
+			}
+			free(string);
+		}
+		if (token == REF) {
+			matched = 1;
+		}
+		else if (token == COLON && matched == 1) {
+			matched = 2;
+		}
+		else if (token == INCLUDE) {
+			matched = 3;
+		}
+		else {
+			matched = 0;
+		}
+	}
+	flexReleaseBytes();
+	logDebugging(_logger, "Dependencies scanned (%zu bytes).", length);
+}
@@ -0,0 +1,43 @@
+#ifndef DEPENDENCY_SCANNER_HEADER
+#define DEPENDENCY_SCANNER_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "../syntactic-analysis/BisonParser.h"
+#include "Tokens.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeDependencyScannerModule();
+
+/** Shutdown module's internal state. */
+void shutdownDependencyScannerModule();
+
+/**
+ * The kinds of dependency of a source on another one.
+ */
+typedef enum {
+	// A "ref" link, to another page of the same site.
+	PAGE_REFERENCE,
+
+	// An "include", of a partial spliced into the source.
+	PARTIAL_INCLUSION
+} DependencyKind;
+
+/**
+ * Receives each dependency found in a source (the target, without quotes, is
+ * only valid during the call), and the context given to "scanDependencies".
+ */
+typedef void (*DependencyHandler)(const DependencyKind kind, const char * target, void * context);
+
+/**
+ * Finds the dependencies of a source with the scanner alone (i.e., without
+ * parsing it), so strings and comments are skipped exactly like when it's
+ * compiled. Links with "ext-ref" and "href" point outside of the site, so
+ * they are not dependencies.
+ */
+void scanDependencies(const char * source, const size_t length, DependencyHandler handler, void * context);
+
+#endif
@@ -25,12 +25,12 @@ static void _logLexicalAnalyzerContext(const char * functionName, LexicalAnalyze
  */
 static void _logLexicalAnalyzerContext(const char * functionName, LexicalAnalyzerContext * lexicalAnalyzerContext) {
 	char * escapedLexeme = escape(lexicalAnalyzerContext->lexeme);
-	logDebugging(_logger, "%s: %s (context = %d, length = %d, line = %d)",
+	logDebugging(_logger, "%s: %s (context = %d, length = %d, offset = %zu)",
 		functionName,
 		escapedLexeme,
 		lexicalAnalyzerContext->currentContext,
 		lexicalAnalyzerContext->length,
-		lexicalAnalyzerContext->line);
+		lexicalAnalyzerContext->offset);
 	free(escapedLexeme);
 }
 
@@ -66,15 +66,29 @@ Token StringLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
 
 Token NumberLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
 	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
-	if (strchr(lexicalAnalyzerContext->lexeme, '.') || strchr(lexicalAnalyzerContext->lexeme, 'e') || strchr(lexicalAnalyzerContext->lexeme, 'E')) {
-		lexicalAnalyzerContext->semanticValue->real = atof(lexicalAnalyzerContext->lexeme);
-		destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
-		return REAL;
-	} else {
-		lexicalAnalyzerContext->semanticValue->integer = atoi(lexicalAnalyzerContext->lexeme);
-		destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
-		return INTEGER;
+	int64_t integer = 0;
+	double real = 0.0;
+	Token token;
+	switch (parseNumber(lexicalAnalyzerContext->lexeme, lexicalAnalyzerContext->length, &integer, &real)) {
+		case INTEGER_NUMBER:
+			lexicalAnalyzerContext->semanticValue->integer = integer;
+			token = INTEGER;
+			break;
+		case REAL_NUMBER:
+			lexicalAnalyzerContext->semanticValue->real = real;
+			token = REAL;
+			break;
+		case OUT_OF_RANGE_NUMBER:
+			logError(_logger, "The number %s is out of range.", lexicalAnalyzerContext->lexeme);
+			token = YYUNDEF;
+			break;
+		default:
+			logError(_logger, "The number %s is malformed.", lexicalAnalyzerContext->lexeme);
+			token = YYUNDEF;
+			break;
 	}
+	destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
+	return token;
 }
 
 Token BooleanLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext, Token token) {
@@ -3,6 +3,7 @@
 
 #include "../../shared/Environment.h"
 #include "../../shared/Logger.h"
+#include "../../shared/NumberFormat.h"
 #include "../../shared/String.h"
 #include "../../shared/Type.h"
 #include "../syntactic-analysis/AbstractSyntaxTree.h"
@@ -10,4 +10,32 @@ unsigned int flexCurrentContext(void) {
 	return YY_START;
 }
 
+/**
+ * Hook that exports the offset of the current lexeme (or of the end of the
+ * source, once it's reached), from the start of the scanned bytes.
+ */
+size_t flexLexemeOffset(void) {
+	return _lexemeOffset;
+}
+
+/**
+ * Hooks that allow to scan an in-memory source instead of the standard input.
+ * Flex copies the bytes, so the source can be released after the call. If the
+ * start token is not zero, it's emitted before the first lexeme, to select
+ * what the parser recognizes (e.g., a single value instead of a program).
+ *
+ * @see https://westes.github.io/flex/manual/Multiple-Input-Buffers.html
+ */
+void flexScanBytes(const char * bytes, const unsigned int length, const Token startToken) {
+	_lexemeOffset = 0;
+	_nextOffset = 0;
+	_startToken = startToken;
+	BEGIN(INITIAL);
+	yy_scan_bytes(bytes, length);
+}
+
+void flexReleaseBytes(void) {
+	yy_delete_buffer(YY_CURRENT_BUFFER);
+}
+
 #endif
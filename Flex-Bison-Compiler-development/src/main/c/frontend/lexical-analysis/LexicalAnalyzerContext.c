@@ -12,22 +12,25 @@ extern unsigned int flexCurrentContext(void);
 // The lexeme length in characters (provided by Flex).
 extern int yyleng;
 
-// The line number (provided by Flex).
-extern int yylineno;
-
-// The semantic value of the lookahead symbol (provided by Bison).
-extern union SemanticValue yylval;
+// The offset of the current lexeme (provided by Flex).
+extern size_t flexLexemeOffset(void);
 
 // The current lexeme (provided by Flex).
 extern char * yytext;
 
+/* MODULE INTERNAL STATE */
+
+// The semantic value of the last token of Flex (the parser is pure, so it
+// takes a copy, see "nextToken").
+union SemanticValue yylval;
+
 /* PUBLIC FUNCTIONS */
 
 LexicalAnalyzerContext * createLexicalAnalyzerContext() {
 	LexicalAnalyzerContext * lexicalAnalyzerContext = calloc(1, sizeof(LexicalAnalyzerContext));
 	lexicalAnalyzerContext->length = yyleng;
 	lexicalAnalyzerContext->lexeme = calloc(1 + yyleng, sizeof(char));
-	lexicalAnalyzerContext->line = yylineno;
+	lexicalAnalyzerContext->offset = flexLexemeOffset();
 	lexicalAnalyzerContext->semanticValue = &yylval;
 	lexicalAnalyzerContext->currentContext = flexCurrentContext();
 	strncpy(lexicalAnalyzerContext->lexeme, yytext, yyleng);
@@ -13,7 +13,7 @@ typedef struct {
 	unsigned int currentContext;
 	unsigned int length;
 	char * lexeme;
-	unsigned int line;
+	size_t offset;
 	union SemanticValue * semanticValue;
 } LexicalAnalyzerContext;
 
@@ -0,0 +1,787 @@
+#include "StructuralLexer.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The classes of the bytes of a 64-byte block, a bit per byte.
+ */
+typedef struct {
+	uint64_t backslash;
+	uint64_t newline;
+	uint64_t nul;
+	uint64_t quote;
+	uint64_t slash;
+	uint64_t star;
+	uint64_t structural;
+	uint64_t whitespace;
+} BlockClasses;
+
+typedef void (*BlockClassifier)(const uint8_t * block, BlockClasses * classes);
+
+/**
+ * A keyword (or an HTML tag), that is matched instead of an identifier with
+ * the same lexeme.
+ */
+typedef struct {
+	const char * lexeme;
+	unsigned int length;
+	Token token;
+} Keyword;
+
+/**
+ * A token, without its semantic value (that is built when the parser takes
+ * it). Numbers are always INTEGER, until they are converted.
+ */
+typedef struct {
+	uint32_t offset;
+	uint32_t length;
+	Token token;
+} LexedToken;
+
+/**
+ * A chunk of the source, lexed on its own (by a worker), and the memory it
+ * keeps from a scan to the next one.
+ */
+typedef struct {
+	// The bytes of the chunk, in the source.
+	size_t start;
+	size_t end;
+
+	// Whether the chunk starts inside a string (speculated, and fixed if the
+	// previous chunk doesn't end inside one).
+	boolean startsInString;
+
+	// The structural index.
+	uint32_t * index;
+	size_t indexCount;
+	size_t indexCapacity;
+
+	// The tokens.
+	LexedToken * tokens;
+	size_t tokenCount;
+	size_t tokenCapacity;
+
+	// The closing quote of a string that crosses the start of the chunk (if
+	// it starts inside one, and the string is closed in the chunk), and the
+	// opening quote of a string that crosses the end (if any).
+	boolean hasClosingQuote;
+	size_t closingQuote;
+	boolean hasOpeningQuote;
+	size_t openingQuote;
+
+	boolean endsInString;
+	boolean isSupported;
+} LexedChunk;
+
+/**
+ * A value parsed from a range of tokens, that takes their place.
+ */
+typedef struct {
+	size_t first;
+	size_t end;
+	Value * value;
+} SplicedValue;
+
+/**
+ * The tokens a thread takes: every one of the last scan (to parse the
+ * program), or a range of them (see "structuralScanRange"). If there is no
+ * source, they come from Flex.
+ */
+typedef struct {
+	const char * source;
+	size_t next;
+	size_t end;
+	Token startToken;
+	// Whether it's the entire scan (with the spliced values).
+	boolean isEntire;
+} TokenStream;
+
+// The flags of the bytes, for the scalar classifier and the second stage.
+#define WHITESPACE_BYTE 0x01
+#define STRUCTURAL_BYTE 0x02
+#define QUOTE_BYTE 0x04
+#define IDENTIFIER_START_BYTE 0x08
+#define IDENTIFIER_BYTE 0x10
+#define DIGIT_BYTE 0x20
+
+// The bits of a block at even positions.
+#define EVEN_BITS UINT64_C(0x5555555555555555)
+
+// Sources are split in chunks of at least this length (one per processor),
+// at a new-line near the ideal boundary, if any.
+#define MINIMUM_CHUNK_LENGTH (1024 * 1024)
+#define MAXIMUM_CHUNKS 64
+#define BOUNDARY_WINDOW (64 * 1024)
+
+static const Keyword _keywords[] = {
+	{ "true", 4, TRUE }, { "false", 5, FALSE }, { "null", 4, NULL_TOKEN },
+	{ "type", 4, TYPE }, { "content", 7, CONTENT }, { "style", 5, STYLE },
+	{ "src", 3, SRC }, { "alt", 3, ALT }, { "id", 2, ID }, { "class", 5, CLASS },
+	{ "href", 4, HREF }, { "ref", 3, REF }, { "var", 3, VAR },
+	{ "include", 7, INCLUDE }, { "if", 2, IF }, { "then", 4, THEN },
+	{ "else", 4, ELSE }, { "for", 3, FOR }, { "while", 5, WHILE },
+	{ "html", 4, HTML_TAG }, { "head", 4, HEAD_TAG }, { "title", 5, TITLE_TAG },
+	{ "body", 4, BODY_TAG }, { "div", 3, DIV_TAG }, { "p", 1, P_TAG },
+	{ "h1", 2, H1_TAG }, { "img", 3, IMG_TAG }, { "a", 1, A_TAG }, { "b", 1, B_TAG },
+	{ "i", 1, I_TAG }, { "br", 2, BR_TAG }, { "hr", 2, HR_TAG },
+	{ "center", 6, CENTER_TAG }
+};
+
+static Logger * _logger = NULL;
+static uint8_t _byteFlags[256];
+static BlockClassifier _classifier = NULL;
+static unsigned int _processors = 1;
+
+// The source being scanned.
+static const char * _source = NULL;
+static size_t _length = 0;
+
+// The chunks of the last scan (their memory is reused by the next one).
+static LexedChunk _chunks[MAXIMUM_CHUNKS];
+static unsigned int _chunkCount = 0;
+
+// The tokens of every chunk, concatenated.
+static LexedToken * _tokens = NULL;
+static size_t _tokenCount = 0;
+static size_t _tokenCapacity = 0;
+
+// The values spliced in place of some ranges of tokens, in order, and the
+// next one to take.
+static SplicedValue * _splices = NULL;
+static size_t _spliceCount = 0;
+static size_t _spliceCapacity = 0;
+static size_t _nextSplice = 0;
+
+// What the calling thread reads.
+static __thread TokenStream _stream;
+
+// The ring the calling thread takes its tokens from (if lexed by another
+// thread), and the offset of the last token it took from that ring or from
+// the index (the one of Flex is tracked by Flex).
+static __thread RingBuffer * _pipe = NULL;
+static __thread size_t _tokenOffset = 0;
+
+/** IMPORTED FUNCTIONS */
+
+// The offset of the current lexeme (provided by Flex).
+extern size_t flexLexemeOffset(void);
+
+// The semantic value of the last token of Flex.
+extern union SemanticValue yylval;
+
+// The Flex scanner.
+extern int yylex(void);
+
+/* PRIVATE FUNCTIONS */
+
+static void _addToken(LexedChunk * chunk, const Token token, const size_t offset, const size_t end);
+static void _appendToken(const LexedToken * token);
+static void _classifyScalar(const uint8_t * block, BlockClasses * classes);
+static size_t _findBoundary(const size_t target);
+static void _indexChunk(LexedChunk * chunk);
+static void * _lexChunk(void * chunk);
+static size_t _scanLexeme(LexedChunk * chunk, const size_t start);
+static size_t _scanNumber(LexedChunk * chunk, const size_t start);
+static size_t _scanWord(LexedChunk * chunk, const size_t start);
+static void _tokenizeChunk(LexedChunk * chunk);
+
+#if defined(__SSE2__)
+	static void _classifySSE2(const uint8_t * block, BlockClasses * classes);
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+	static void _classifyAVX2(const uint8_t * block, BlockClasses * classes);
+#endif
+
+/**
+ * Appends a token (that ends at an offset) to the tokens of a chunk.
+ */
+static void _addToken(LexedChunk * chunk, const Token token, const size_t offset, const size_t end) {
+	if (chunk->tokenCount == chunk->tokenCapacity) {
+		chunk->tokenCapacity = chunk->tokenCapacity == 0 ? 1024 : 2 * chunk->tokenCapacity;
+		chunk->tokens = realloc(chunk->tokens, chunk->tokenCapacity * sizeof(LexedToken));
+	}
+	LexedToken * lexedToken = &chunk->tokens[chunk->tokenCount++];
+	lexedToken->offset = (uint32_t) offset;
+	lexedToken->length = (uint32_t) (end - offset);
+	lexedToken->token = token;
+}
+
+/**
+ * Appends a token to the concatenated ones.
+ */
+static void _appendToken(const LexedToken * token) {
+	if (_tokenCount == _tokenCapacity) {
+		_tokenCapacity = _tokenCapacity == 0 ? 1024 : 2 * _tokenCapacity;
+		_tokens = realloc(_tokens, _tokenCapacity * sizeof(LexedToken));
+	}
+	_tokens[_tokenCount++] = *token;
+}
+
+/**
+ * Classifies a block a byte at a time.
+ */
+static void _classifyScalar(const uint8_t * block, BlockClasses * classes) {
+	memset(classes, 0, sizeof(BlockClasses));
+	for (unsigned int k = 0; k < 64; ++k) {
+		const uint64_t bit = UINT64_C(1) << k;
+		const uint8_t flags = _byteFlags[block[k]];
+		classes->whitespace |= (flags & WHITESPACE_BYTE) ? bit : 0;
+		classes->structural |= (flags & STRUCTURAL_BYTE) ? bit : 0;
+		classes->quote |= (flags & QUOTE_BYTE) ? bit : 0;
+		classes->backslash |= block[k] == '\\' ? bit : 0;
+		classes->newline |= block[k] == '\n' ? bit : 0;
+		classes->slash |= block[k] == '/' ? bit : 0;
+		classes->star |= block[k] == '*' ? bit : 0;
+		classes->nul |= block[k] == '\0' ? bit : 0;
+	}
+}
+
+#if defined(__SSE2__)
+	/**
+	 * Classifies a block 16 bytes at a time.
+	 */
+	static void _classifySSE2(const uint8_t * block, BlockClasses * classes) {
+		memset(classes, 0, sizeof(BlockClasses));
+		for (unsigned int k = 0; k < 64; k += 16) {
+			const __m128i v = _mm_loadu_si128((const __m128i *) (block + k));
+			#define MATCH(byte) _mm_cmpeq_epi8(v, _mm_set1_epi8(byte))
+			#define BITS(vector) ((uint64_t) (uint16_t) _mm_movemask_epi8(vector) << k)
+			const __m128i structural = _mm_or_si128(
+				_mm_or_si128(_mm_or_si128(MATCH('{'), MATCH('}')), _mm_or_si128(MATCH('['), MATCH(']'))),
+				_mm_or_si128(MATCH(':'), MATCH(',')));
+			// The space, and the bytes from '\t' to '\r'.
+			const __m128i whitespace = _mm_or_si128(MATCH(' '),
+				_mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1))));
+			classes->structural |= BITS(structural);
+			classes->whitespace |= BITS(whitespace);
+			classes->quote |= BITS(MATCH('"'));
+			classes->backslash |= BITS(MATCH('\\'));
+			classes->newline |= BITS(MATCH('\n'));
+			classes->slash |= BITS(MATCH('/'));
+			classes->star |= BITS(MATCH('*'));
+			classes->nul |= BITS(MATCH('\0'));
+			#undef BITS
+			#undef MATCH
+		}
+	}
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+	/**
+	 * Classifies a block 32 bytes at a time (only called if the processor
+	 * supports AVX2).
+	 */
+	__attribute__((target("avx2")))
+	static void _classifyAVX2(const uint8_t * block, BlockClasses * classes) {
+		memset(classes, 0, sizeof(BlockClasses));
+		for (unsigned int k = 0; k < 64; k += 32) {
+			const __m256i v = _mm256_loadu_si256((const __m256i *) (block + k));
+			#define MATCH(byte) _mm256_cmpeq_epi8(v, _mm256_set1_epi8(byte))
+			#define BITS(vector) ((uint64_t) (uint32_t) _mm256_movemask_epi8(vector) << k)
+			const __m256i structural = _mm256_or_si256(
+				_mm256_or_si256(_mm256_or_si256(MATCH('{'), MATCH('}')), _mm256_or_si256(MATCH('['), MATCH(']'))),
+				_mm256_or_si256(MATCH(':'), MATCH(',')));
+			// The space, and the bytes from '\t' to '\r'.
+			const __m256i whitespace = _mm256_or_si256(MATCH(' '),
+				_mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v)));
+			classes->structural |= BITS(structural);
+			classes->whitespace |= BITS(whitespace);
+			classes->quote |= BITS(MATCH('"'));
+			classes->backslash |= BITS(MATCH('\\'));
+			classes->newline |= BITS(MATCH('\n'));
+			classes->slash |= BITS(MATCH('/'));
+			classes->star |= BITS(MATCH('*'));
+			classes->nul |= BITS(MATCH('\0'));
+			#undef BITS
+			#undef MATCH
+		}
+	}
+#endif
+
+/**
+ * The start of a chunk near an offset: right after the next new-line (that
+ * is seldom inside a string), or after any whitespace if there is none close
+ * enough. Since the previous byte is whitespace, nothing but a string can
+ * cross the boundary. Returns the length if there is no boundary at all.
+ */
+static size_t _findBoundary(const size_t target) {
+	const size_t limit = _length - target < BOUNDARY_WINDOW ? _length : target + BOUNDARY_WINDOW;
+	const char * newline = memchr(_source + target, '\n', limit - target);
+	if (newline != NULL) {
+		return newline - _source + 1;
+	}
+	for (size_t k = target; k < limit; ++k) {
+		if (_byteFlags[(uint8_t) _source[k]] & WHITESPACE_BYTE) {
+			return k + 1;
+		}
+	}
+	return _length;
+}
+
+/**
+ * The first stage, over a chunk: classifies each block, finds the bytes
+ * inside strings (quotes that are not escaped toggle it, with a prefix-xor),
+ * and appends the structural offsets to the index.
+ */
+static void _indexChunk(LexedChunk * chunk) {
+	const size_t length = chunk->end - chunk->start;
+	const size_t blocks = (length + 63) / 64;
+	if (chunk->indexCapacity < length + 1) {
+		chunk->indexCapacity = length + 1;
+		chunk->index = realloc(chunk->index, chunk->indexCapacity * sizeof(uint32_t));
+	}
+	chunk->indexCount = 0;
+	// What carries from a block to the next one (and from the previous chunk,
+	// but it ends with whitespace, so only a string can).
+	uint64_t previousEscaped = 0;
+	uint64_t previousInString = chunk->startsInString ? ~UINT64_C(0) : 0;
+	uint64_t previousLexeme = 0;
+	uint64_t previousSlash = 0;
+	uint64_t unsupported = 0;
+	uint8_t padded[64];
+	for (size_t block = 0; block < blocks; ++block) {
+		const size_t offset = 64 * block;
+		const uint8_t * bytes = (const uint8_t *) _source + chunk->start + offset;
+		if (length - offset < 64) {
+			memset(padded, ' ', 64);
+			memcpy(padded, bytes, length - offset);
+			bytes = padded;
+		}
+		BlockClasses classes;
+		_classifier(bytes, &classes);
+		// The bytes escaped by an odd run of backslashes.
+		const uint64_t backslash = classes.backslash & ~previousEscaped;
+		const uint64_t followsEscape = (backslash << 1) | previousEscaped;
+		const uint64_t oddStarts = backslash & ~EVEN_BITS & ~followsEscape;
+		uint64_t evenSequences;
+		previousEscaped = __builtin_add_overflow(oddStarts, backslash, &evenSequences);
+		const uint64_t escaped = (EVEN_BITS ^ (evenSequences << 1)) & followsEscape;
+		// The opening quote and the body of each string (prefix-xor).
+		const uint64_t quotes = classes.quote & ~escaped;
+		uint64_t inString = quotes;
+		for (unsigned int shift = 1; shift < 64; shift <<= 1) {
+			inString ^= inString << shift;
+		}
+		inString ^= previousInString;
+		previousInString = (uint64_t) ((int64_t) inString >> 63);
+		// Any other lexeme starts after a byte that is not part of one.
+		const uint64_t lexeme = ~(classes.whitespace | classes.structural | quotes | inString);
+		const uint64_t lexemeStarts = lexeme & ~((lexeme << 1) | previousLexeme);
+		previousLexeme = lexeme >> 63;
+		// Comments ("/*" out of a string), new-lines escaped in a string, and
+		// null bytes.
+		const uint64_t slash = classes.slash & ~inString;
+		unsupported |= classes.star & ((slash << 1) | previousSlash);
+		unsupported |= escaped & classes.newline & inString;
+		unsupported |= classes.nul;
+		previousSlash = slash >> 63;
+		uint64_t structurals = (classes.structural & ~inString) | quotes | lexemeStarts;
+		if (length - offset < 64) {
+			structurals &= (UINT64_C(1) << (length - offset)) - 1;
+		}
+		while (structurals != 0) {
+			chunk->index[chunk->indexCount++] = (uint32_t) (chunk->start + offset + __builtin_ctzll(structurals));
+			structurals &= structurals - 1;
+		}
+	}
+	chunk->endsInString = previousInString != 0;
+	chunk->isSupported = unsupported == 0;
+}
+
+/**
+ * Lexes a chunk (the entry-point of the workers).
+ */
+static void * _lexChunk(void * chunk) {
+	_indexChunk(chunk);
+	_tokenizeChunk(chunk);
+	return NULL;
+}
+
+/**
+ * Scans the next token of a lexeme at an offset: a number, a word (i.e., a
+ * keyword or an identifier), or an operator. Any other byte is unknown, as
+ * in Flex. Returns the end of the token.
+ */
+static size_t _scanLexeme(LexedChunk * chunk, const size_t start) {
+	const char current = _source[start];
+	const char next = start + 1 < chunk->end ? _source[start + 1] : '\0';
+	if (_byteFlags[(uint8_t) current] & IDENTIFIER_START_BYTE) {
+		return _scanWord(chunk, start);
+	}
+	if (_byteFlags[(uint8_t) current] & DIGIT_BYTE) {
+		return _scanNumber(chunk, start);
+	}
+	Token token = UNKNOWN;
+	unsigned int length = 1;
+	switch (current) {
+		case '+': token = ADD; break;
+		case '-': token = SUB; break;
+		case '*': token = MUL; break;
+		case '/': token = DIV; break;
+		case '(': token = OPEN_PARENTHESIS; break;
+		case ')': token = CLOSE_PARENTHESIS; break;
+		case '&': token = next == '&' ? AND : UNKNOWN; length = next == '&' ? 2 : 1; break;
+		case '|': token = next == '|' ? OR : UNKNOWN; length = next == '|' ? 2 : 1; break;
+		case '!': token = next == '=' ? NEQ : NOT; length = next == '=' ? 2 : 1; break;
+		case '=': token = next == '=' ? EQ : UNKNOWN; length = next == '=' ? 2 : 1; break;
+		case '<': token = next == '=' ? LE : LT; length = next == '=' ? 2 : 1; break;
+		case '>': token = next == '=' ? GE : GT; length = next == '=' ? 2 : 1; break;
+		default: break;
+	}
+	_addToken(chunk, token, start, start + length);
+	return start + length;
+}
+
+/**
+ * Scans the longest number at an offset (digits, an optional fraction and an
+ * optional exponent, each one only if followed by a digit), as Flex does. A
+ * minus sign is always an operator (see "OPPOSITE").
+ */
+static size_t _scanNumber(LexedChunk * chunk, const size_t start) {
+	const size_t limit = chunk->end;
+	size_t end = start;
+	while (end < limit && (_byteFlags[(uint8_t) _source[end]] & DIGIT_BYTE)) {
+		++end;
+	}
+	if (end + 1 < limit && _source[end] == '.' && (_byteFlags[(uint8_t) _source[end + 1]] & DIGIT_BYTE)) {
+		for (end += 2; end < limit && (_byteFlags[(uint8_t) _source[end]] & DIGIT_BYTE); ++end);
+	}
+	if (end + 1 < limit && (_source[end] == 'e' || _source[end] == 'E')) {
+		const size_t sign = end + 1 + (_source[end + 1] == '+' || _source[end + 1] == '-');
+		if (sign < limit && (_byteFlags[(uint8_t) _source[sign]] & DIGIT_BYTE)) {
+			for (end = sign + 1; end < limit && (_byteFlags[(uint8_t) _source[end]] & DIGIT_BYTE); ++end);
+		}
+	}
+	_addToken(chunk, INTEGER, start, end);
+	return end;
+}
+
+/**
+ * Scans the longest word at an offset: a keyword if it matches one (or
+ * "ext-ref", the only keyword that is not an identifier), otherwise, an
+ * identifier.
+ */
+static size_t _scanWord(LexedChunk * chunk, const size_t start) {
+	size_t end = start + 1;
+	while (end < chunk->end && (_byteFlags[(uint8_t) _source[end]] & IDENTIFIER_BYTE)) {
+		++end;
+	}
+	const size_t length = end - start;
+	if (length == 3 && end + 4 <= chunk->end && memcmp(_source + start, "ext-ref", 7) == 0) {
+		_addToken(chunk, EXT_REF, start, start + 7);
+		return start + 7;
+	}
+	Token token = IDENTIFIER;
+	for (unsigned int k = 0; k < sizeof(_keywords) / sizeof(Keyword); ++k) {
+		const Keyword * keyword = &_keywords[k];
+		if (keyword->length == length && keyword->lexeme[0] == _source[start] && memcmp(keyword->lexeme, _source + start, length) == 0) {
+			token = keyword->token;
+			break;
+		}
+	}
+	_addToken(chunk, token, start, end);
+	return end;
+}
+
+/**
+ * The second stage, over a chunk: produces its tokens from the index. The
+ * structurals and the strings come straight from it, and the bytes of any
+ * other lexeme are scanned up to the next whitespace, structural or quote.
+ */
+static void _tokenizeChunk(LexedChunk * chunk) {
+	chunk->tokenCount = 0;
+	chunk->hasClosingQuote = false;
+	chunk->hasOpeningQuote = false;
+	size_t entry = 0;
+	if (chunk->startsInString && 0 < chunk->indexCount) {
+		// The first entry closes the string that crosses the start.
+		chunk->hasClosingQuote = true;
+		chunk->closingQuote = chunk->index[entry++];
+	}
+	while (entry < chunk->indexCount) {
+		const size_t offset = chunk->index[entry++];
+		switch (_source[offset]) {
+			case '{': _addToken(chunk, OPEN_BRACE, offset, offset + 1); break;
+			case '}': _addToken(chunk, CLOSE_BRACE, offset, offset + 1); break;
+			case '[': _addToken(chunk, OPEN_BRACKET, offset, offset + 1); break;
+			case ']': _addToken(chunk, CLOSE_BRACKET, offset, offset + 1); break;
+			case ':': _addToken(chunk, COLON, offset, offset + 1); break;
+			case ',': _addToken(chunk, COMMA, offset, offset + 1); break;
+			case '"':
+				if (entry < chunk->indexCount) {
+					_addToken(chunk, STRING, offset, chunk->index[entry++] + 1);
+				}
+				else {
+					chunk->hasOpeningQuote = true;
+					chunk->openingQuote = offset;
+				}
+				break;
+			default:
+				for (size_t position = offset; position < chunk->end
+						&& !(_byteFlags[(uint8_t) _source[position]] & (WHITESPACE_BYTE | STRUCTURAL_BYTE | QUOTE_BYTE));) {
+					position = _scanLexeme(chunk, position);
+				}
+				break;
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+void initializeStructuralLexerModule() {
+	_logger = createLogger("StructuralLexer");
+	for (unsigned int byte = 0; byte < 256; ++byte) {
+		uint8_t flags = 0;
+		if (byte == ' ' || ('\t' <= byte && byte <= '\r')) {
+			flags |= WHITESPACE_BYTE;
+		}
+		if (strchr("{}[]:,", byte) != NULL && byte != '\0') {
+			flags |= STRUCTURAL_BYTE;
+		}
+		if (byte == '"') {
+			flags |= QUOTE_BYTE;
+		}
+		if (('a' <= byte && byte <= 'z') || ('A' <= byte && byte <= 'Z') || byte == '_') {
+			flags |= IDENTIFIER_START_BYTE | IDENTIFIER_BYTE;
+		}
+		if ('0' <= byte && byte <= '9') {
+			flags |= IDENTIFIER_BYTE | DIGIT_BYTE;
+		}
+		_byteFlags[byte] = flags;
+	}
+	_classifier = _classifyScalar;
+	#if defined(__SSE2__)
+		_classifier = _classifySSE2;
+	#endif
+	#if defined(__x86_64__) || defined(__i386__)
+		if (__builtin_cpu_supports("avx2")) {
+			_classifier = _classifyAVX2;
+		}
+	#endif
+	const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	_processors = processors < 1 ? 1 : processors < MAXIMUM_CHUNKS ? processors : MAXIMUM_CHUNKS;
+}
+
+void shutdownStructuralLexerModule() {
+	for (unsigned int k = 0; k < MAXIMUM_CHUNKS; ++k) {
+		free(_chunks[k].index);
+		free(_chunks[k].tokens);
+	}
+	memset(_chunks, 0, sizeof(_chunks));
+	free(_tokens);
+	_tokens = NULL;
+	_tokenCapacity = 0;
+	free(_splices);
+	_splices = NULL;
+	_spliceCapacity = 0;
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+boolean structuralScanBytes(const char * bytes, const size_t length, const Token startToken) {
+	if (UINT32_MAX <= length) {
+		return false;
+	}
+	_source = bytes;
+	_length = length;
+	// Splits the source (one chunk per processor, if it's long enough).
+	const size_t chunks = length / MINIMUM_CHUNK_LENGTH < _processors ? 1 + length / MINIMUM_CHUNK_LENGTH : _processors;
+	_chunkCount = 0;
+	for (size_t start = 0; start < length || _chunkCount == 0;) {
+		const size_t target = (_chunkCount + 1) * (length / chunks);
+		const size_t end = _chunkCount + 1 < chunks && start < target ? _findBoundary(target) : length;
+		LexedChunk * chunk = &_chunks[_chunkCount++];
+		chunk->start = start;
+		chunk->end = end;
+		chunk->startsInString = false;
+		start = end;
+	}
+	// Lexes every chunk at the same time, speculating that none of them
+	// starts inside a string.
+	pthread_t workers[MAXIMUM_CHUNKS];
+	boolean isWorking[MAXIMUM_CHUNKS] = { false };
+	for (unsigned int k = 1; k < _chunkCount; ++k) {
+		isWorking[k] = pthread_create(&workers[k], NULL, _lexChunk, &_chunks[k]) == 0;
+	}
+	for (unsigned int k = 0; k < _chunkCount; ++k) {
+		if (k == 0 || !isWorking[k]) {
+			_lexChunk(&_chunks[k]);
+		}
+		else {
+			pthread_join(workers[k], NULL);
+		}
+	}
+	// Fixes the chunks that do start inside a string (lexing them again),
+	// and concatenates their tokens.
+	_tokenCount = 0;
+	boolean isSupported = true;
+	size_t openingQuote = 0;
+	for (unsigned int k = 0; k < _chunkCount && isSupported; ++k) {
+		LexedChunk * chunk = &_chunks[k];
+		const boolean startsInString = 0 < k && _chunks[k - 1].endsInString;
+		if (chunk->startsInString != startsInString) {
+			addToStatistic("lexer.mispredictions", 1);
+			chunk->startsInString = startsInString;
+			_lexChunk(chunk);
+		}
+		isSupported = chunk->isSupported;
+		if (startsInString && chunk->hasClosingQuote) {
+			const LexedToken string = {
+				.offset = (uint32_t) openingQuote,
+				.length = (uint32_t) (chunk->closingQuote + 1 - openingQuote),
+				.token = STRING
+			};
+			_appendToken(&string);
+		}
+		for (size_t t = 0; t < chunk->tokenCount; ++t) {
+			_appendToken(&chunk->tokens[t]);
+		}
+		if (chunk->hasOpeningQuote) {
+			openingQuote = chunk->openingQuote;
+		}
+	}
+	if (!isSupported || _chunks[_chunkCount - 1].endsInString) {
+		logDebugging(_logger, "The source cannot be indexed (%zu bytes), so it's scanned with Flex.", length);
+		addToStatistic("lexer.fallbacks", 1);
+		_source = NULL;
+		_stream.source = NULL;
+		return false;
+	}
+	addToStatistic("lexer.chunks", _chunkCount);
+	addToStatistic("lexer.tokens", _tokenCount);
+	_spliceCount = 0;
+	_nextSplice = 0;
+	_stream = (TokenStream) {
+		.source = bytes,
+		.next = 0,
+		.end = _tokenCount,
+		.startToken = startToken,
+		.isEntire = true
+	};
+	return true;
+}
+
+void structuralReleaseBytes(void) {
+	if (_stream.isEntire) {
+		for (; _nextSplice < _spliceCount; ++_nextSplice) {
+			releaseValue(_splices[_nextSplice].value);
+		}
+		_spliceCount = 0;
+		_nextSplice = 0;
+	}
+	_stream.source = NULL;
+	_stream.isEntire = false;
+}
+
+size_t structuralTokenCount(void) {
+	return _tokenCount;
+}
+
+Token structuralToken(const size_t index) {
+	return _tokens[index].token;
+}
+
+const char * structuralLexeme(const size_t index, size_t * length) {
+	*length = _tokens[index].length;
+	return _source + _tokens[index].offset;
+}
+
+void structuralScanRange(const size_t first, const size_t end, const Token startToken) {
+	_stream = (TokenStream) {
+		.source = _source,
+		.next = first,
+		.end = end,
+		.startToken = startToken,
+		.isEntire = false
+	};
+}
+
+void structuralSpliceValue(const size_t first, const size_t end, Value * value) {
+	if (_spliceCount == _spliceCapacity) {
+		_spliceCapacity = _spliceCapacity == 0 ? 64 : 2 * _spliceCapacity;
+		_splices = realloc(_splices, _spliceCapacity * sizeof(SplicedValue));
+	}
+	_splices[_spliceCount++] = (SplicedValue) {
+		.first = first,
+		.end = end,
+		.value = value
+	};
+}
+
+void receiveTokens(RingBuffer * ring) {
+	_pipe = ring;
+	_tokenOffset = 0;
+}
+
+size_t currentTokenOffset(void) {
+	return _pipe == NULL && _stream.source == NULL ? flexLexemeOffset() : _tokenOffset;
+}
+
+int nextToken(union SemanticValue * value) {
+	if (_pipe != NULL) {
+		PipedToken pipedToken;
+		if (!popFromRingBuffer(_pipe, &pipedToken)) {
+			return 0;
+		}
+		_tokenOffset = pipedToken.offset;
+		*value = pipedToken.value;
+		return pipedToken.token;
+	}
+	if (_stream.source == NULL) {
+		const int token = yylex();
+		*value = yylval;
+		return token;
+	}
+	if (_stream.startToken != 0) {
+		const Token startToken = _stream.startToken;
+		_stream.startToken = 0;
+		return startToken;
+	}
+	if (_stream.next == _stream.end) {
+		_tokenOffset = _stream.end < _tokenCount ? _tokens[_stream.end].offset : _length;
+		return 0;
+	}
+	if (_stream.isEntire && _nextSplice < _spliceCount && _splices[_nextSplice].first == _stream.next) {
+		const SplicedValue * splice = &_splices[_nextSplice++];
+		_stream.next = splice->end;
+		_tokenOffset = _tokens[splice->first].offset;
+		value->value = splice->value;
+		return PARSED_VALUE;
+	}
+	const LexedToken * lexedToken = &_tokens[_stream.next++];
+	const char * lexeme = _stream.source + lexedToken->offset;
+	_tokenOffset = lexedToken->offset;
+	switch (lexedToken->token) {
+		case STRING:
+		case IDENTIFIER: {
+			char * string = malloc(lexedToken->length + 1);
+			memcpy(string, lexeme, lexedToken->length);
+			string[lexedToken->length] = '\0';
+			value->string = string;
+			return lexedToken->token;
+		}
+		case INTEGER: {
+			int64_t integer = 0;
+			double real = 0.0;
+			switch (parseNumber(lexeme, lexedToken->length, &integer, &real)) {
+				case INTEGER_NUMBER:
+					value->integer = integer;
+					return INTEGER;
+				case REAL_NUMBER:
+					value->real = real;
+					return REAL;
+				default:
+					logError(_logger, "The number %.*s is out of range.", (int) lexedToken->length, lexeme);
+					return YYUNDEF;
+			}
+		}
+		case TRUE:
+		case FALSE:
+			value->boolean = lexedToken->token == TRUE;
+			return lexedToken->token;
+		default:
+			value->token = lexedToken->token;
+			return lexedToken->token;
+	}
+}
@@ -0,0 +1,116 @@
+#ifndef STRUCTURAL_LEXER_HEADER
+#define STRUCTURAL_LEXER_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/NumberFormat.h"
+#include "../../shared/RingBuffer.h"
+#include "../../shared/Statistics.h"
+#include "../../shared/Type.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include "../syntactic-analysis/BisonActions.h"
+#include "../syntactic-analysis/BisonParser.h"
+#include "Tokens.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+#endif
+
+/** Initialize module's internal state. */
+void initializeStructuralLexerModule();
+
+/** Shutdown module's internal state. */
+void shutdownStructuralLexerModule();
+
+/**
+ * An alternative to Flex for in-memory sources, in two stages (like
+ * simdjson). The first one classifies the source 64 bytes at a time (with
+ * AVX2 or SSE2 if available, and a scalar fallback otherwise) and builds a
+ * structural index: the offsets of every brace, bracket, colon and comma,
+ * of both quotes of every string, and of the start of every other lexeme,
+ * skipping whitespace and the bodies of strings. The second one produces the
+ * tokens from that index, with the same semantic values (and offsets) as
+ * Flex would.
+ *
+ * Long sources (of a few MiB) are split in chunks, one per processor, right
+ * after a new-line, and each chunk is indexed and tokenized by its own
+ * thread into a compact array of tokens (their kinds, offsets and lengths),
+ * concatenated at the end. Only a string can cross a boundary: every
+ * chunk is lexed as if it started outside of one, and those that don't are
+ * lexed again (with new-lines as boundaries, that's seldom needed).
+ *
+ * Returns false (and the source must be scanned with Flex instead) if the
+ * source has something the index doesn't model: a comment, a string that
+ * Flex wouldn't match as such (unterminated, or with an escaped new-line),
+ * or a null byte. If the start token is not zero, it's emitted before the
+ * first lexeme (see "flexScanBytes").
+ */
+boolean structuralScanBytes(const char * bytes, const size_t length, const Token startToken);
+
+/**
+ * Stops producing tokens from the index (the next ones come from Flex), and
+ * releases the spliced values that the parser never took.
+ */
+void structuralReleaseBytes(void);
+
+/**
+ * The tokens of the last scan (valid until the next one): how many there
+ * are, the kind of each one (numbers are always INTEGER), and its lexeme
+ * (not null-terminated).
+ */
+size_t structuralTokenCount(void);
+Token structuralToken(const size_t index);
+const char * structuralLexeme(const size_t index, size_t * length);
+
+/**
+ * Makes the calling thread take only the tokens in [first, end) of the last
+ * scan, after the start token (if not zero). Each thread reads its own range
+ * (e.g., the one of a value, to parse it on its own), so a range can be read
+ * while another thread reads a different one.
+ */
+void structuralScanRange(const size_t first, const size_t end, const Token startToken);
+
+/**
+ * Replaces the tokens in [first, end) of the last scan with a single
+ * PARSED_VALUE token, for a value already parsed from them. The parser owns
+ * the value once it takes the token (the ones never taken are released with
+ * the scan). Ranges must be spliced in order, without overlapping.
+ */
+void structuralSpliceValue(const size_t first, const size_t end, Value * value);
+
+/**
+ * A token lexed ahead by another thread, with its semantic value and offset.
+ */
+typedef struct {
+	int token;
+	size_t offset;
+	union SemanticValue value;
+} PipedToken;
+
+/**
+ * Makes the calling thread take its tokens from a ring of "PipedToken",
+ * filled by a lexer that runs on another thread, until it's closed (or until
+ * this is called again with NULL).
+ */
+void receiveTokens(RingBuffer * ring);
+
+/**
+ * The offset of the last token taken by the calling thread, from the start of
+ * its source (or of the end, once it's reached). Lines are not tracked by
+ * the lexers, so a diagnostic computes the line from it (see "LineIndex").
+ */
+size_t currentTokenOffset(void);
+
+/**
+ * The next token of the source and its semantic value, for Bison (in place
+ * of "yylex"): from the ring of this thread (see "receiveTokens"), from the
+ * structural index while a source is scanned with "structuralScanBytes" (or
+ * a range of it, on this thread), and from Flex otherwise.
+ */
+int nextToken(union SemanticValue * value);
+
+#endif
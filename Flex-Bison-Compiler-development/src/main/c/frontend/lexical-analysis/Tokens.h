@@ -2,22 +2,12 @@
 #define TOKENS_H
 
 #include "../syntactic-analysis/BisonParser.h"
+#include <stdint.h>
 
-// Usamos los tokens definidos en BisonParser.h
-typedef Token Token;
+// Los tokens (y su valor semántico, "union SemanticValue") están definidos en
+// BisonParser.h; "Token" en Type.h.
 
 // Token desconocido
 #define UNKNOWN 0
 
-/**
- * Unión que almacena los valores semánticos de los tokens.
- */
-typedef union {
-    char* string;    /* Para strings e identificadores */
-    int integer;     /* Para enteros */
-    double real;     /* Para números reales */
-    int boolean;     /* Para booleanos */
-    Token token;     /* Para tokens que no tienen valor */
-} SemanticValue;
-
 #endif // TOKENS_H 
\ No newline at end of file
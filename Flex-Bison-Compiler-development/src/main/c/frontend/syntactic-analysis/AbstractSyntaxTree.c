@@ -31,6 +31,16 @@ void releaseExpression(Expression * expression) {
 			case DIVISION:
 			case MULTIPLICATION:
 			case SUBTRACTION:
+			case EQUALITY:
+			case INEQUALITY:
+			case LESS_THAN:
+			case LESS_OR_EQUAL:
+			case GREATER_THAN:
+			case GREATER_OR_EQUAL:
+			case CONJUNCTION:
+			case DISJUNCTION:
+			case NEGATION:
+			case OPPOSITE:
 				releaseExpression(expression->leftExpression);
 				releaseExpression(expression->rightExpression);
 				break;
@@ -60,7 +70,8 @@ void releaseFactor(Factor * factor) {
 void releaseProgram(Program * program) {
 	logDebugging(_logger, "Executing destructor: %s", __FUNCTION__);
 	if (program != NULL) {
-		releaseExpression(program->expression);
+		releaseHTMLElement(program->root);
+		releaseValue(program->content);
 		free(program);
 	}
 }
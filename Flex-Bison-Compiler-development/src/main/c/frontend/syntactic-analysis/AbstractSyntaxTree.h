@@ -2,6 +2,7 @@
 #define ABSTRACT_SYNTAX_TREE_HEADER
 
 #include "../../shared/Logger.h"
+#include <stdint.h>
 #include <stdlib.h>
 
 /** Initialize module's internal state. */
@@ -19,9 +20,13 @@ typedef enum ValueType ValueType;
 typedef enum StyleValueType StyleValueType;
 typedef enum HTMLElementType HTMLElementType;
 
+typedef struct Conditional Conditional;
 typedef struct Constant Constant;
+typedef struct Evaluation Evaluation;
 typedef struct Expression Expression;
 typedef struct Factor Factor;
+typedef struct Instruction Instruction;
+typedef struct Loop Loop;
 typedef struct Program Program;
 typedef struct Value Value;
 typedef struct StyleValue StyleValue;
@@ -54,7 +59,19 @@ enum ExpressionType {
 	DIVISION,
 	FACTOR,
 	MULTIPLICATION,
-	SUBTRACTION
+	SUBTRACTION,
+	// Comparisons and logical operations (only over values, see "Evaluation").
+	EQUALITY,
+	INEQUALITY,
+	LESS_THAN,
+	LESS_OR_EQUAL,
+	GREATER_THAN,
+	GREATER_OR_EQUAL,
+	CONJUNCTION,
+	DISJUNCTION,
+	NEGATION,
+	// The arithmetic negation of a number (i.e., an unary minus).
+	OPPOSITE
 };
 
 enum FactorType {
@@ -69,14 +86,30 @@ enum ValueType {
 	BOOLEAN_VALUE,
 	NULL_VALUE,
 	OBJECT_VALUE,
-	ARRAY_VALUE
+	ARRAY_VALUE,
+	// A partial, by name (in "string"), generated once and spliced.
+	INCLUDE_VALUE,
+	// Control flow, expanded while generating (see "Loop" and "Conditional").
+	FOR_VALUE,
+	IF_VALUE,
+	// The variable of an enclosing loop, by the nesting level of that loop.
+	SLOT_VALUE,
+	// An expression that uses a loop variable (otherwise, it's folded).
+	EXPRESSION_VALUE
 };
 
+/**
+ * How many loops can be nested (each loop variable is a bit of the
+ * "freeSlots" of a value).
+ */
+#define MAXIMUM_LOOP_DEPTH 64
+
 enum StyleValueType {
 	STRING_STYLE,
 	INTEGER_STYLE,
 	REAL_STYLE,
-	CSS_KEYWORD_STYLE
+	CSS_KEYWORD_STYLE,
+	EXPRESSION_STYLE
 };
 
 enum HTMLElementType {
@@ -122,21 +155,74 @@ struct Expression {
 struct Value {
 	union {
 		char * string;
-		int integer;
+		int64_t integer;
 		double real;
 		int boolean;
 		Object * object;
 		Array * array;
+		Loop * loop;
+		Conditional * conditional;
+		unsigned int slot;
+		Evaluation * evaluation;
 	};
 	ValueType type;
+
+	// The variables of the enclosing loops used by this value (a bit per
+	// slot): if any, its output changes on each iteration.
+	uint64_t freeSlots;
+
+	// Hash-consing: structural hash, and how many parents share this node.
+	uint64_t hash;
+	unsigned int references;
+};
+
+/**
+ * A loop over the elements of an array (the iterable). The body is a
+ * template, parsed once: it's generated for each element, with the loop
+ * variable (a SLOT_VALUE) bound to it, and nothing is built per iteration.
+ */
+struct Loop {
+	unsigned int slot;
+	Value * iterable;
+	Value * body;
+};
+
+/**
+ * A choice on a boolean value. Without an alternative, a condition that
+ * doesn't hold generates nothing.
+ */
+struct Conditional {
+	Value * condition;
+	Value * consequent;
+	Value * alternative;
+};
+
+/**
+ * A step of an evaluation: pushes an operand (if the type is FACTOR), or
+ * applies an operator to the operands on top of the stack.
+ */
+struct Instruction {
+	ExpressionType type;
+	Value * operand;
+};
+
+/**
+ * An expression that could not be folded while parsing, compiled in postfix
+ * order. The depth is the size of the stack needed to evaluate it.
+ */
+struct Evaluation {
+	Instruction * instructions;
+	unsigned int count;
+	unsigned int depth;
 };
 
 struct StyleValue {
 	union {
 		char * string;
-		int integer;
+		int64_t integer;
 		double real;
 		char * cssKeyword;
+		Value * expression;
 	};
 	StyleValueType type;
 };
@@ -149,11 +235,29 @@ struct StyleProperty {
 struct StyleProperties {
 	StyleProperty ** properties;
 	int count;
+
+	// The canonical declarations (sorted by key, see "StyleSemanticAction")
+	// and their hash, or NULL if a value uses a loop variable (then, they are
+	// written while generating).
+	char * declarations;
+	size_t declarationsLength;
+	uint64_t hash;
+
+	// The inline attribute (' style="..."', already escaped), serialized only
+	// once, so each emission is a single copy (NULL with the declarations).
+	char * attribute;
+	size_t attributeLength;
 };
 
+/**
+ * An entry of an object. The key is NULL for an element on its own (e.g., the
+ * head and the body of a page), and a style is not a value, so the entry of
+ * the key "style" has the properties instead.
+ */
 struct Entry {
 	char * key;
 	Value * value;
+	StyleProperties * style;
 };
 
 struct Entries {
@@ -164,29 +268,42 @@ struct Entries {
 struct Array {
 	Value ** elements;
 	int count;
+	uint64_t hash;
+	unsigned int references;
 };
 
+/**
+ * An element: the type is the one of its "type" entry, and the entries are
+ * those of the source, in order (see "ElementSchema"). The elements of the
+ * content of a page (not the page itself) are also lowered to an HTML element
+ * (see "createObject"), that borrows its attributes, style and content from
+ * the entries, and is released with them.
+ */
 struct Object {
 	char * type;
 	Entries * entries;
+	HTMLElement * element;
+	uint64_t hash;
+	unsigned int references;
 };
 
 /* Estructura base para todos los elementos HTML */
 struct HTMLElement {
 	HTMLElementType type;
-	Object* attributes;  // Para style, class, id, etc.
+	Object* attributes;  // El objeto del que se construyó (style, class, id, etc.)
+	StyleProperties* style;  // Se genera como una clase compartida (es el de "attributes")
 };
 
 /* Estructuras específicas para cada tipo de elemento */
 struct HTMLElementHTML {
 	HTMLElement base;
-	Object* head;
-	Object* body;
+	HTMLElementHead* head;
+	HTMLElementBody* body;
 };
 
 struct HTMLElementHead {
 	HTMLElement base;
-	Object* title;
+	HTMLElementTitle* title;
 };
 
 struct HTMLElementTitle {
@@ -201,7 +318,7 @@ struct HTMLElementBody {
 
 struct HTMLElementDiv {
 	HTMLElement base;
-	Array* content;
+	Value* content;
 };
 
 struct HTMLElementP {
@@ -216,25 +333,30 @@ struct HTMLElementH1 {
 
 struct HTMLElementImg {
 	HTMLElement base;
-	char* src;
-	char* alt;
+	Value* src;
+	Value* alt;
 };
 
+// Exactly one of the links is not NULL (see "ElementSchema").
 struct HTMLElementA {
 	HTMLElement base;
-	char* href;
-	char* ref;
-	char* extRef;
+	Value* href;
+	Value* ref;
+	Value* extRef;
 	Value* content;
 };
 
 struct HTMLElementCenter {
 	HTMLElement base;
-	Array* content;
+	Value* content;
 };
 
 struct Program {
 	HTMLElement * root;
+
+	// With "--check", the elements are not built, but the content of the body
+	// is kept instead, for the checks of the generation (see "checkProgram").
+	Value * content;
 };
 
 /**
@@ -0,0 +1,548 @@
+#include "AbstractSyntaxTreeCache.h"
+
+/* MODULE INTERNAL STATE */
+
+#define IMAGE_MAGIC "ASTIMAGE"
+
+typedef struct {
+	char magic[8];
+	char buildIdentifier[64];
+	uint64_t layoutFingerprint;
+	uint64_t sourceHash;
+	uint64_t length;
+	uint64_t relocationsOffset;
+	uint64_t relocationsCount;
+} ImageHeader;
+
+typedef struct {
+	const void * node;
+	uint64_t offset;
+} WrittenNode;
+
+// The layout of every node in an image: its size, and the offset of each
+// field read once it's loaded. The build identifier changes only if the
+// module that defines it is compiled again, so an incremental build that
+// changes a node would load stale images without this.
+static const size_t _layout[] = {
+	sizeof(Value), offsetof(Value, string), offsetof(Value, type), offsetof(Value, freeSlots), offsetof(Value, hash), offsetof(Value, references),
+	sizeof(Object), offsetof(Object, type), offsetof(Object, entries), offsetof(Object, element), offsetof(Object, hash), offsetof(Object, references),
+	sizeof(Entries), offsetof(Entries, entries), offsetof(Entries, count),
+	sizeof(Entry), offsetof(Entry, key), offsetof(Entry, value), offsetof(Entry, style),
+	sizeof(Array), offsetof(Array, elements), offsetof(Array, count), offsetof(Array, hash), offsetof(Array, references),
+	sizeof(Conditional), offsetof(Conditional, condition), offsetof(Conditional, consequent), offsetof(Conditional, alternative),
+	sizeof(Evaluation), offsetof(Evaluation, instructions), offsetof(Evaluation, count), offsetof(Evaluation, depth),
+	sizeof(Instruction), offsetof(Instruction, type), offsetof(Instruction, operand),
+	sizeof(Loop), offsetof(Loop, slot), offsetof(Loop, iterable), offsetof(Loop, body),
+	sizeof(StyleProperties), offsetof(StyleProperties, properties), offsetof(StyleProperties, count), offsetof(StyleProperties, declarations),
+	offsetof(StyleProperties, declarationsLength), offsetof(StyleProperties, hash), offsetof(StyleProperties, attribute),
+	sizeof(StyleProperty), offsetof(StyleProperty, key), offsetof(StyleProperty, value),
+	sizeof(StyleValue), offsetof(StyleValue, string), offsetof(StyleValue, type),
+	sizeof(HTMLElement), offsetof(HTMLElement, type), offsetof(HTMLElement, attributes), offsetof(HTMLElement, style),
+	sizeof(HTMLElementHTML), offsetof(HTMLElementHTML, head), offsetof(HTMLElementHTML, body),
+	sizeof(HTMLElementHead), offsetof(HTMLElementHead, title),
+	sizeof(HTMLElementTitle), offsetof(HTMLElementTitle, content),
+	sizeof(HTMLElementBody), offsetof(HTMLElementBody, content),
+	sizeof(HTMLElementDiv), offsetof(HTMLElementDiv, content),
+	sizeof(HTMLElementP), offsetof(HTMLElementP, content),
+	sizeof(HTMLElementH1), offsetof(HTMLElementH1, content),
+	sizeof(HTMLElementImg), offsetof(HTMLElementImg, src), offsetof(HTMLElementImg, alt),
+	sizeof(HTMLElementA), offsetof(HTMLElementA, href), offsetof(HTMLElementA, ref), offsetof(HTMLElementA, extRef), offsetof(HTMLElementA, content),
+	sizeof(HTMLElementCenter), offsetof(HTMLElementCenter, content),
+	sizeof(Program), offsetof(Program, root), offsetof(Program, content),
+	// The last tag of each enumeration stored in a node.
+	EXPRESSION_VALUE, HR_ELEMENT, EXPRESSION_STYLE
+};
+
+static Logger * _logger = NULL;
+
+// Serialization state (only valid during a call to "store...").
+static Buffer * _image = NULL;
+static Buffer * _relocations = NULL;
+static WrittenNode * _written = NULL;
+static unsigned int _writtenCapacity = 0;
+static unsigned int _writtenCount = 0;
+
+void initializeAbstractSyntaxTreeCacheModule() {
+	_logger = createLogger("AbstractSyntaxTreeCache");
+}
+
+void shutdownAbstractSyntaxTreeCacheModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static char * _imagePath(const char * directory, const uint64_t sourceHash);
+static uint64_t _layoutFingerprint(void);
+static uint64_t _findWritten(const void * node);
+static void _rememberWritten(const void * node, const uint64_t offset);
+static uint64_t _writeBlock(const void * bytes, const size_t size);
+static void _patch(const uint64_t fieldOffset, const uint64_t targetOffset);
+static uint64_t _writeString(const char * string);
+static uint64_t _writeValue(const Value * value);
+static uint64_t _writeObject(const Object * object);
+static uint64_t _writeEntries(const Entries * entries);
+static uint64_t _writeEntry(const Entry * entry);
+static uint64_t _writeArray(const Array * array);
+static uint64_t _writeConditional(const Conditional * conditional);
+static uint64_t _writeEvaluation(const Evaluation * evaluation);
+static uint64_t _writeLoop(const Loop * loop);
+static uint64_t _writeStyleProperties(const StyleProperties * properties);
+static uint64_t _writeHTMLElement(const HTMLElement * element);
+static size_t _sizeOfHTMLElement(const HTMLElementType type);
+static uint64_t _writeProgram(const Program * program);
+
+/**
+ * The path of the image of a source, using heap-memory.
+ */
+static char * _imagePath(const char * directory, const uint64_t sourceHash) {
+	char name[32];
+	snprintf(name, sizeof(name), "/%016llx.ast", (unsigned long long) sourceHash);
+	return concatenate(2, directory, name);
+}
+
+/**
+ * The hash of the layout of the nodes of this build.
+ */
+static uint64_t _layoutFingerprint(void) {
+	return hashBytes(_layout, sizeof(_layout), 0);
+}
+
+/**
+ * Returns the offset of an already serialized node (so shared nodes are
+ * written only once), or zero.
+ */
+static uint64_t _findWritten(const void * node) {
+	if (_writtenCount == 0) {
+		return 0;
+	}
+	const unsigned int mask = _writtenCapacity - 1;
+	for (unsigned int k = hashBytes(&node, sizeof(node), 0) & mask; _written[k].node != NULL; k = (k + 1) & mask) {
+		if (_written[k].node == node) {
+			return _written[k].offset;
+		}
+	}
+	return 0;
+}
+
+static void _rememberWritten(const void * node, const uint64_t offset) {
+	if (_writtenCapacity < 2 * (_writtenCount + 1)) {
+		WrittenNode * oldWritten = _written;
+		const unsigned int oldCapacity = _writtenCapacity;
+		_writtenCapacity = oldCapacity == 0 ? 1024 : 2 * oldCapacity;
+		_written = calloc(_writtenCapacity, sizeof(WrittenNode));
+		_writtenCount = 0;
+		for (unsigned int k = 0; k < oldCapacity; ++k) {
+			if (oldWritten[k].node != NULL) {
+				_rememberWritten(oldWritten[k].node, oldWritten[k].offset);
+			}
+		}
+		free(oldWritten);
+	}
+	const unsigned int mask = _writtenCapacity - 1;
+	unsigned int k = hashBytes(&node, sizeof(node), 0) & mask;
+	while (_written[k].node != NULL) {
+		k = (k + 1) & mask;
+	}
+	_written[k].node = node;
+	_written[k].offset = offset;
+	++_writtenCount;
+}
+
+/**
+ * Appends a copy of a node (or any block), aligned to 8 bytes, and returns
+ * its offset. The pointers inside it must be patched afterwards.
+ */
+static uint64_t _writeBlock(const void * bytes, const size_t size) {
+	static const char padding[8] = { 0 };
+	appendToBuffer(_image, padding, (8 - _image->length % 8) % 8);
+	const uint64_t offset = _image->length;
+	appendToBuffer(_image, bytes, size);
+	return offset;
+}
+
+/**
+ * Replaces the pointer stored at a field of the image with an offset, and
+ * registers it in the relocation table (unless it's NULL).
+ */
+static void _patch(const uint64_t fieldOffset, const uint64_t targetOffset) {
+	memcpy(_image->bytes + fieldOffset, &targetOffset, sizeof(uint64_t));
+	if (targetOffset != 0) {
+		appendToBuffer(_relocations, (const char *) &fieldOffset, sizeof(uint64_t));
+	}
+}
+
+static uint64_t _writeString(const char * string) {
+	if (string == NULL) {
+		return 0;
+	}
+	uint64_t offset = _findWritten(string);
+	if (offset == 0) {
+		offset = _writeBlock(string, 1 + strlen(string));
+		_rememberWritten(string, offset);
+	}
+	return offset;
+}
+
+static uint64_t _writeValue(const Value * value) {
+	if (value == NULL) {
+		return 0;
+	}
+	uint64_t offset = _findWritten(value);
+	if (offset != 0) {
+		return offset;
+	}
+	offset = _writeBlock(value, sizeof(Value));
+	_rememberWritten(value, offset);
+	switch (value->type) {
+		case STRING_VALUE:
+		case INCLUDE_VALUE:
+			_patch(offset + offsetof(Value, string), _writeString(value->string));
+			break;
+		case OBJECT_VALUE:
+			_patch(offset + offsetof(Value, object), _writeObject(value->object));
+			break;
+		case ARRAY_VALUE:
+			_patch(offset + offsetof(Value, array), _writeArray(value->array));
+			break;
+		case FOR_VALUE:
+			_patch(offset + offsetof(Value, loop), _writeLoop(value->loop));
+			break;
+		case IF_VALUE:
+			_patch(offset + offsetof(Value, conditional), _writeConditional(value->conditional));
+			break;
+		case EXPRESSION_VALUE:
+			_patch(offset + offsetof(Value, evaluation), _writeEvaluation(value->evaluation));
+			break;
+		default:
+			break;
+	}
+	return offset;
+}
+
+static uint64_t _writeObject(const Object * object) {
+	if (object == NULL) {
+		return 0;
+	}
+	uint64_t offset = _findWritten(object);
+	if (offset != 0) {
+		return offset;
+	}
+	offset = _writeBlock(object, sizeof(Object));
+	_rememberWritten(object, offset);
+	_patch(offset + offsetof(Object, type), _writeString(object->type));
+	_patch(offset + offsetof(Object, entries), _writeEntries(object->entries));
+	_patch(offset + offsetof(Object, element), _writeHTMLElement(object->element));
+	return offset;
+}
+
+static uint64_t _writeEntries(const Entries * entries) {
+	if (entries == NULL) {
+		return 0;
+	}
+	const uint64_t offset = _writeBlock(entries, sizeof(Entries));
+	if (0 < entries->count) {
+		const uint64_t arrayOffset = _writeBlock(entries->entries, entries->count * sizeof(Entry *));
+		for (int k = 0; k < entries->count; ++k) {
+			_patch(arrayOffset + k * sizeof(Entry *), _writeEntry(entries->entries[k]));
+		}
+		_patch(offset + offsetof(Entries, entries), arrayOffset);
+	}
+	else {
+		_patch(offset + offsetof(Entries, entries), 0);
+	}
+	return offset;
+}
+
+static uint64_t _writeEntry(const Entry * entry) {
+	if (entry == NULL) {
+		return 0;
+	}
+	const uint64_t offset = _writeBlock(entry, sizeof(Entry));
+	_patch(offset + offsetof(Entry, key), _writeString(entry->key));
+	_patch(offset + offsetof(Entry, value), _writeValue(entry->value));
+	_patch(offset + offsetof(Entry, style), _writeStyleProperties(entry->style));
+	return offset;
+}
+
+static uint64_t _writeArray(const Array * array) {
+	if (array == NULL) {
+		return 0;
+	}
+	uint64_t offset = _findWritten(array);
+	if (offset != 0) {
+		return offset;
+	}
+	offset = _writeBlock(array, sizeof(Array));
+	_rememberWritten(array, offset);
+	if (0 < array->count) {
+		const uint64_t elementsOffset = _writeBlock(array->elements, array->count * sizeof(Value *));
+		for (int k = 0; k < array->count; ++k) {
+			_patch(elementsOffset + k * sizeof(Value *), _writeValue(array->elements[k]));
+		}
+		_patch(offset + offsetof(Array, elements), elementsOffset);
+	}
+	else {
+		_patch(offset + offsetof(Array, elements), 0);
+	}
+	return offset;
+}
+
+static uint64_t _writeConditional(const Conditional * conditional) {
+	const uint64_t offset = _writeBlock(conditional, sizeof(Conditional));
+	_patch(offset + offsetof(Conditional, condition), _writeValue(conditional->condition));
+	_patch(offset + offsetof(Conditional, consequent), _writeValue(conditional->consequent));
+	_patch(offset + offsetof(Conditional, alternative), _writeValue(conditional->alternative));
+	return offset;
+}
+
+static uint64_t _writeEvaluation(const Evaluation * evaluation) {
+	const uint64_t offset = _writeBlock(evaluation, sizeof(Evaluation));
+	const uint64_t instructionsOffset = _writeBlock(evaluation->instructions, evaluation->count * sizeof(Instruction));
+	for (unsigned int k = 0; k < evaluation->count; ++k) {
+		_patch(instructionsOffset + k * sizeof(Instruction) + offsetof(Instruction, operand), _writeValue(evaluation->instructions[k].operand));
+	}
+	_patch(offset + offsetof(Evaluation, instructions), instructionsOffset);
+	return offset;
+}
+
+static uint64_t _writeLoop(const Loop * loop) {
+	const uint64_t offset = _writeBlock(loop, sizeof(Loop));
+	_patch(offset + offsetof(Loop, iterable), _writeValue(loop->iterable));
+	_patch(offset + offsetof(Loop, body), _writeValue(loop->body));
+	return offset;
+}
+
+static uint64_t _writeStyleProperties(const StyleProperties * properties) {
+	if (properties == NULL) {
+		return 0;
+	}
+	// The style of an element is also the one of its attributes.
+	uint64_t offset = _findWritten(properties);
+	if (offset != 0) {
+		return offset;
+	}
+	offset = _writeBlock(properties, sizeof(StyleProperties));
+	_rememberWritten(properties, offset);
+	const uint64_t itemsOffset = _writeBlock(properties->properties, properties->count * sizeof(StyleProperty *));
+	for (int k = 0; k < properties->count; ++k) {
+		const StyleProperty * property = properties->properties[k];
+		const uint64_t propertyOffset = _writeBlock(property, sizeof(StyleProperty));
+		const uint64_t valueOffset = _writeBlock(property->value, sizeof(StyleValue));
+		switch (property->value->type) {
+			case STRING_STYLE:
+			case CSS_KEYWORD_STYLE:
+				_patch(valueOffset + offsetof(StyleValue, string), _writeString(property->value->string));
+				break;
+			case EXPRESSION_STYLE:
+				_patch(valueOffset + offsetof(StyleValue, expression), _writeValue(property->value->expression));
+				break;
+			default:
+				break;
+		}
+		_patch(propertyOffset + offsetof(StyleProperty, key), _writeString(property->key));
+		_patch(propertyOffset + offsetof(StyleProperty, value), valueOffset);
+		_patch(itemsOffset + k * sizeof(StyleProperty *), propertyOffset);
+	}
+	_patch(offset + offsetof(StyleProperties, properties), properties->count == 0 ? 0 : itemsOffset);
+	_patch(offset + offsetof(StyleProperties, declarations), _writeString(properties->declarations));
+	_patch(offset + offsetof(StyleProperties, attribute), _writeString(properties->attribute));
+	return offset;
+}
+
+/**
+ * The size of the concrete structure of each type of HTML element.
+ */
+static size_t _sizeOfHTMLElement(const HTMLElementType type) {
+	switch (type) {
+		case HTML_ELEMENT: return sizeof(HTMLElementHTML);
+		case HEAD_ELEMENT: return sizeof(HTMLElementHead);
+		case TITLE_ELEMENT: return sizeof(HTMLElementTitle);
+		case BODY_ELEMENT: return sizeof(HTMLElementBody);
+		case DIV_ELEMENT: return sizeof(HTMLElementDiv);
+		case P_ELEMENT: return sizeof(HTMLElementP);
+		case H1_ELEMENT: return sizeof(HTMLElementH1);
+		case IMG_ELEMENT: return sizeof(HTMLElementImg);
+		case A_ELEMENT: return sizeof(HTMLElementA);
+		case CENTER_ELEMENT: return sizeof(HTMLElementCenter);
+		default:
+			return sizeof(HTMLElement);
+	}
+}
+
+static uint64_t _writeHTMLElement(const HTMLElement * element) {
+	if (element == NULL) {
+		return 0;
+	}
+	const uint64_t offset = _writeBlock(element, _sizeOfHTMLElement(element->type));
+	_patch(offset + offsetof(HTMLElement, attributes), _writeObject(element->attributes));
+	_patch(offset + offsetof(HTMLElement, style), _writeStyleProperties(element->style));
+	switch (element->type) {
+		case HTML_ELEMENT:
+			_patch(offset + offsetof(HTMLElementHTML, head), _writeHTMLElement((HTMLElement *) ((HTMLElementHTML *) element)->head));
+			_patch(offset + offsetof(HTMLElementHTML, body), _writeHTMLElement((HTMLElement *) ((HTMLElementHTML *) element)->body));
+			break;
+		case HEAD_ELEMENT:
+			_patch(offset + offsetof(HTMLElementHead, title), _writeHTMLElement((HTMLElement *) ((HTMLElementHead *) element)->title));
+			break;
+		case TITLE_ELEMENT:
+			_patch(offset + offsetof(HTMLElementTitle, content), _writeString(((HTMLElementTitle *) element)->content));
+			break;
+		case BODY_ELEMENT:
+			_patch(offset + offsetof(HTMLElementBody, content), _writeArray(((HTMLElementBody *) element)->content));
+			break;
+		case DIV_ELEMENT:
+			_patch(offset + offsetof(HTMLElementDiv, content), _writeValue(((HTMLElementDiv *) element)->content));
+			break;
+		case CENTER_ELEMENT:
+			_patch(offset + offsetof(HTMLElementCenter, content), _writeValue(((HTMLElementCenter *) element)->content));
+			break;
+		case P_ELEMENT:
+			_patch(offset + offsetof(HTMLElementP, content), _writeValue(((HTMLElementP *) element)->content));
+			break;
+		case H1_ELEMENT:
+			_patch(offset + offsetof(HTMLElementH1, content), _writeValue(((HTMLElementH1 *) element)->content));
+			break;
+		case IMG_ELEMENT:
+			_patch(offset + offsetof(HTMLElementImg, src), _writeValue(((HTMLElementImg *) element)->src));
+			_patch(offset + offsetof(HTMLElementImg, alt), _writeValue(((HTMLElementImg *) element)->alt));
+			break;
+		case A_ELEMENT:
+			_patch(offset + offsetof(HTMLElementA, href), _writeValue(((HTMLElementA *) element)->href));
+			_patch(offset + offsetof(HTMLElementA, ref), _writeValue(((HTMLElementA *) element)->ref));
+			_patch(offset + offsetof(HTMLElementA, extRef), _writeValue(((HTMLElementA *) element)->extRef));
+			_patch(offset + offsetof(HTMLElementA, content), _writeValue(((HTMLElementA *) element)->content));
+			break;
+		default:
+			break;
+	}
+	return offset;
+}
+
+static uint64_t _writeProgram(const Program * program) {
+	const uint64_t offset = _writeBlock(program, sizeof(Program));
+	_patch(offset + offsetof(Program, root), _writeHTMLElement(program->root));
+	_patch(offset + offsetof(Program, content), _writeValue(program->content));
+	return offset;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Program * loadCachedAbstractSyntaxTree(const char * directory, const uint64_t sourceHash) {
+	const double start = monotonicTime();
+	char * path = _imagePath(directory, sourceHash);
+	const int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0) {
+		free(path);
+		addToStatistic("ast-cache.misses", 1);
+		return NULL;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) < 0 || status.st_size < (off_t) sizeof(ImageHeader)) {
+		free(path);
+		close(descriptor);
+		addToStatistic("ast-cache.misses", 1);
+		return NULL;
+	}
+	// A private mapping is copy-on-write: relocating never touches the file.
+	char * image = mmap(NULL, status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if (image == MAP_FAILED) {
+		free(path);
+		addToStatistic("ast-cache.misses", 1);
+		return NULL;
+	}
+	const ImageHeader * header = (const ImageHeader *) image;
+	const boolean valid = memcmp(header->magic, IMAGE_MAGIC, sizeof(header->magic)) == 0
+		&& strncmp(header->buildIdentifier, compilerBuildIdentifier(), sizeof(header->buildIdentifier)) == 0
+		&& header->layoutFingerprint == _layoutFingerprint()
+		&& header->sourceHash == sourceHash
+		&& header->length == (uint64_t) status.st_size
+		&& header->relocationsOffset + header->relocationsCount * sizeof(uint64_t) <= header->length;
+	if (!valid) {
+		logWarning(_logger, "Ignoring an invalid or stale AST image (hash = %016llx).", (unsigned long long) sourceHash);
+		free(path);
+		munmap(image, status.st_size);
+		addToStatistic("ast-cache.misses", 1);
+		return NULL;
+	}
+	// Refreshes the recency of the image (used by the eviction of the cache).
+	utimensat(AT_FDCWD, path, NULL, 0);
+	free(path);
+	const uint64_t * relocations = (const uint64_t *) (image + header->relocationsOffset);
+	for (uint64_t k = 0; k < header->relocationsCount; ++k) {
+		uint64_t target;
+		memcpy(&target, image + relocations[k], sizeof(uint64_t));
+		char * pointer = image + target;
+		memcpy(image + relocations[k], &pointer, sizeof(char *));
+	}
+	addToStatistic("ast-cache.hits", 1);
+	addToStatistic("ast-cache.load-time", monotonicTime() - start);
+	logDebugging(_logger, "AST image loaded (%llu bytes, %llu relocations).",
+		(unsigned long long) header->length, (unsigned long long) header->relocationsCount);
+	return (Program *) (image + sizeof(ImageHeader));
+}
+
+void releaseCachedAbstractSyntaxTree(Program * program) {
+	if (program != NULL) {
+		const ImageHeader * header = (const ImageHeader *) ((char *) program - sizeof(ImageHeader));
+		munmap((void *) header, header->length);
+	}
+}
+
+boolean storeCachedAbstractSyntaxTree(const char * directory, const uint64_t sourceHash, Program * program) {
+	if (program == NULL) {
+		return false;
+	}
+	const double start = monotonicTime();
+	ImageHeader header;
+	memset(&header, 0, sizeof(ImageHeader));
+	memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+	strncpy(header.buildIdentifier, compilerBuildIdentifier(), sizeof(header.buildIdentifier) - 1);
+	header.layoutFingerprint = _layoutFingerprint();
+	header.sourceHash = sourceHash;
+
+	_image = createBuffer(64 * 1024);
+	_relocations = createBuffer(16 * 1024);
+	appendToBuffer(_image, (const char *) &header, sizeof(ImageHeader));
+	_writeProgram(program);
+	const uint64_t relocationsOffset = _writeBlock(_relocations->bytes, _relocations->length);
+	ImageHeader * imageHeader = (ImageHeader *) _image->bytes;
+	imageHeader->length = _image->length;
+	imageHeader->relocationsOffset = relocationsOffset;
+	imageHeader->relocationsCount = _relocations->length / sizeof(uint64_t);
+
+	// Written aside and renamed, so a concurrent reader never sees half an image.
+	mkdir(directory, 0755);
+	char * path = _imagePath(directory, sourceHash);
+	char temporarySuffix[32];
+	snprintf(temporarySuffix, sizeof(temporarySuffix), ".%ld.tmp", (long) getpid());
+	char * temporaryPath = concatenate(2, path, temporarySuffix);
+	FILE * file = fopen(temporaryPath, "wb");
+	boolean succeed = false;
+	if (file != NULL) {
+		succeed = fwrite(_image->bytes, sizeof(char), _image->length, file) == _image->length;
+		succeed = fclose(file) == 0 && succeed;
+		succeed = succeed && rename(temporaryPath, path) == 0;
+	}
+	if (!succeed) {
+		logWarning(_logger, "Cannot write the AST image: %s", path);
+		remove(temporaryPath);
+	}
+	else {
+		addToStatistic("ast-cache.store-time", monotonicTime() - start);
+	}
+	free(temporaryPath);
+	free(path);
+	free(_written);
+	_written = NULL;
+	_writtenCapacity = 0;
+	_writtenCount = 0;
+	destroyBuffer(_relocations);
+	destroyBuffer(_image);
+	_relocations = NULL;
+	_image = NULL;
+	return succeed;
+}
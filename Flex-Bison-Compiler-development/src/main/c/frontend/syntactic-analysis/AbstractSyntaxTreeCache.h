@@ -0,0 +1,56 @@
+#ifndef ABSTRACT_SYNTAX_TREE_CACHE_HEADER
+#define ABSTRACT_SYNTAX_TREE_CACHE_HEADER
+
+#include "../../shared/Buffer.h"
+#include "../../shared/Hash.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Statistics.h"
+#include "../../shared/Type.h"
+#include "../../shared/Version.h"
+#include "AbstractSyntaxTree.h"
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+void initializeAbstractSyntaxTreeCacheModule();
+
+/** Shutdown module's internal state. */
+void shutdownAbstractSyntaxTreeCacheModule();
+
+/**
+ * A binary, position-independent image of an AST. Every node is stored with
+ * the same layout it has in memory, but its pointers are replaced by offsets
+ * from the beginning of the image (zero means NULL), and the location of each
+ * one of those offsets is listed in a relocation table.
+ *
+ * To load an image, the file is mapped privately (copy-on-write) and every
+ * offset is converted back into a pointer in place, so the backend runs
+ * directly over the mapped tree, without Flex, Bison nor any allocation.
+ */
+
+/**
+ * Loads the cached AST of the source with the specified hash, if a valid
+ * image exists in the directory. Returns NULL otherwise. The returned tree
+ * must be released with "releaseCachedAbstractSyntaxTree".
+ */
+Program * loadCachedAbstractSyntaxTree(const char * directory, const uint64_t sourceHash);
+
+/**
+ * Releases a tree loaded with "loadCachedAbstractSyntaxTree".
+ */
+void releaseCachedAbstractSyntaxTree(Program * program);
+
+/**
+ * Serializes the AST into an image in the specified directory (created if
+ * needed), keyed by the hash of its source. Returns true if the image was successfully written.
+ */
+boolean storeCachedAbstractSyntaxTree(const char * directory, const uint64_t sourceHash, Program * program);
+
+#endif
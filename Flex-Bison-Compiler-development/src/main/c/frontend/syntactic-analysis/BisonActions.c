@@ -20,7 +20,48 @@ extern unsigned int flexCurrentContext(void);
 
 /* PRIVATE FUNCTIONS */
 
+static void _appendOperand(Evaluation * evaluation, Value * operand);
+static Value * _entryValue(const Object * object, const char * key);
 static void _logSyntacticAnalyzerAction(const char * functionName);
+static HTMLElement * _lowerElement(Object * object);
+static char * _normalizeStyleKey(const char * key);
+static Object * _retainObject(Object * object);
+static uint64_t _slotsOfArray(const Array * array);
+static uint64_t _slotsOfObject(const Object * object);
+static uint64_t _slotsOfValue(const Value * value);
+
+/**
+ * Appends the instructions that push an operand to an evaluation (if the
+ * operand is an expression, its own instructions), and releases it.
+ */
+static void _appendOperand(Evaluation * evaluation, Value * operand) {
+	const unsigned int count = operand->type == EXPRESSION_VALUE ? operand->evaluation->count : 1;
+	evaluation->instructions = realloc(evaluation->instructions, (evaluation->count + count) * sizeof(Instruction));
+	if (operand->type == EXPRESSION_VALUE) {
+		for (unsigned int k = 0; k < count; ++k) {
+			const Instruction instruction = operand->evaluation->instructions[k];
+			if (instruction.operand != NULL) {
+				++instruction.operand->references;
+			}
+			evaluation->instructions[evaluation->count++] = instruction;
+		}
+		releaseValue(operand);
+	}
+	else {
+		evaluation->instructions[evaluation->count++] = (Instruction) {
+			.type = FACTOR,
+			.operand = operand
+		};
+	}
+}
+
+/**
+ * The value of the entry of an object with a key, or NULL if it has none.
+ */
+static Value * _entryValue(const Object * object, const char * key) {
+	const Entry * entry = findElementEntry(object, key);
+	return entry == NULL ? NULL : entry->value;
+}
 
 /**
  * Logs a syntactic-analyzer action in DEBUGGING level.
@@ -29,6 +70,115 @@ static void _logSyntacticAnalyzerAction(const char * functionName) {
 	logDebugging(_logger, "%s", functionName);
 }
 
+/**
+ * Lowers an element of the content of a page to its HTML element, or returns
+ * NULL if it's not one (e.g., the page itself, that is lowered as a whole by
+ * "PageSemanticAction"). The element borrows everything from the object, so
+ * it takes no references.
+ */
+static HTMLElement * _lowerElement(Object * object) {
+	Value * content = _entryValue(object, "content");
+	HTMLElement * element = NULL;
+	if (object->type == NULL) {
+		return NULL;
+	}
+	else if (strcmp(object->type, "div") == 0) {
+		element = &createHTMLElementDiv(content)->base;
+	}
+	else if (strcmp(object->type, "p") == 0) {
+		element = &createHTMLElementP(content)->base;
+	}
+	else if (strcmp(object->type, "h1") == 0) {
+		element = &createHTMLElementH1(content)->base;
+	}
+	else if (strcmp(object->type, "img") == 0) {
+		element = &createHTMLElementImg(_entryValue(object, "src"), _entryValue(object, "alt"))->base;
+	}
+	else if (strcmp(object->type, "a") == 0) {
+		element = &createHTMLElementA(_entryValue(object, "href"), _entryValue(object, "ref"), _entryValue(object, "ext-ref"), content)->base;
+	}
+	else if (strcmp(object->type, "center") == 0) {
+		element = &createHTMLElementCenter(content)->base;
+	}
+	else {
+		return NULL;
+	}
+	const Entry * styleEntry = findElementEntry(object, "style");
+	element->attributes = object;
+	element->style = styleEntry == NULL ? NULL : styleEntry->style;
+	return element;
+}
+
+/**
+ * The CSS name of a style key, using heap-memory: in lowercase, and with
+ * words separated by hyphens (so "backgroundColor", "background_color" and
+ * "background-color" are the same property).
+ */
+static char * _normalizeStyleKey(const char * key) {
+	char * normalized = malloc(2 * strlen(key) + 1);
+	size_t length = 0;
+	for (const char * character = key; *character != '\0'; ++character) {
+		if (isupper((unsigned char) *character)) {
+			if (0 < length && normalized[length - 1] != '-') {
+				normalized[length++] = '-';
+			}
+			normalized[length++] = tolower((unsigned char) *character);
+		}
+		else {
+			normalized[length++] = *character == '_' ? '-' : *character;
+		}
+	}
+	normalized[length] = '\0';
+	return normalized;
+}
+
+/**
+ * Takes a reference to an object (hash-consed, so it may be shared).
+ */
+static Object * _retainObject(Object * object) {
+	++object->references;
+	return object;
+}
+
+/**
+ * The loop variables used by the elements of an array.
+ */
+static uint64_t _slotsOfArray(const Array * array) {
+	uint64_t slots = 0;
+	if (array != NULL) {
+		for (int k = 0; k < array->count; ++k) {
+			slots |= _slotsOfValue(array->elements[k]);
+		}
+	}
+	return slots;
+}
+
+/**
+ * The loop variables used by the values of the entries of an object, and by
+ * those of its style.
+ */
+static uint64_t _slotsOfObject(const Object * object) {
+	uint64_t slots = 0;
+	if (object != NULL && object->entries != NULL) {
+		for (int k = 0; k < object->entries->count; ++k) {
+			const Entry * entry = object->entries->entries[k];
+			slots |= entry == NULL ? 0 : _slotsOfValue(entry->value);
+			for (int j = 0; entry != NULL && entry->style != NULL && j < entry->style->count; ++j) {
+				const StyleValue * styleValue = entry->style->properties[j]->value;
+				slots |= styleValue->type == EXPRESSION_STYLE ? _slotsOfValue(styleValue->expression) : 0;
+			}
+		}
+	}
+	return slots;
+}
+
+/**
+ * The loop variables used by a value (none, if there is no value).
+ */
+static uint64_t _slotsOfValue(const Value * value) {
+	return value == NULL ? 0 : value->freeSlots;
+}
+
 /* PUBLIC FUNCTIONS */
 
 // Acciones para valores
@@ -37,15 +187,15 @@ Value* createStringValue(char* string) {
 	Value* value = calloc(1, sizeof(Value));
 	value->type = STRING_VALUE;
 	value->string = string;
-	return value;
+	return internValue(value);
 }
 
-Value* createIntegerValue(int integer) {
+Value* createIntegerValue(int64_t integer) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	Value* value = calloc(1, sizeof(Value));
 	value->type = INTEGER_VALUE;
 	value->integer = integer;
-	return value;
+	return internValue(value);
 }
 
 Value* createRealValue(double real) {
@@ -53,7 +203,7 @@ Value* createRealValue(double real) {
 	Value* value = calloc(1, sizeof(Value));
 	value->type = REAL_VALUE;
 	value->real = real;
-	return value;
+	return internValue(value);
 }
 
 Value* createBooleanValue(int boolean) {
@@ -61,14 +211,14 @@ Value* createBooleanValue(int boolean) {
 	Value* value = calloc(1, sizeof(Value));
 	value->type = BOOLEAN_VALUE;
 	value->boolean = boolean;
-	return value;
+	return internValue(value);
 }
 
 Value* createNullValue() {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	Value* value = calloc(1, sizeof(Value));
 	value->type = NULL_VALUE;
-	return value;
+	return internValue(value);
 }
 
 Value* createObjectValue(Object* object) {
@@ -76,15 +226,90 @@ Value* createObjectValue(Object* object) {
 	Value* value = calloc(1, sizeof(Value));
 	value->type = OBJECT_VALUE;
 	value->object = object;
-	return value;
+	value->freeSlots = _slotsOfObject(object);
+	return internValue(value);
 }
 
 Value* createArrayValue(Array* array) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	Value* value = calloc(1, sizeof(Value));
 	value->type = ARRAY_VALUE;
-	value->array = array;
-	return value;
+	value->array = array == NULL ? NULL : internArray(array);
+	value->freeSlots = _slotsOfArray(value->array);
+	return internValue(value);
+}
+
+Value* createIncludeValue(char* name) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	// The name is a string lexeme, so it's quoted.
+	const size_t length = strlen(name);
+	if (2 <= length && name[0] == '"') {
+		memmove(name, name + 1, length - 2);
+		name[length - 2] = '\0';
+	}
+	Value* value = calloc(1, sizeof(Value));
+	value->type = INCLUDE_VALUE;
+	value->string = name;
+	return internValue(value);
+}
+
+Value* createLoopValue(const unsigned int slot, Value* iterable, Value* body) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	Loop* loop = calloc(1, sizeof(Loop));
+	loop->slot = slot;
+	loop->iterable = iterable;
+	loop->body = body;
+	Value* value = calloc(1, sizeof(Value));
+	value->type = FOR_VALUE;
+	value->loop = loop;
+	// The loop binds its own variable, so only the outer ones remain free.
+	value->freeSlots = _slotsOfValue(iterable) | (_slotsOfValue(body) & ~(UINT64_C(1) << slot));
+	return internValue(value);
+}
+
+Value* createConditionalValue(Value* condition, Value* consequent, Value* alternative) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	Conditional* conditional = calloc(1, sizeof(Conditional));
+	conditional->condition = condition;
+	conditional->consequent = consequent;
+	conditional->alternative = alternative;
+	Value* value = calloc(1, sizeof(Value));
+	value->type = IF_VALUE;
+	value->conditional = conditional;
+	value->freeSlots = _slotsOfValue(condition) | _slotsOfValue(consequent) | _slotsOfValue(alternative);
+	return internValue(value);
+}
+
+Value* createSlotValue(const unsigned int slot) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	Value* value = calloc(1, sizeof(Value));
+	value->type = SLOT_VALUE;
+	value->slot = slot;
+	value->freeSlots = UINT64_C(1) << slot;
+	return internValue(value);
+}
+
+Value* createExpressionValue(Value* leftValue, Value* rightValue, const ExpressionType type) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	// In postfix order, the right operand is evaluated over the left one.
+	const unsigned int leftDepth = leftValue->type == EXPRESSION_VALUE ? leftValue->evaluation->depth : 1;
+	const unsigned int rightDepth = rightValue == NULL ? 0 : rightValue->type == EXPRESSION_VALUE ? rightValue->evaluation->depth : 1;
+	Evaluation* evaluation = calloc(1, sizeof(Evaluation));
+	evaluation->depth = leftDepth < 1 + rightDepth ? 1 + rightDepth : leftDepth;
+	Value* value = calloc(1, sizeof(Value));
+	value->type = EXPRESSION_VALUE;
+	value->evaluation = evaluation;
+	value->freeSlots = _slotsOfValue(leftValue) | _slotsOfValue(rightValue);
+	_appendOperand(evaluation, leftValue);
+	if (rightValue != NULL) {
+		_appendOperand(evaluation, rightValue);
+	}
+	evaluation->instructions = realloc(evaluation->instructions, (evaluation->count + 1) * sizeof(Instruction));
+	evaluation->instructions[evaluation->count++] = (Instruction) {
+		.type = type,
+		.operand = NULL
+	};
+	return internValue(value);
 }
 
 // Acciones para estilos
@@ -96,7 +321,7 @@ StyleValue* createStringStyleValue(char* string) {
 	return value;
 }
 
-StyleValue* createIntegerStyleValue(int integer) {
+StyleValue* createIntegerStyleValue(int64_t integer) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	StyleValue* value = calloc(1, sizeof(StyleValue));
 	value->type = INTEGER_STYLE;
@@ -120,6 +345,14 @@ StyleValue* createCSSKeywordStyleValue(char* keyword) {
 	return value;
 }
 
+StyleValue* createExpressionStyleValue(Value* expression) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	StyleValue* value = calloc(1, sizeof(StyleValue));
+	value->type = EXPRESSION_STYLE;
+	value->expression = expression;
+	return value;
+}
+
 StyleProperty* createStyleProperty(char* key, StyleValue* value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	StyleProperty* property = calloc(1, sizeof(StyleProperty));
@@ -152,6 +385,14 @@ Entry* createEntry(char* key, Value* value) {
 	return entry;
 }
 
+Entry* createStyleEntry(StyleProperties* style) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	Entry* entry = calloc(1, sizeof(Entry));
+	entry->key = strdup("style");
+	entry->style = style;
+	return entry;
+}
+
 Entries* createEntries() {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	Entries* entries = calloc(1, sizeof(Entries));
@@ -189,6 +430,11 @@ Object* createObject(char* type, Entries* entries) {
 	Object* object = calloc(1, sizeof(Object));
 	object->type = type;
 	object->entries = entries;
+	object = internObject(object);
+	if (object->element == NULL) {
+		// The canonical object is lowered only once.
+		object->element = _lowerElement(object);
+	}
 	return object;
 }
 
@@ -201,40 +447,44 @@ HTMLElement* createHTMLElement(HTMLElementType type, Object* attributes) {
 	return element;
 }
 
-HTMLElementHTML* createHTMLElementHTML(Object* head, Object* body) {
+HTMLElementHTML* createHTMLElementHTML(Object* attributes, HTMLElementHead* head, HTMLElementBody* body) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	HTMLElementHTML* element = calloc(1, sizeof(HTMLElementHTML));
 	element->base.type = HTML_ELEMENT;
+	element->base.attributes = attributes;
 	element->head = head;
 	element->body = body;
 	return element;
 }
 
-HTMLElementHead* createHTMLElementHead(Object* title) {
+HTMLElementHead* createHTMLElementHead(Object* attributes, HTMLElementTitle* title) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	HTMLElementHead* element = calloc(1, sizeof(HTMLElementHead));
 	element->base.type = HEAD_ELEMENT;
+	element->base.attributes = attributes;
 	element->title = title;
 	return element;
 }
 
-HTMLElementTitle* createHTMLElementTitle(char* content) {
+HTMLElementTitle* createHTMLElementTitle(Object* attributes, char* content) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	HTMLElementTitle* element = calloc(1, sizeof(HTMLElementTitle));
 	element->base.type = TITLE_ELEMENT;
+	element->base.attributes = attributes;
 	element->content = content;
 	return element;
 }
 
-HTMLElementBody* createHTMLElementBody(Array* content) {
+HTMLElementBody* createHTMLElementBody(Object* attributes, Array* content) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	HTMLElementBody* element = calloc(1, sizeof(HTMLElementBody));
 	element->base.type = BODY_ELEMENT;
+	element->base.attributes = attributes;
 	element->content = content;
 	return element;
 }
 
-HTMLElementDiv* createHTMLElementDiv(Array* content) {
+HTMLElementDiv* createHTMLElementDiv(Value* content) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	HTMLElementDiv* element = calloc(1, sizeof(HTMLElementDiv));
 	element->base.type = DIV_ELEMENT;
@@ -258,7 +508,7 @@ HTMLElementH1* createHTMLElementH1(Value* content) {
 	return element;
 }
 
-HTMLElementImg* createHTMLElementImg(char* src, char* alt) {
+HTMLElementImg* createHTMLElementImg(Value* src, Value* alt) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	HTMLElementImg* element = calloc(1, sizeof(HTMLElementImg));
 	element->base.type = IMG_ELEMENT;
@@ -267,7 +517,7 @@ HTMLElementImg* createHTMLElementImg(char* src, char* alt) {
 	return element;
 }
 
-HTMLElementA* createHTMLElementA(char* href, char* ref, char* extRef, Value* content) {
+HTMLElementA* createHTMLElementA(Value* href, Value* ref, Value* extRef, Value* content) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	HTMLElementA* element = calloc(1, sizeof(HTMLElementA));
 	element->base.type = A_ELEMENT;
@@ -278,7 +528,7 @@ HTMLElementA* createHTMLElementA(char* href, char* ref, char* extRef, Value* con
 	return element;
 }
 
-HTMLElementCenter* createHTMLElementCenter(Array* content) {
+HTMLElementCenter* createHTMLElementCenter(Value* content) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
 	HTMLElementCenter* element = calloc(1, sizeof(HTMLElementCenter));
 	element->base.type = CENTER_ELEMENT;
@@ -294,12 +544,304 @@ Program* createProgram(HTMLElement* root) {
 	return program;
 }
 
+void ProgramSemanticAction(CompilerState * compilerState, Program * program) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	compilerState->abstractSyntaxtTree = program;
+	compilerState->succeed = true;
+}
+
+Program * PageSemanticAction(CompilerState * compilerState, Object * root) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (strcmp(root->type, "html") != 0) {
+		logError(_logger, "The root of the page must be an \"html\" element, not a \"%s\" one.", root->type);
+		releaseObject(root);
+		return NULL;
+	}
+	if (compilerState->configuration.check) {
+		// The page is valid already, and its elements are only for the generator
+		// (but the content of the body is checked as it would be generated).
+		Program * program = createProgram(NULL);
+		program->content = findElementEntry(findChildElement(root, "body"), "content")->value;
+		++program->content->references;
+		releaseObject(root);
+		return program;
+	}
+	// The schema of each element was validated already (see "ObjectSemanticAction").
+	Object * head = findChildElement(root, "head");
+	Object * title = findElementEntry(head, "content")->value->object;
+	const Value * titleContent = findElementEntry(title, "content")->value;
+	char * text = NULL;
+	if (titleContent->type == STRING_VALUE) {
+		const size_t length = strlen(titleContent->string);
+		const boolean isQuoted = 2 <= length && titleContent->string[0] == '"';
+		text = isQuoted ? strndup(titleContent->string + 1, length - 2) : strdup(titleContent->string);
+	}
+	else {
+		text = strdup("");
+	}
+	Object * body = findChildElement(root, "body");
+	Value * bodyContent = findElementEntry(body, "content")->value;
+	Array * content = NULL;
+	if (bodyContent->type == ARRAY_VALUE && bodyContent->array != NULL) {
+		content = bodyContent->array;
+		++content->references;
+	}
+	else {
+		// A single element (or a loop, spliced as usual).
+		content = createArray();
+		++bodyContent->references;
+		addArrayElement(content, bodyContent);
+		content = internArray(content);
+	}
+	HTMLElementBody * bodyElement = createHTMLElementBody(_retainObject(body), content);
+	const Entry * styleEntry = findElementEntry(body, "style");
+	bodyElement->base.style = styleEntry == NULL ? NULL : styleEntry->style;
+	HTMLElementHead * headElement = createHTMLElementHead(_retainObject(head),
+		createHTMLElementTitle(_retainObject(title), text));
+	return createProgram(&createHTMLElementHTML(root, headElement, bodyElement)->base);
+}
+
+Object * ObjectSemanticAction(Entries * entries) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	const char * type = validateElement(entries);
+	if (type == NULL) {
+		releaseEntries(entries);
+		return NULL;
+	}
+	return createObject(strdup(type), entries);
+}
+
+Value * StandaloneValueSemanticAction(CompilerState * compilerState, Value * value) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	compilerState->abstractSyntaxtTree = value;
+	compilerState->succeed = true;
+	return value;
+}
+
+void EnterScopeSemanticAction(CompilerState * compilerState) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	enterScope(compilerState->symbolTable);
+	++compilerState->arrayDepth;
+}
+
+void LeaveScopeSemanticAction(CompilerState * compilerState) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	leaveScope(compilerState->symbolTable);
+	--compilerState->arrayDepth;
+}
+
+void ElementSemanticAction(CompilerState * compilerState, Value * element) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	// Only composite elements are worth generating ahead, and only those that
+	// are generated the same way everywhere (the elements of the body are
+	// those of an outermost array, and they don't use a loop variable).
+	if (compilerState->elements == NULL || element == NULL || compilerState->arrayDepth != 1 || element->freeSlots != 0
+			|| (element->type != OBJECT_VALUE && element->type != ARRAY_VALUE)) {
+		return;
+	}
+	// The reference is released by the generator, once it's done.
+	++element->references;
+	if (!pushToRingBuffer(compilerState->elements, &element)) {
+		releaseValue(element);
+	}
+}
+
+boolean VariableDeclarationSemanticAction(CompilerState * compilerState, char * name, Value * value) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	// The table interns its own copy of the name, and owns the reference.
+	const boolean declared = declareSymbol(compilerState->symbolTable, name, value);
+	if (!declared) {
+		logError(_logger, "The variable \"%s\" is already declared in the same scope.", name);
+		releaseValue(value);
+	}
+	free(name);
+	return declared;
+}
+
+Value * VariableReferenceSemanticAction(CompilerState * compilerState, char * name) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	Value * value = lookupSymbol(compilerState->symbolTable, name);
+	if (value == NULL) {
+		logError(_logger, "The variable \"%s\" is not declared.", name);
+	}
+	else {
+		// The value is shared (it's hash-consed), so each use is a reference.
+		++value->references;
+	}
+	free(name);
+	return value;
+}
+
+boolean EnterLoopSemanticAction(CompilerState * compilerState, char * variable) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (compilerState->loopDepth == MAXIMUM_LOOP_DEPTH) {
+		logError(_logger, "The loop of \"%s\" is nested too deep (the maximum is %d).", variable, MAXIMUM_LOOP_DEPTH);
+		free(variable);
+		return false;
+	}
+	// The body is a scope of its own, where the variable is a placeholder.
+	enterScope(compilerState->symbolTable);
+	declareSymbol(compilerState->symbolTable, variable, createSlotValue(compilerState->loopDepth++));
+	free(variable);
+	return true;
+}
+
+Value * LoopSemanticAction(CompilerState * compilerState, Value * iterable, Value * body) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	leaveScope(compilerState->symbolTable);
+	const unsigned int slot = --compilerState->loopDepth;
+	if (iterable->type != ARRAY_VALUE && iterable->freeSlots == 0) {
+		logError(_logger, "A loop can only iterate over an array.");
+		releaseValue(iterable);
+		releaseValue(body);
+		return NULL;
+	}
+	return createLoopValue(slot, iterable, body);
+}
+
+Value * ConditionalSemanticAction(Value * condition, Value * consequent, Value * alternative) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (condition->freeSlots != 0) {
+		// It depends on a loop variable, so it's decided on each iteration.
+		return createConditionalValue(condition, consequent, alternative);
+	}
+	if (condition->type != BOOLEAN_VALUE) {
+		logError(_logger, "The condition of an if must be a boolean.");
+		releaseValue(condition);
+		releaseValue(consequent);
+		releaseValue(alternative);
+		return NULL;
+	}
+	Value * chosen = condition->boolean ? consequent : alternative;
+	if (chosen == NULL) {
+		// Nothing is generated, but the value must still be there.
+		return createConditionalValue(condition, consequent, alternative);
+	}
+	releaseValue(condition);
+	releaseValue(chosen == consequent ? alternative : consequent);
+	return chosen;
+}
+
+Value * OperationSemanticAction(Value * leftValue, Value * rightValue, const ExpressionType type) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	const boolean isLogical = type == CONJUNCTION || type == DISJUNCTION;
+	if (leftValue->freeSlots != 0 || _slotsOfValue(rightValue) != 0) {
+		// A constant that decides a logical operation on its own still folds it.
+		Value * constant = leftValue->freeSlots == 0 ? leftValue : rightValue;
+		if (isLogical && constant->freeSlots == 0 && constant->type == BOOLEAN_VALUE && constant->boolean == (type == DISJUNCTION)) {
+			releaseValue(constant == leftValue ? rightValue : leftValue);
+			addToStatistic("expressions.folded", 1);
+			return constant;
+		}
+		return createExpressionValue(leftValue, rightValue, type);
+	}
+	Value result;
+	const boolean succeed = computeValueOperation(type, leftValue, rightValue, &result);
+	releaseValue(leftValue);
+	releaseValue(rightValue);
+	if (!succeed) {
+		return NULL;
+	}
+	addToStatistic("expressions.folded", 1);
+	switch (result.type) {
+		case BOOLEAN_VALUE: return createBooleanValue(result.boolean);
+		case REAL_VALUE: return createRealValue(result.real);
+		default: return createIntegerValue(result.integer);
+	}
+}
+
+StyleValue * StyleValueSemanticAction(Value * value) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	StyleValue * styleValue = NULL;
+	if (value->freeSlots != 0) {
+		// Evaluated on each iteration of the loops it depends on.
+		return createExpressionStyleValue(value);
+	}
+	switch (value->type) {
+		case STRING_VALUE:
+			styleValue = createStringStyleValue(strdup(value->string));
+			break;
+		case INTEGER_VALUE:
+			styleValue = createIntegerStyleValue(value->integer);
+			break;
+		case REAL_VALUE:
+			styleValue = createRealStyleValue(value->real);
+			break;
+		default:
+			logError(_logger, "A style value must be a string or a number.");
+			break;
+	}
+	releaseValue(value);
+	return styleValue;
+}
+
+StyleProperties * StyleSemanticAction(CompilerState * compilerState, StyleProperties * properties) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	StyleProperty ** items = properties->properties;
+	for (int k = 0; k < properties->count; ++k) {
+		char * key = _normalizeStyleKey(items[k]->key);
+		free(items[k]->key);
+		items[k]->key = key;
+	}
+	// An insertion sort is stable, so repeated keys keep their order.
+	for (int k = 1; k < properties->count; ++k) {
+		StyleProperty * property = items[k];
+		int j = k;
+		for (; 0 < j && 0 < strcmp(items[j - 1]->key, property->key); --j) {
+			items[j] = items[j - 1];
+		}
+		items[j] = property;
+	}
+	// As in CSS, the last declaration of a property wins.
+	boolean isConstant = true;
+	int count = 0;
+	for (int k = 0; k < properties->count; ++k) {
+		if (items[k]->value == NULL || (k + 1 < properties->count && strcmp(items[k]->key, items[k + 1]->key) == 0)) {
+			releaseStyleProperty(items[k]);
+			continue;
+		}
+		isConstant = isConstant && items[k]->value->type != EXPRESSION_STYLE;
+		items[count++] = items[k];
+	}
+	properties->count = count;
+	if (isConstant) {
+		Buffer * declarations = createBuffer(64);
+		for (int k = 0; k < count; ++k) {
+			appendStyleDeclaration(declarations, items[k]->key, items[k]->value);
+		}
+		properties->declarations = calloc(declarations->length + 1, sizeof(char));
+		memcpy(properties->declarations, declarations->bytes, declarations->length);
+		properties->declarationsLength = declarations->length;
+		properties->hash = hashBytes(declarations->bytes, declarations->length, 0);
+		// The declarations tell equal styles apart (see "internObject"), but the
+		// attribute is only written by the generator.
+		if (compilerState->configuration.check) {
+			destroyBuffer(declarations);
+			return properties;
+		}
+		Buffer * attribute = createBuffer(declarations->length + 16);
+		appendStyleAttribute(attribute, declarations->bytes, declarations->length);
+		properties->attribute = calloc(attribute->length + 1, sizeof(char));
+		memcpy(properties->attribute, attribute->bytes, attribute->length);
+		properties->attributeLength = attribute->length;
+		destroyBuffer(attribute);
+		destroyBuffer(declarations);
+	}
+	return properties;
+}
+
 // Funciones de liberación de memoria
 void releaseValue(Value* value) {
 	if (value == NULL) return;
-	
+	if (1 < value->references) {
+		--value->references;
+		return;
+	}
+	forgetValue(value);
+
 	switch (value->type) {
 		case STRING_VALUE:
+		case INCLUDE_VALUE:
 			free(value->string);
 			break;
 		case OBJECT_VALUE:
@@ -308,6 +850,24 @@ void releaseValue(Value* value) {
 		case ARRAY_VALUE:
 			releaseArray(value->array);
 			break;
+		case FOR_VALUE:
+			releaseValue(value->loop->iterable);
+			releaseValue(value->loop->body);
+			free(value->loop);
+			break;
+		case IF_VALUE:
+			releaseValue(value->conditional->condition);
+			releaseValue(value->conditional->consequent);
+			releaseValue(value->conditional->alternative);
+			free(value->conditional);
+			break;
+		case EXPRESSION_VALUE:
+			for (unsigned int k = 0; k < value->evaluation->count; ++k) {
+				releaseValue(value->evaluation->instructions[k].operand);
+			}
+			free(value->evaluation->instructions);
+			free(value->evaluation);
+			break;
 		default:
 			break;
 	}
@@ -324,6 +884,9 @@ void releaseStyleValue(StyleValue* value) {
 		case CSS_KEYWORD_STYLE:
 			free(value->cssKeyword);
 			break;
+		case EXPRESSION_STYLE:
+			releaseValue(value->expression);
+			break;
 		default:
 			break;
 	}
@@ -343,6 +906,8 @@ void releaseStyleProperties(StyleProperties* properties) {
 		releaseStyleProperty(properties->properties[i]);
 	}
 	free(properties->properties);
+	free(properties->declarations);
+	free(properties->attribute);
 	free(properties);
 }
 
@@ -350,6 +915,7 @@ void releaseEntry(Entry* entry) {
 	if (entry == NULL) return;
 	free(entry->key);
 	releaseValue(entry->value);
+	releaseStyleProperties(entry->style);
 	free(entry);
 }
 
@@ -364,6 +930,11 @@ void releaseEntries(Entries* entries) {
 
 void releaseArray(Array* array) {
 	if (array == NULL) return;
+	if (1 < array->references) {
+		--array->references;
+		return;
+	}
+	forgetArray(array);
 	for (int i = 0; i < array->count; i++) {
 		releaseValue(array->elements[i]);
 	}
@@ -373,19 +944,39 @@ void releaseArray(Array* array) {
 
 void releaseObject(Object* object) {
 	if (object == NULL) return;
+	if (1 < object->references) {
+		--object->references;
+		return;
+	}
+	forgetObject(object);
+	free(object->element);
 	free(object->type);
 	releaseEntries(object->entries);
 	free(object);
 }
 
+// El estilo es el de los atributos, así que se libera con ellos.
 void releaseHTMLElement(HTMLElement* element) {
 	if (element == NULL) return;
+	switch (element->type) {
+		case HTML_ELEMENT:
+			releaseHTMLElement((HTMLElement*) ((HTMLElementHTML*) element)->head);
+			releaseHTMLElement((HTMLElement*) ((HTMLElementHTML*) element)->body);
+			break;
+		case HEAD_ELEMENT:
+			releaseHTMLElement((HTMLElement*) ((HTMLElementHead*) element)->title);
+			break;
+		case TITLE_ELEMENT:
+			free(((HTMLElementTitle*) element)->content);
+			break;
+		case BODY_ELEMENT:
+			releaseArray(((HTMLElementBody*) element)->content);
+			break;
+		default:
+			// The other elements are lowered from an object, and released with it.
+			break;
+	}
 	releaseObject(element->attributes);
 	free(element);
 }
 
-void releaseProgram(Program* program) {
-	if (program == NULL) return;
-	releaseHTMLElement(program->root);
-	free(program);
-}
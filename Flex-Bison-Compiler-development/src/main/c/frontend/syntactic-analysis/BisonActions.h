@@ -1,12 +1,22 @@
 #ifndef BISON_ACTIONS_HEADER
 #define BISON_ACTIONS_HEADER
 
+#include "../../backend/code-generation/StyleSheet.h"
+#include "../../backend/domain-specific/Calculator.h"
+#include "../../shared/Buffer.h"
 #include "../../shared/CompilerState.h"
+#include "../../shared/Hash.h"
 #include "../../shared/Logger.h"
+#include "../../shared/RingBuffer.h"
+#include "../../shared/Statistics.h"
 #include "../../shared/Type.h"
 #include "AbstractSyntaxTree.h"
+#include "ElementSchema.h"
+#include "HashConsing.h"
 #include "SyntacticAnalyzer.h"
+#include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 
 /** Initialize module's internal state. */
 void initializeBisonActionsModule();
@@ -24,5 +34,76 @@ Expression * FactorExpressionSemanticAction(Factor * factor);
 Factor * ConstantFactorSemanticAction(Constant * constant);
 Factor * ExpressionFactorSemanticAction(Expression * expression);
 Program * ExpressionProgramSemanticAction(CompilerState * compilerState, Expression * expression);
+void ProgramSemanticAction(CompilerState * compilerState, Program * program);
+Program * PageSemanticAction(CompilerState * compilerState, Object * root);
+Object * ObjectSemanticAction(Entries * entries);
+Value * StandaloneValueSemanticAction(CompilerState * compilerState, Value * value);
+void EnterScopeSemanticAction(CompilerState * compilerState);
+void LeaveScopeSemanticAction(CompilerState * compilerState);
+void ElementSemanticAction(CompilerState * compilerState, Value * element);
+boolean VariableDeclarationSemanticAction(CompilerState * compilerState, char * name, Value * value);
+Value * VariableReferenceSemanticAction(CompilerState * compilerState, char * name);
+boolean EnterLoopSemanticAction(CompilerState * compilerState, char * variable);
+Value * LoopSemanticAction(CompilerState * compilerState, Value * iterable, Value * body);
+Value * ConditionalSemanticAction(Value * condition, Value * consequent, Value * alternative);
+Value * OperationSemanticAction(Value * leftValue, Value * rightValue, const ExpressionType type);
+StyleValue * StyleValueSemanticAction(Value * value);
+StyleProperties * StyleSemanticAction(CompilerState * compilerState, StyleProperties * properties);
+
+/**
+ * Generic value constructors. Every value, object and array is hash-consed,
+ * so the returned node may be shared with other parts of the tree: never
+ * mutate it, and release it only through its destructor.
+ */
+Value * createStringValue(char * string);
+Value * createIntegerValue(int64_t integer);
+Value * createRealValue(double real);
+Value * createBooleanValue(int boolean);
+Value * createNullValue();
+Value * createObjectValue(Object * object);
+Value * createArrayValue(Array * array);
+Value * createIncludeValue(char * name);
+Value * createLoopValue(const unsigned int slot, Value * iterable, Value * body);
+Value * createConditionalValue(Value * condition, Value * consequent, Value * alternative);
+Value * createSlotValue(const unsigned int slot);
+Value * createExpressionValue(Value * leftValue, Value * rightValue, const ExpressionType type);
+Entry * createEntry(char * key, Value * value);
+Entry * createStyleEntry(StyleProperties * style);
+Entries * createEntries();
+void addEntry(Entries * entries, Entry * entry);
+Array * createArray();
+void addArrayElement(Array * array, Value * element);
+Object * createObject(char * type, Entries * entries);
+
+/**
+ * HTML element constructors. Each element of the page takes a reference to
+ * the object it was built from (its attributes), and owns its children. The
+ * elements of its content are lowered from their objects instead (see
+ * "createObject"), and borrow everything from them.
+ */
+HTMLElement * createHTMLElement(HTMLElementType type, Object * attributes);
+HTMLElementHTML * createHTMLElementHTML(Object * attributes, HTMLElementHead * head, HTMLElementBody * body);
+HTMLElementHead * createHTMLElementHead(Object * attributes, HTMLElementTitle * title);
+HTMLElementTitle * createHTMLElementTitle(Object * attributes, char * content);
+HTMLElementBody * createHTMLElementBody(Object * attributes, Array * content);
+HTMLElementDiv * createHTMLElementDiv(Value * content);
+HTMLElementP * createHTMLElementP(Value * content);
+HTMLElementH1 * createHTMLElementH1(Value * content);
+HTMLElementImg * createHTMLElementImg(Value * src, Value * alt);
+HTMLElementA * createHTMLElementA(Value * href, Value * ref, Value * extRef, Value * content);
+HTMLElementCenter * createHTMLElementCenter(Value * content);
+Program * createProgram(HTMLElement * root);
+
+/**
+ * Style constructors.
+ */
+StyleValue * createStringStyleValue(char * string);
+StyleValue * createIntegerStyleValue(int64_t integer);
+StyleValue * createRealStyleValue(double real);
+StyleValue * createCSSKeywordStyleValue(char * keyword);
+StyleValue * createExpressionStyleValue(Value * expression);
+StyleProperty * createStyleProperty(char * key, StyleValue * value);
+StyleProperties * createStyleProperties();
+void addStyleProperty(StyleProperties * properties, StyleProperty * property);
 
 #endif
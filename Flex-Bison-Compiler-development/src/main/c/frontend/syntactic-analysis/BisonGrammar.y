@@ -1,15 +1,32 @@
+%code requires {
+// El "%union" usa los nodos del AST, así que "BisonParser.h" los necesita.
+#include "../../shared/Type.h"
+#include "AbstractSyntaxTree.h"
+}
+
 %{
 #include "BisonActions.h"
+#include "../lexical-analysis/StructuralLexer.h"
 #include "../lexical-analysis/Tokens.h"
+
+// Los tokens vienen de Flex, o del índice estructural (ver "nextToken").
+#define yylex nextToken
 %}
 
 // You touch this, and you die.
 %define api.value.union.name SemanticValue
 
+// Sin variables globales, para reconocer valores en varios hilos a la vez.
+%define api.pure full
+
+// Además de "yyparse", que toma los tokens, "yypush_parse" los recibe de a
+// uno, a medida que llega la fuente (ver "PushParser").
+%define api.push-pull both
+
 %union {
 	/** Terminals. */
 	char* string;
-	int integer;
+	int64_t integer;
 	double real;
 	int boolean;
 	Token token;
@@ -20,21 +37,12 @@
 	Entry* entry;
 	Entries* entries;
 	StyleProperties* styleProperties;
+	StyleProperty* styleProperty;
+	StyleValue* styleValue;
 	Value* value;
 	Constant* constant;
 	Expression* expression;
 	Factor* factor;
-	HTMLElement* htmlElement;
-	HTMLElementHTML* htmlElementHTML;
-	HTMLElementHead* htmlElementHead;
-	HTMLElementTitle* htmlElementTitle;
-	HTMLElementBody* htmlElementBody;
-	HTMLElementDiv* htmlElementDiv;
-	HTMLElementP* htmlElementP;
-	HTMLElementH1* htmlElementH1;
-	HTMLElementImg* htmlElementImg;
-	HTMLElementA* htmlElementA;
-	HTMLElementCenter* htmlElementCenter;
 	Program* program;
 }
 
@@ -46,21 +54,21 @@
  *
  * @see https://www.gnu.org/software/bison/manual/html_node/Destructor-Decl.html
  */
-%destructor { releaseConstant($$); } <constant>
-%destructor { releaseExpression($$); } <expression>
-%destructor { releaseFactor($$); } <factor>
 %destructor { releaseValue($$); } <value>
 %destructor { releaseObject($$); } <object>
 %destructor { releaseArray($$); } <array>
 %destructor { releaseEntry($$); } <entry>
 %destructor { releaseEntries($$); } <entries>
 %destructor { releaseStyleProperties($$); } <styleProperties>
-%destructor { releaseHTMLElement($$); } <htmlElement>
+%destructor { releaseStyleProperty($$); } <styleProperty>
+%destructor { releaseStyleValue($$); } <styleValue>
 %destructor { releaseProgram($$); } <program>
+%destructor { free($$); } key tag styleKey cssKeyword
 
 /** Terminals. */
 %token <token> OPEN_BRACE CLOSE_BRACE
 %token <token> OPEN_BRACKET CLOSE_BRACKET
+%token <token> OPEN_PARENTHESIS CLOSE_PARENTHESIS
 %token <token> COLON COMMA
 %token <string> STRING
 %token <integer> INTEGER
@@ -68,7 +76,7 @@
 %token <boolean> TRUE FALSE
 %token <token> NULL_TOKEN
 %token <token> TYPE CONTENT STYLE SRC ALT ID CLASS
-%token <token> HREF REF EXT_REF VAR
+%token <token> HREF REF EXT_REF VAR INCLUDE
 %token <token> IF THEN ELSE FOR WHILE
 %token <token> HTML_TAG HEAD_TAG TITLE_TAG BODY_TAG
 %token <token> DIV_TAG P_TAG H1_TAG IMG_TAG A_TAG
@@ -77,230 +85,146 @@
 %token <token> ADD SUB MUL DIV
 %token <string> IDENTIFIER
 
+/**
+ * Never produced by the source: the scanner emits it first to parse a single
+ * value instead of an entire program (see "parseValue").
+ */
+%token <token> START_VALUE
+
+/**
+ * Never produced by the source either: a value already parsed (on another
+ * thread), spliced in place of its tokens (see "structuralSpliceValue").
+ */
+%token <value> PARSED_VALUE
+
 /** Non-terminals. */
 %type <program> program
 %type <object> object
-%type <array> array arrayElements
-%type <entries> entries
-%type <entries> htmlEntries headEntries bodyEntries
-%type <entries> divEntries pEntries h1Entries
-%type <entries> imgEntries aEntries centerEntries
+%type <array> array arrayElements arrayElementList
 %type <entry> entry
-%type <value> value
-%type <htmlElement> htmlElement
-%type <htmlElementHTML> htmlElementHTML
-%type <htmlElementHead> htmlElementHead
-%type <htmlElementTitle> htmlElementTitle
-%type <htmlElementBody> htmlElementBody
-%type <htmlElementDiv> htmlElementDiv
-%type <htmlElementP> htmlElementP
-%type <htmlElementH1> htmlElementH1
-%type <htmlElementImg> htmlElementImg
-%type <htmlElementA> htmlElementA
-%type <htmlElementCenter> htmlElementCenter
+%type <entries> entries
+%type <value> value loop conditional operation
+%type <styleProperties> styleObject styleProperties
+%type <styleProperty> styleProperty
+%type <styleValue> styleValue
+%type <string> key tag styleKey cssKeyword
 
 /**
  * Precedence and associativity.
  *
  * @see https://www.gnu.org/software/bison/manual/html_node/Precedence.html
  */
+/* El "else" pendiente se asocia al "if" más cercano. */
+%nonassoc THEN
+%nonassoc ELSE
+%left OR
+%left AND
+%nonassoc EQ NEQ
+%nonassoc LT LE GT GE
 %left ADD SUB
 %left MUL DIV
+%right NOT
+
+%start compilation
 
 %%
 
 // IMPORTANT: To use λ in the following grammar, use the %empty symbol.
 
-program: object { $$ = createProgram($1); }
-	;
-
-object: OPEN_BRACE entries CLOSE_BRACE { $$ = createObject("object", $2); }
-	;
-
-entries: htmlEntries     /* Para el elemento raíz HTML */
-	| headEntries        /* Para <head> */
-	| bodyEntries        /* Para <body> */
-	| divEntries         /* Para <div> */
-	| pEntries          /* Para <p> */
-	| h1Entries         /* Para <h1> */
-	| imgEntries        /* Para <img> */
-	| aEntries          /* Para <a> */
-	| centerEntries     /* Para <center> */
-	;
-
-/* Reglas para elemento HTML raíz */
-htmlEntries: TYPE COLON HTML_TAG COMMA headAndBodyEntries                /* type primero */
-	| headAndBodyEntries COMMA TYPE COLON HTML_TAG                      /* type al final */
-	;
-
-headAndBodyEntries: headEntry COMMA bodyEntry
-	| bodyEntry COMMA headEntry
-	;
-
-headEntry: OPEN_BRACE headEntries CLOSE_BRACE
-	;
-
-bodyEntry: OPEN_BRACE bodyEntries CLOSE_BRACE
-	;
-
-/* Reglas para <head> */
-headEntries: TYPE COLON HEAD_TAG COMMA titleEntry                       /* type primero */
-	| titleEntry COMMA TYPE COLON HEAD_TAG                             /* type al final */
-	;
-
-titleEntry: CONTENT COLON OPEN_BRACE titleEntries CLOSE_BRACE
-	;
-
-titleEntries: TYPE COLON TITLE_TAG COMMA titleRequiredEntries          /* type primero */
-	| titleRequiredEntries COMMA TYPE COLON TITLE_TAG                  /* type al final */
+compilation: program { ProgramSemanticAction(currentCompilerState(), $1); }
+	| START_VALUE value { StandaloneValueSemanticAction(currentCompilerState(), $2); }
 	;
 
-titleRequiredEntries: CONTENT COLON STRING
+/* La página es el objeto raíz, que debe ser un elemento "html". */
+program: object { $$ = PageSemanticAction(currentCompilerState(), $1); if ($$ == NULL) { YYABORT; } }
 	;
 
-/* Reglas para <body> */
-bodyEntries: TYPE COLON BODY_TAG COMMA bodyContentEntries bodyOptionalEntries    /* type primero */
-	| bodyContentEntries COMMA TYPE COLON BODY_TAG bodyOptionalEntries          /* type en medio */
-	| bodyOptionalEntries TYPE COLON BODY_TAG COMMA bodyContentEntries          /* type antes del final */
-	| bodyOptionalEntries bodyContentEntries COMMA TYPE COLON BODY_TAG          /* type al final */
-	;
-
-bodyContentEntries: CONTENT COLON bodyContent
-	;
-
-bodyContent: value
-	| array
-	;
-
-bodyOptionalEntries: /* empty */
-	| COMMA STYLE COLON styleObject bodyOptionalEntries
-	| COMMA CLASS COLON STRING bodyOptionalEntries
-	| COMMA ID COLON STRING bodyOptionalEntries
-	;
-
-/* Reglas para <div> */
-divEntries: TYPE COLON DIV_TAG COMMA divRequiredEntries divOptionalEntries    /* type primero */
-	| divRequiredEntries COMMA TYPE COLON DIV_TAG divOptionalEntries          /* type en medio */
-	| divOptionalEntries TYPE COLON DIV_TAG COMMA divRequiredEntries          /* type antes del final */
-	| divOptionalEntries divRequiredEntries COMMA TYPE COLON DIV_TAG          /* type al final */
-	;
-
-divRequiredEntries: CONTENT COLON divContent
-	;
-
-divContent: value
-	| array
-	;
-
-divOptionalEntries: /* empty */
-	| COMMA STYLE COLON styleObject divOptionalEntries
-	| COMMA CLASS COLON STRING divOptionalEntries
-	| COMMA ID COLON STRING divOptionalEntries
-	;
-
-/* Reglas para <p> */
-pEntries: TYPE COLON P_TAG COMMA pRequiredEntries pOptionalEntries    /* type primero */
-	| pRequiredEntries COMMA TYPE COLON P_TAG pOptionalEntries          /* type en medio */
-	| pOptionalEntries TYPE COLON P_TAG COMMA pRequiredEntries          /* type antes del final */
-	| pOptionalEntries pRequiredEntries COMMA TYPE COLON P_TAG          /* type al final */
-	;
-
-pRequiredEntries: CONTENT COLON value
-	;
-
-pOptionalEntries: /* empty */
-	| COMMA STYLE COLON styleObject pOptionalEntries
-	| COMMA CLASS COLON STRING pOptionalEntries
-	| COMMA ID COLON STRING pOptionalEntries
-	;
-
-/* Reglas para <h1> */
-h1Entries: TYPE COLON H1_TAG COMMA h1RequiredEntries h1OptionalEntries    /* type primero */
-	| h1RequiredEntries COMMA TYPE COLON H1_TAG h1OptionalEntries          /* type en medio */
-	| h1OptionalEntries TYPE COLON H1_TAG COMMA h1RequiredEntries          /* type antes del final */
-	| h1OptionalEntries h1RequiredEntries COMMA TYPE COLON H1_TAG          /* type al final */
-	;
-
-h1RequiredEntries: CONTENT COLON value
-	;
-
-h1OptionalEntries: /* empty */
-	| COMMA STYLE COLON styleObject h1OptionalEntries
-	| COMMA CLASS COLON STRING h1OptionalEntries
-	| COMMA ID COLON STRING h1OptionalEntries
-	;
-
-/* Reglas para <a> */
-aEntries: TYPE COLON A_TAG COMMA aRequiredEntries aOptionalEntries    /* type primero */
-	| aRequiredEntries COMMA TYPE COLON A_TAG aOptionalEntries          /* type en medio */
-	| aOptionalEntries TYPE COLON A_TAG COMMA aRequiredEntries          /* type antes del final */
-	| aOptionalEntries aRequiredEntries COMMA TYPE COLON A_TAG          /* type al final */
-	;
-
-aRequiredEntries: aLinkEntry COMMA aContentEntry
-	| aContentEntry COMMA aLinkEntry
+/*
+ * Todos los elementos son objetos genéricos, con entradas en cualquier orden:
+ * las reglas de cada tipo (qué claves requiere y admite, y sus valores) se
+ * validan al reconocer el objeto, con la tabla de "ElementSchema".
+ */
+object: OPEN_BRACE entries CLOSE_BRACE { $$ = ObjectSemanticAction($2); if ($$ == NULL) { YYABORT; } }
 	;
 
-aLinkEntry: HREF COLON STRING
-	| REF COLON STRING
-	| EXT_REF COLON STRING
+entries: entry { $$ = createEntries(); addEntry($$, $1); }
+	| entries COMMA entry { addEntry($1, $3); $$ = $1; }
 	;
 
-aContentEntry: CONTENT COLON value
+/* Un elemento sin clave es un hijo (el "head" y el "body" de la página). */
+entry: key COLON value { $$ = createEntry($1, $3); }
+	| TYPE COLON tag { $$ = createEntry(strdup("type"), createStringValue($3)); }
+	| STYLE COLON styleObject { $$ = createStyleEntry($3); }
+	| object { $$ = createEntry(NULL, createObjectValue($1)); }
 	;
 
-aOptionalEntries: /* empty */
-	| COMMA STYLE COLON styleObject aOptionalEntries
-	| COMMA CLASS COLON STRING aOptionalEntries
-	| COMMA ID COLON STRING aOptionalEntries
+key: CONTENT { $$ = strdup("content"); }
+	| SRC { $$ = strdup("src"); }
+	| ALT { $$ = strdup("alt"); }
+	| ID { $$ = strdup("id"); }
+	| CLASS { $$ = strdup("class"); }
+	| HREF { $$ = strdup("href"); }
+	| REF { $$ = strdup("ref"); }
+	| EXT_REF { $$ = strdup("ext-ref"); }
+	| IDENTIFIER { $$ = $1; }
 	;
 
-/* Reglas para <center> */
-centerEntries: TYPE COLON CENTER_TAG COMMA centerRequiredEntries centerOptionalEntries    /* type primero */
-	| centerRequiredEntries COMMA TYPE COLON CENTER_TAG centerOptionalEntries          /* type en medio */
-	| centerOptionalEntries TYPE COLON CENTER_TAG COMMA centerRequiredEntries          /* type antes del final */
-	| centerOptionalEntries centerRequiredEntries COMMA TYPE COLON CENTER_TAG          /* type al final */
+tag: HTML_TAG { $$ = strdup("html"); }
+	| HEAD_TAG { $$ = strdup("head"); }
+	| TITLE_TAG { $$ = strdup("title"); }
+	| BODY_TAG { $$ = strdup("body"); }
+	| DIV_TAG { $$ = strdup("div"); }
+	| P_TAG { $$ = strdup("p"); }
+	| H1_TAG { $$ = strdup("h1"); }
+	| IMG_TAG { $$ = strdup("img"); }
+	| A_TAG { $$ = strdup("a"); }
+	| B_TAG { $$ = strdup("b"); }
+	| I_TAG { $$ = strdup("i"); }
+	| BR_TAG { $$ = strdup("br"); }
+	| HR_TAG { $$ = strdup("hr"); }
+	| CENTER_TAG { $$ = strdup("center"); }
 	;
 
-centerRequiredEntries: CONTENT COLON value
+/* Reglas para estilos mejoradas (se canonizan, y cada estilo distinto se genera como una clase) */
+styleObject: OPEN_BRACE styleProperties CLOSE_BRACE { $$ = StyleSemanticAction(currentCompilerState(), $2); }
 	;
 
-centerOptionalEntries: /* empty */
-	| COMMA STYLE COLON styleObject centerOptionalEntries
-	| COMMA CLASS COLON STRING centerOptionalEntries
-	| COMMA ID COLON STRING centerOptionalEntries
+styleProperties: styleProperty { $$ = createStyleProperties(); addStyleProperty($$, $1); }
+	| styleProperties COMMA styleProperty { addStyleProperty($1, $3); $$ = $1; }
 	;
 
-/* Reglas para estilos mejoradas */
-styleObject: OPEN_BRACE styleProperties CLOSE_BRACE
+styleProperty: styleKey COLON styleValue { $$ = createStyleProperty($1, $3); }
 	;
 
-styleProperties: styleProperty
-	| styleProperty COMMA styleProperties
+styleKey: IDENTIFIER { $$ = $1; }
 	;
 
-styleProperty: styleKey COLON styleValue
+/* Los valores pueden ser expresiones, que se pliegan al reconocerse. */
+styleValue: value { $$ = StyleValueSemanticAction($1); if ($$ == NULL) { YYABORT; } }
+	| cssKeyword { $$ = createCSSKeywordStyleValue($1); }
 	;
 
-styleKey: IDENTIFIER
+cssKeyword: CENTER_TAG { $$ = strdup("center"); }    /* para text-align: center */
 	;
 
-styleValue: STRING
-	| INTEGER
-	| REAL
-	| cssKeyword
+/* Cada arreglo es un ámbito léxico para las variables declaradas en él. */
+array: OPEN_BRACKET { EnterScopeSemanticAction(currentCompilerState()); } arrayElements CLOSE_BRACKET
+		{ LeaveScopeSemanticAction(currentCompilerState()); $$ = $3; }
 	;
 
-cssKeyword: CENTER_TAG    /* para text-align: center */
-	| /* otros valores CSS válidos */
+arrayElements: /* empty */ { $$ = createArray(); }
+	| arrayElementList { $$ = $1; }
 	;
 
-array: OPEN_BRACKET arrayElements CLOSE_BRACKET
+/* Cada elemento se puede generar por adelantado, apenas se reconoce (ver "ElementSemanticAction"). */
+arrayElementList: value { $$ = createArray(); addArrayElement($$, $1); ElementSemanticAction(currentCompilerState(), $1); }
+	| declaration { $$ = createArray(); }
+	| arrayElementList COMMA value { addArrayElement($1, $3); $$ = $1; ElementSemanticAction(currentCompilerState(), $3); }
+	| arrayElementList COMMA declaration { $$ = $1; }
 	;
 
-arrayElements: /* empty */
-	| value
-	| value COMMA arrayElements
+/* Las variables se resuelven al reconocerse, así que el AST no las contiene. */
+declaration: VAR IDENTIFIER COLON value { if (!VariableDeclarationSemanticAction(currentCompilerState(), $2, $4)) { YYABORT; } }
 	;
 
 /* Reglas para value */
@@ -312,23 +236,39 @@ value: STRING { $$ = createStringValue($1); }
     | NULL_TOKEN { $$ = createNullValue(); }
     | object { $$ = createObjectValue($1); }
     | array { $$ = createArrayValue($1); }
+    | INCLUDE STRING { $$ = createIncludeValue($2); }
+    | IDENTIFIER { $$ = VariableReferenceSemanticAction(currentCompilerState(), $1); if ($$ == NULL) { YYABORT; } }
+    | loop { $$ = $1; }
+    | conditional { $$ = $1; }
+    | operation { $$ = $1; }
+    | OPEN_PARENTHESIS value CLOSE_PARENTHESIS { $$ = $2; }
+    | PARSED_VALUE { $$ = $1; }
     ;
 
-/* Reglas para img */
-imgEntries: TYPE COLON IMG_TAG COMMA imgRequiredEntries imgOptionalEntries    /* type primero */
-    | imgRequiredEntries COMMA TYPE COLON IMG_TAG imgOptionalEntries          /* type en medio */
-    | imgOptionalEntries TYPE COLON IMG_TAG COMMA imgRequiredEntries          /* type antes del final */
-    | imgOptionalEntries imgRequiredEntries COMMA TYPE COLON IMG_TAG          /* type al final */
+/* Las operaciones entre constantes se pliegan; el resto se evalúa al generar. */
+operation: value ADD value { $$ = OperationSemanticAction($1, $3, ADDITION); if ($$ == NULL) { YYABORT; } }
+    | value SUB value { $$ = OperationSemanticAction($1, $3, SUBTRACTION); if ($$ == NULL) { YYABORT; } }
+    | value MUL value { $$ = OperationSemanticAction($1, $3, MULTIPLICATION); if ($$ == NULL) { YYABORT; } }
+    | value DIV value { $$ = OperationSemanticAction($1, $3, DIVISION); if ($$ == NULL) { YYABORT; } }
+    | value EQ value { $$ = OperationSemanticAction($1, $3, EQUALITY); if ($$ == NULL) { YYABORT; } }
+    | value NEQ value { $$ = OperationSemanticAction($1, $3, INEQUALITY); if ($$ == NULL) { YYABORT; } }
+    | value LT value { $$ = OperationSemanticAction($1, $3, LESS_THAN); if ($$ == NULL) { YYABORT; } }
+    | value LE value { $$ = OperationSemanticAction($1, $3, LESS_OR_EQUAL); if ($$ == NULL) { YYABORT; } }
+    | value GT value { $$ = OperationSemanticAction($1, $3, GREATER_THAN); if ($$ == NULL) { YYABORT; } }
+    | value GE value { $$ = OperationSemanticAction($1, $3, GREATER_OR_EQUAL); if ($$ == NULL) { YYABORT; } }
+    | value AND value { $$ = OperationSemanticAction($1, $3, CONJUNCTION); if ($$ == NULL) { YYABORT; } }
+    | value OR value { $$ = OperationSemanticAction($1, $3, DISJUNCTION); if ($$ == NULL) { YYABORT; } }
+    | NOT value { $$ = OperationSemanticAction($2, NULL, NEGATION); if ($$ == NULL) { YYABORT; } }
+    | SUB value %prec NOT { $$ = OperationSemanticAction($2, NULL, OPPOSITE); if ($$ == NULL) { YYABORT; } }
     ;
 
-imgRequiredEntries: SRC COLON STRING COMMA ALT COLON STRING
-    | ALT COLON STRING COMMA SRC COLON STRING
+/* El cuerpo es una plantilla: se reconoce una vez y se expande al generar. */
+loop: FOR IDENTIFIER COLON value THEN { if (!EnterLoopSemanticAction(currentCompilerState(), $2)) { YYABORT; } } value
+		{ $$ = LoopSemanticAction(currentCompilerState(), $4, $7); if ($$ == NULL) { YYABORT; } }
     ;
 
-imgOptionalEntries: /* empty */
-    | COMMA STYLE COLON styleObject imgOptionalEntries
-    | COMMA CLASS COLON STRING imgOptionalEntries
-    | COMMA ID COLON STRING imgOptionalEntries
+conditional: IF value THEN value %prec THEN { $$ = ConditionalSemanticAction($2, $4, NULL); if ($$ == NULL) { YYABORT; } }
+    | IF value THEN value ELSE value { $$ = ConditionalSemanticAction($2, $4, $6); if ($$ == NULL) { YYABORT; } }
     ;
 
 %%
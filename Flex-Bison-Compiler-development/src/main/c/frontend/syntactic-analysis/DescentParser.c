@@ -0,0 +1,838 @@
+#include "DescentParser.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * What a frame is waiting for. Each one owns what it holds (the partial node,
+ * a key or a name, or an operand), until it's reduced by the semantic action
+ * of its rule, or released if the parse ends before.
+ */
+typedef enum {
+	// The root: a page (an object), or a single value (see "START_VALUE").
+	PAGE_FRAME,
+	STANDALONE_FRAME,
+	// The entries of an object, and the value of the one with a key.
+	OBJECT_FRAME,
+	ENTRY_FRAME,
+	// The properties of a style, and the value of one of them.
+	STYLE_FRAME,
+	STYLE_PROPERTY_FRAME,
+	// The elements of an array, and the value of a declaration among them.
+	ARRAY_FRAME,
+	DECLARATION_FRAME,
+	// The right operand of a binary operator, or the one of a negation (or
+	// of an unary minus).
+	OPERATOR_FRAME,
+	NEGATION_FRAME,
+	PARENTHESIS_FRAME,
+	// Each part of a conditional, and of a loop.
+	CONDITION_FRAME,
+	CONSEQUENT_FRAME,
+	ALTERNATIVE_FRAME,
+	ITERABLE_FRAME,
+	BODY_FRAME
+} FrameType;
+
+typedef struct {
+	FrameType type;
+	union {
+		Array * array;
+		Entries * entries;
+		StyleProperties * properties;
+		// The key of an entry or a property, or the name of a variable.
+		char * name;
+		// The left operand, the condition, or the iterable.
+		Value * value;
+	};
+	// The consequent of a conditional with an alternative.
+	Value * consequent;
+	// The binary operator, and its token (for its precedence).
+	ExpressionType operator;
+	int token;
+} Frame;
+
+/**
+ * What the parser does next. The last ones end the parse.
+ */
+typedef enum {
+	// Parses a value, an element of an array, an entry, or a property.
+	VALUE_STEP,
+	ELEMENT_STEP,
+	ENTRY_STEP,
+	PROPERTY_STEP,
+	// Hands the last value (or object) to the frame on top.
+	REDUCE_VALUE_STEP,
+	REDUCE_OBJECT_STEP,
+	// After an element, an entry or a property: a comma, or the closing one.
+	NEXT_ELEMENT_STEP,
+	NEXT_ENTRY_STEP,
+	NEXT_PROPERTY_STEP,
+	END_STEP,
+	ACCEPT_STEP,
+	SYNTAX_ERROR_STEP,
+	ABORT_STEP,
+	OUT_OF_MEMORY_STEP
+} ParseStep;
+
+/**
+ * The binding power of the binary operators, as declared in the grammar
+ * (from lower to higher). The negation binds tighter than all of them.
+ */
+typedef enum {
+	NO_PRECEDENCE,
+	DISJUNCTION_PRECEDENCE,
+	CONJUNCTION_PRECEDENCE,
+	EQUALITY_PRECEDENCE,
+	COMPARISON_PRECEDENCE,
+	ADDITIVE_PRECEDENCE,
+	MULTIPLICATIVE_PRECEDENCE
+} Precedence;
+
+/**
+ * The state of a parse. The lookahead is taken only when a decision needs it
+ * (as Bison does with its default reductions), so the semantic actions run
+ * in the same order, and on a syntax error the current token is the
+ * offending one.
+ */
+typedef struct {
+	CompilerState * compilerState;
+	Frame * frames;
+	size_t count;
+	size_t capacity;
+	int token;
+	union SemanticValue semanticValue;
+	boolean hasToken;
+	// The last value (or object) recognized, not handed to a frame yet.
+	Value * value;
+	Object * object;
+} DescentParser;
+
+#define INITIAL_FRAME_CAPACITY 64
+
+static Logger * _logger = NULL;
+
+void initializeDescentParserModule() {
+	_logger = createLogger("DescentParser");
+}
+
+void shutdownDescentParserModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _consume(DescentParser * parser);
+static boolean _expect(DescentParser * parser, const int token);
+static boolean _isValueStart(const int token);
+static char * _keyOf(const int token, union SemanticValue * semanticValue);
+static ParseStep _nextElement(DescentParser * parser);
+static ParseStep _nextEntry(DescentParser * parser);
+static ParseStep _nextProperty(DescentParser * parser);
+static ExpressionType _operatorOf(const int token);
+static ParseStep _parseCompilation(DescentParser * parser);
+static ParseStep _parseElement(DescentParser * parser);
+static ParseStep _parseEntry(DescentParser * parser);
+static ParseStep _parseProperty(DescentParser * parser);
+static ParseStep _parseValue(DescentParser * parser);
+static int _peek(DescentParser * parser);
+static Precedence _precedenceOf(const int token);
+static Frame * _pushFrame(DescentParser * parser, const FrameType type);
+static ParseStep _reduceObject(DescentParser * parser);
+static ParseStep _reduceValue(DescentParser * parser);
+static void _releaseFrame(Frame * frame);
+static void _releaseParser(DescentParser * parser);
+static const char * _tagOf(const int token);
+static Frame * _topFrame(DescentParser * parser);
+
+/**
+ * Takes the lookahead (the next peek gets the following token).
+ */
+static void _consume(DescentParser * parser) {
+	parser->hasToken = false;
+}
+
+/**
+ * Takes the lookahead if it's the expected token. Otherwise, leaves it
+ * there, since it's the offending one.
+ */
+static boolean _expect(DescentParser * parser, const int token) {
+	if (_peek(parser) != token) {
+		return false;
+	}
+	_consume(parser);
+	return true;
+}
+
+/**
+ * Whether a token can start a value.
+ */
+static boolean _isValueStart(const int token) {
+	switch (token) {
+		case STRING:
+		case INTEGER:
+		case REAL:
+		case TRUE:
+		case FALSE:
+		case NULL_TOKEN:
+		case OPEN_BRACE:
+		case OPEN_BRACKET:
+		case OPEN_PARENTHESIS:
+		case INCLUDE:
+		case IDENTIFIER:
+		case FOR:
+		case IF:
+		case NOT:
+		case SUB:
+		case PARSED_VALUE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * The key of an entry (owned by the caller), or NULL if the token is not
+ * one. An identifier is its own key.
+ */
+static char * _keyOf(const int token, union SemanticValue * semanticValue) {
+	switch (token) {
+		case CONTENT: return strdup("content");
+		case SRC: return strdup("src");
+		case ALT: return strdup("alt");
+		case ID: return strdup("id");
+		case CLASS: return strdup("class");
+		case HREF: return strdup("href");
+		case REF: return strdup("ref");
+		case EXT_REF: return strdup("ext-ref");
+		case IDENTIFIER: return semanticValue->string;
+		default: return NULL;
+	}
+}
+
+/**
+ * After an element of the array on top: the next one, or the end of the
+ * array (and of its scope).
+ */
+static ParseStep _nextElement(DescentParser * parser) {
+	if (_expect(parser, COMMA)) {
+		return ELEMENT_STEP;
+	}
+	if (!_expect(parser, CLOSE_BRACKET)) {
+		return SYNTAX_ERROR_STEP;
+	}
+	LeaveScopeSemanticAction(parser->compilerState);
+	Array * array = _topFrame(parser)->array;
+	--parser->count;
+	parser->value = createArrayValue(array);
+	return REDUCE_VALUE_STEP;
+}
+
+/**
+ * After an entry of the object on top: the next one, or the end of the
+ * object (that must be a valid element).
+ */
+static ParseStep _nextEntry(DescentParser * parser) {
+	if (_expect(parser, COMMA)) {
+		return ENTRY_STEP;
+	}
+	if (!_expect(parser, CLOSE_BRACE)) {
+		return SYNTAX_ERROR_STEP;
+	}
+	Entries * entries = _topFrame(parser)->entries;
+	--parser->count;
+	parser->object = ObjectSemanticAction(entries);
+	return parser->object == NULL ? ABORT_STEP : REDUCE_OBJECT_STEP;
+}
+
+/**
+ * After a property of the style on top: the next one, or the end of the
+ * style (an entry of the enclosing object).
+ */
+static ParseStep _nextProperty(DescentParser * parser) {
+	if (_expect(parser, COMMA)) {
+		return PROPERTY_STEP;
+	}
+	if (!_expect(parser, CLOSE_BRACE)) {
+		return SYNTAX_ERROR_STEP;
+	}
+	StyleProperties * properties = _topFrame(parser)->properties;
+	--parser->count;
+	StyleProperties * style = StyleSemanticAction(parser->compilerState, properties);
+	addEntry(_topFrame(parser)->entries, createStyleEntry(style));
+	return NEXT_ENTRY_STEP;
+}
+
+/**
+ * The operation of a binary operator.
+ */
+static ExpressionType _operatorOf(const int token) {
+	switch (token) {
+		case ADD: return ADDITION;
+		case SUB: return SUBTRACTION;
+		case MUL: return MULTIPLICATION;
+		case DIV: return DIVISION;
+		case EQ: return EQUALITY;
+		case NEQ: return INEQUALITY;
+		case LT: return LESS_THAN;
+		case LE: return LESS_OR_EQUAL;
+		case GT: return GREATER_THAN;
+		case GE: return GREATER_OR_EQUAL;
+		case AND: return CONJUNCTION;
+		default: return DISJUNCTION;
+	}
+}
+
+/**
+ * The start of the source: a page, or a single value if the scanner was
+ * asked for one (see "parseValue").
+ */
+static ParseStep _parseCompilation(DescentParser * parser) {
+	if (_expect(parser, START_VALUE)) {
+		return _pushFrame(parser, STANDALONE_FRAME) == NULL ? OUT_OF_MEMORY_STEP : VALUE_STEP;
+	}
+	if (_pushFrame(parser, PAGE_FRAME) == NULL) {
+		return OUT_OF_MEMORY_STEP;
+	}
+	return _peek(parser) == OPEN_BRACE ? VALUE_STEP : SYNTAX_ERROR_STEP;
+}
+
+/**
+ * An element of the array on top: a value, or the declaration of a variable
+ * (resolved right away, so it's not an element).
+ */
+static ParseStep _parseElement(DescentParser * parser) {
+	if (!_expect(parser, VAR)) {
+		return VALUE_STEP;
+	}
+	if (_peek(parser) != IDENTIFIER) {
+		return SYNTAX_ERROR_STEP;
+	}
+	_consume(parser);
+	Frame * frame = _pushFrame(parser, DECLARATION_FRAME);
+	if (frame == NULL) {
+		free(parser->semanticValue.string);
+		return OUT_OF_MEMORY_STEP;
+	}
+	frame->name = parser->semanticValue.string;
+	return _expect(parser, COLON) ? VALUE_STEP : SYNTAX_ERROR_STEP;
+}
+
+/**
+ * An entry of the object on top: its type, its style, a child element (an
+ * object without key), or any other key with a value.
+ */
+static ParseStep _parseEntry(DescentParser * parser) {
+	const int token = _peek(parser);
+	if (token == TYPE) {
+		_consume(parser);
+		if (!_expect(parser, COLON)) {
+			return SYNTAX_ERROR_STEP;
+		}
+		const char * tag = _tagOf(_peek(parser));
+		if (tag == NULL) {
+			return SYNTAX_ERROR_STEP;
+		}
+		_consume(parser);
+		addEntry(_topFrame(parser)->entries, createEntry(strdup("type"), createStringValue(strdup(tag))));
+		return NEXT_ENTRY_STEP;
+	}
+	if (token == STYLE) {
+		_consume(parser);
+		if (!_expect(parser, COLON) || !_expect(parser, OPEN_BRACE)) {
+			return SYNTAX_ERROR_STEP;
+		}
+		Frame * frame = _pushFrame(parser, STYLE_FRAME);
+		if (frame == NULL) {
+			return OUT_OF_MEMORY_STEP;
+		}
+		frame->properties = createStyleProperties();
+		return PROPERTY_STEP;
+	}
+	if (token == OPEN_BRACE) {
+		return VALUE_STEP;
+	}
+	char * key = _keyOf(token, &parser->semanticValue);
+	if (key == NULL) {
+		return SYNTAX_ERROR_STEP;
+	}
+	_consume(parser);
+	Frame * frame = _pushFrame(parser, ENTRY_FRAME);
+	if (frame == NULL) {
+		free(key);
+		return OUT_OF_MEMORY_STEP;
+	}
+	frame->name = key;
+	return _expect(parser, COLON) ? VALUE_STEP : SYNTAX_ERROR_STEP;
+}
+
+/**
+ * A property of the style on top. Its value is a CSS keyword, a value (that
+ * must fold to a string or a number), or nothing.
+ */
+static ParseStep _parseProperty(DescentParser * parser) {
+	if (_peek(parser) != IDENTIFIER) {
+		return SYNTAX_ERROR_STEP;
+	}
+	_consume(parser);
+	char * key = parser->semanticValue.string;
+	if (!_expect(parser, COLON)) {
+		free(key);
+		return SYNTAX_ERROR_STEP;
+	}
+	const int token = _peek(parser);
+	if (_isValueStart(token)) {
+		Frame * frame = _pushFrame(parser, STYLE_PROPERTY_FRAME);
+		if (frame == NULL) {
+			free(key);
+			return OUT_OF_MEMORY_STEP;
+		}
+		frame->name = key;
+		return VALUE_STEP;
+	}
+	if (token != CENTER_TAG) {
+		free(key);
+		return SYNTAX_ERROR_STEP;
+	}
+	_consume(parser);
+	addStyleProperty(_topFrame(parser)->properties, createStyleProperty(key, createCSSKeywordStyleValue(strdup("center"))));
+	return NEXT_PROPERTY_STEP;
+}
+
+/**
+ * A value. The primary ones are recognized right away; the others open a
+ * frame, and are recognized once it's reduced.
+ */
+static ParseStep _parseValue(DescentParser * parser) {
+	CompilerState * compilerState = parser->compilerState;
+	union SemanticValue * semanticValue = &parser->semanticValue;
+	const int token = _peek(parser);
+	if (!_isValueStart(token)) {
+		return SYNTAX_ERROR_STEP;
+	}
+	_consume(parser);
+	Frame * frame = NULL;
+	switch (token) {
+		case STRING:
+			parser->value = createStringValue(semanticValue->string);
+			return REDUCE_VALUE_STEP;
+		case INTEGER:
+			parser->value = createIntegerValue(semanticValue->integer);
+			return REDUCE_VALUE_STEP;
+		case REAL:
+			parser->value = createRealValue(semanticValue->real);
+			return REDUCE_VALUE_STEP;
+		case TRUE:
+			parser->value = createBooleanValue(1);
+			return REDUCE_VALUE_STEP;
+		case FALSE:
+			parser->value = createBooleanValue(0);
+			return REDUCE_VALUE_STEP;
+		case NULL_TOKEN:
+			parser->value = createNullValue();
+			return REDUCE_VALUE_STEP;
+		case PARSED_VALUE:
+			parser->value = semanticValue->value;
+			return REDUCE_VALUE_STEP;
+		case IDENTIFIER:
+			parser->value = VariableReferenceSemanticAction(compilerState, semanticValue->string);
+			return parser->value == NULL ? ABORT_STEP : REDUCE_VALUE_STEP;
+		case INCLUDE:
+			if (_peek(parser) != STRING) {
+				return SYNTAX_ERROR_STEP;
+			}
+			_consume(parser);
+			parser->value = createIncludeValue(semanticValue->string);
+			return REDUCE_VALUE_STEP;
+		case OPEN_BRACE:
+			frame = _pushFrame(parser, OBJECT_FRAME);
+			if (frame == NULL) {
+				return OUT_OF_MEMORY_STEP;
+			}
+			frame->entries = createEntries();
+			return ENTRY_STEP;
+		case OPEN_BRACKET:
+			EnterScopeSemanticAction(compilerState);
+			frame = _pushFrame(parser, ARRAY_FRAME);
+			if (frame == NULL) {
+				return OUT_OF_MEMORY_STEP;
+			}
+			frame->array = createArray();
+			return _peek(parser) == CLOSE_BRACKET ? NEXT_ELEMENT_STEP : ELEMENT_STEP;
+		case FOR:
+			if (_peek(parser) != IDENTIFIER) {
+				return SYNTAX_ERROR_STEP;
+			}
+			_consume(parser);
+			frame = _pushFrame(parser, ITERABLE_FRAME);
+			if (frame == NULL) {
+				free(semanticValue->string);
+				return OUT_OF_MEMORY_STEP;
+			}
+			frame->name = semanticValue->string;
+			return _expect(parser, COLON) ? VALUE_STEP : SYNTAX_ERROR_STEP;
+		case IF:
+			return _pushFrame(parser, CONDITION_FRAME) == NULL ? OUT_OF_MEMORY_STEP : VALUE_STEP;
+		case NOT:
+		case SUB:
+			frame = _pushFrame(parser, NEGATION_FRAME);
+			if (frame == NULL) {
+				return OUT_OF_MEMORY_STEP;
+			}
+			frame->operator = token == NOT ? NEGATION : OPPOSITE;
+			return VALUE_STEP;
+		default:
+			return _pushFrame(parser, PARENTHESIS_FRAME) == NULL ? OUT_OF_MEMORY_STEP : VALUE_STEP;
+	}
+}
+
+/**
+ * The lookahead, taken from the lexer if it wasn't yet.
+ */
+static int _peek(DescentParser * parser) {
+	if (!parser->hasToken) {
+		parser->token = nextToken(&parser->semanticValue);
+		parser->hasToken = true;
+	}
+	return parser->token;
+}
+
+/**
+ * The precedence of a token, if it's a binary operator.
+ */
+static Precedence _precedenceOf(const int token) {
+	switch (token) {
+		case OR: return DISJUNCTION_PRECEDENCE;
+		case AND: return CONJUNCTION_PRECEDENCE;
+		case EQ:
+		case NEQ: return EQUALITY_PRECEDENCE;
+		case LT:
+		case LE:
+		case GT:
+		case GE: return COMPARISON_PRECEDENCE;
+		case ADD:
+		case SUB: return ADDITIVE_PRECEDENCE;
+		case MUL:
+		case DIV: return MULTIPLICATIVE_PRECEDENCE;
+		default: return NO_PRECEDENCE;
+	}
+}
+
+/**
+ * Pushes an empty frame, growing the stack if it's full. Returns NULL if
+ * memory is exhausted. A pointer to a frame is valid only until the next
+ * push.
+ */
+static Frame * _pushFrame(DescentParser * parser, const FrameType type) {
+	if (parser->count == parser->capacity) {
+		const size_t capacity = parser->capacity == 0 ? INITIAL_FRAME_CAPACITY : 2 * parser->capacity;
+		Frame * frames = realloc(parser->frames, capacity * sizeof(Frame));
+		if (frames == NULL) {
+			return NULL;
+		}
+		parser->frames = frames;
+		parser->capacity = capacity;
+	}
+	Frame * frame = &parser->frames[parser->count++];
+	*frame = (Frame) {
+		.type = type,
+		.value = NULL,
+		.consequent = NULL,
+		.operator = FACTOR,
+		.token = 0
+	};
+	return frame;
+}
+
+/**
+ * Hands an object to the frame on top: a child of the enclosing object, the
+ * page, or a value.
+ */
+static ParseStep _reduceObject(DescentParser * parser) {
+	Object * object = parser->object;
+	parser->object = NULL;
+	switch (_topFrame(parser)->type) {
+		case OBJECT_FRAME:
+			addEntry(_topFrame(parser)->entries, createEntry(NULL, createObjectValue(object)));
+			return NEXT_ENTRY_STEP;
+		case PAGE_FRAME: {
+			Program * program = PageSemanticAction(parser->compilerState, object);
+			if (program == NULL) {
+				return ABORT_STEP;
+			}
+			ProgramSemanticAction(parser->compilerState, program);
+			return END_STEP;
+		}
+		default:
+			parser->value = createObjectValue(object);
+			return REDUCE_VALUE_STEP;
+	}
+}
+
+/**
+ * Hands a value to the frames on top, reducing each one that is complete
+ * with it (an operation, a conditional or a loop is a value too), until one
+ * needs more tokens. A binary operator that binds tighter than the one on top
+ * (if any) takes the value as its left operand instead.
+ */
+static ParseStep _reduceValue(DescentParser * parser) {
+	CompilerState * compilerState = parser->compilerState;
+	while (true) {
+		Frame * frame = _topFrame(parser);
+		Value * value = parser->value;
+		if (frame->type == NEGATION_FRAME) {
+			--parser->count;
+			parser->value = OperationSemanticAction(value, NULL, frame->operator);
+			if (parser->value == NULL) {
+				return ABORT_STEP;
+			}
+			continue;
+		}
+		const int token = _peek(parser);
+		const Precedence precedence = _precedenceOf(token);
+		if (frame->type == OPERATOR_FRAME && precedence <= _precedenceOf(frame->token)) {
+			if (precedence == _precedenceOf(frame->token)
+					&& (precedence == EQUALITY_PRECEDENCE || precedence == COMPARISON_PRECEDENCE)) {
+				// Comparisons are not associative.
+				return SYNTAX_ERROR_STEP;
+			}
+			--parser->count;
+			parser->value = OperationSemanticAction(frame->value, value, frame->operator);
+			if (parser->value == NULL) {
+				return ABORT_STEP;
+			}
+			continue;
+		}
+		if (precedence != NO_PRECEDENCE) {
+			_consume(parser);
+			frame = _pushFrame(parser, OPERATOR_FRAME);
+			if (frame == NULL) {
+				return OUT_OF_MEMORY_STEP;
+			}
+			frame->value = value;
+			frame->operator = _operatorOf(token);
+			frame->token = token;
+			parser->value = NULL;
+			return VALUE_STEP;
+		}
+		char * name = NULL;
+		Value * condition = NULL;
+		switch (frame->type) {
+			case STANDALONE_FRAME:
+				parser->value = NULL;
+				StandaloneValueSemanticAction(compilerState, value);
+				return END_STEP;
+			case ENTRY_FRAME:
+				name = frame->name;
+				parser->value = NULL;
+				--parser->count;
+				addEntry(_topFrame(parser)->entries, createEntry(name, value));
+				return NEXT_ENTRY_STEP;
+			case STYLE_PROPERTY_FRAME: {
+				parser->value = NULL;
+				StyleValue * styleValue = StyleValueSemanticAction(value);
+				if (styleValue == NULL) {
+					return ABORT_STEP;
+				}
+				name = frame->name;
+				--parser->count;
+				addStyleProperty(_topFrame(parser)->properties, createStyleProperty(name, styleValue));
+				return NEXT_PROPERTY_STEP;
+			}
+			case ARRAY_FRAME:
+				parser->value = NULL;
+				addArrayElement(frame->array, value);
+				ElementSemanticAction(compilerState, value);
+				return NEXT_ELEMENT_STEP;
+			case DECLARATION_FRAME:
+				name = frame->name;
+				parser->value = NULL;
+				--parser->count;
+				return VariableDeclarationSemanticAction(compilerState, name, value) ? NEXT_ELEMENT_STEP : ABORT_STEP;
+			case PARENTHESIS_FRAME:
+				if (!_expect(parser, CLOSE_PARENTHESIS)) {
+					return SYNTAX_ERROR_STEP;
+				}
+				--parser->count;
+				continue;
+			case CONDITION_FRAME:
+				if (!_expect(parser, THEN)) {
+					return SYNTAX_ERROR_STEP;
+				}
+				parser->value = NULL;
+				frame->type = CONSEQUENT_FRAME;
+				frame->value = value;
+				return VALUE_STEP;
+			case CONSEQUENT_FRAME:
+				// The pending "else" belongs to the closest "if".
+				if (_expect(parser, ELSE)) {
+					parser->value = NULL;
+					frame->type = ALTERNATIVE_FRAME;
+					frame->consequent = value;
+					return VALUE_STEP;
+				}
+				condition = frame->value;
+				--parser->count;
+				parser->value = ConditionalSemanticAction(condition, value, NULL);
+				break;
+			case ALTERNATIVE_FRAME:
+				--parser->count;
+				parser->value = ConditionalSemanticAction(frame->value, frame->consequent, value);
+				break;
+			case ITERABLE_FRAME:
+				if (!_expect(parser, THEN)) {
+					return SYNTAX_ERROR_STEP;
+				}
+				name = frame->name;
+				parser->value = NULL;
+				frame->type = BODY_FRAME;
+				frame->value = value;
+				return EnterLoopSemanticAction(compilerState, name) ? VALUE_STEP : ABORT_STEP;
+			case BODY_FRAME:
+				--parser->count;
+				parser->value = LoopSemanticAction(compilerState, frame->value, value);
+				break;
+			default:
+				return SYNTAX_ERROR_STEP;
+		}
+		if (parser->value == NULL) {
+			return ABORT_STEP;
+		}
+	}
+}
+
+/**
+ * Releases what a frame holds.
+ */
+static void _releaseFrame(Frame * frame) {
+	switch (frame->type) {
+		case ARRAY_FRAME:
+			releaseArray(frame->array);
+			break;
+		case OBJECT_FRAME:
+			releaseEntries(frame->entries);
+			break;
+		case STYLE_FRAME:
+			releaseStyleProperties(frame->properties);
+			break;
+		case DECLARATION_FRAME:
+		case ENTRY_FRAME:
+		case ITERABLE_FRAME:
+		case STYLE_PROPERTY_FRAME:
+			free(frame->name);
+			break;
+		case ALTERNATIVE_FRAME:
+			releaseValue(frame->consequent);
+			releaseValue(frame->value);
+			break;
+		case BODY_FRAME:
+		case CONSEQUENT_FRAME:
+		case OPERATOR_FRAME:
+			releaseValue(frame->value);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Releases the frames still open, and the lookahead and the value (or object)
+ * not handed to any of them, once the parse ended. The partial nodes are
+ * dropped, like the destructors of Bison do.
+ */
+static void _releaseParser(DescentParser * parser) {
+	while (0 < parser->count) {
+		_releaseFrame(&parser->frames[--parser->count]);
+	}
+	free(parser->frames);
+	releaseValue(parser->value);
+	releaseObject(parser->object);
+	if (parser->hasToken) {
+		switch (parser->token) {
+			case IDENTIFIER:
+			case STRING:
+				free(parser->semanticValue.string);
+				break;
+			case PARSED_VALUE:
+				releaseValue(parser->semanticValue.value);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * The type of an element, or NULL if the token is not a tag.
+ */
+static const char * _tagOf(const int token) {
+	switch (token) {
+		case HTML_TAG: return "html";
+		case HEAD_TAG: return "head";
+		case TITLE_TAG: return "title";
+		case BODY_TAG: return "body";
+		case DIV_TAG: return "div";
+		case P_TAG: return "p";
+		case H1_TAG: return "h1";
+		case IMG_TAG: return "img";
+		case A_TAG: return "a";
+		case B_TAG: return "b";
+		case I_TAG: return "i";
+		case BR_TAG: return "br";
+		case HR_TAG: return "hr";
+		case CENTER_TAG: return "center";
+		default: return NULL;
+	}
+}
+
+/**
+ * The frame on top (there's always one, the root).
+ */
+static Frame * _topFrame(DescentParser * parser) {
+	return &parser->frames[parser->count - 1];
+}
+
+/* PUBLIC FUNCTIONS */
+
+int descentParse(void) {
+	DescentParser parser = {
+		.compilerState = currentCompilerState(),
+		.frames = NULL,
+		.count = 0,
+		.capacity = 0,
+		.token = YYEOF,
+		.hasToken = false,
+		.value = NULL,
+		.object = NULL
+	};
+	ParseStep step = _parseCompilation(&parser);
+	while (step < ACCEPT_STEP) {
+		switch (step) {
+			case VALUE_STEP: step = _parseValue(&parser); break;
+			case ELEMENT_STEP: step = _parseElement(&parser); break;
+			case ENTRY_STEP: step = _parseEntry(&parser); break;
+			case PROPERTY_STEP: step = _parseProperty(&parser); break;
+			case REDUCE_VALUE_STEP: step = _reduceValue(&parser); break;
+			case REDUCE_OBJECT_STEP: step = _reduceObject(&parser); break;
+			case NEXT_ELEMENT_STEP: step = _nextElement(&parser); break;
+			case NEXT_ENTRY_STEP: step = _nextEntry(&parser); break;
+			case NEXT_PROPERTY_STEP: step = _nextProperty(&parser); break;
+			default: step = _peek(&parser) == YYEOF ? ACCEPT_STEP : SYNTAX_ERROR_STEP; break;
+		}
+	}
+	int code = 0;
+	if (step == SYNTAX_ERROR_STEP) {
+		yyerror("syntax error");
+		code = 1;
+	}
+	else if (step == ABORT_STEP) {
+		code = 1;
+	}
+	else if (step == OUT_OF_MEMORY_STEP) {
+		logError(_logger, "The stack of frames ran out of memory, at a depth of %zu.", parser.count);
+		code = 2;
+	}
+	_releaseParser(&parser);
+	return code;
+}
@@ -0,0 +1,43 @@
+#ifndef DESCENT_PARSER_HEADER
+#define DESCENT_PARSER_HEADER
+
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../lexical-analysis/StructuralLexer.h"
+#include "AbstractSyntaxTree.h"
+#include "BisonActions.h"
+#include "BisonParser.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeDescentParserModule();
+
+/** Shutdown module's internal state. */
+void shutdownDescentParserModule();
+
+/**
+ * A hand-written alternative to the parser of Bison, for the same grammar
+ * (see "BisonGrammar.y"). It takes the same tokens (see "nextToken"), runs
+ * the same semantic actions at the same points (so it builds the same tree,
+ * and logs the same errors), and reports syntax errors with "yyerror", on the
+ * same token. Instead of tables, it dispatches on the token directly, and
+ * instead of recursion, it keeps the values being built in an explicit stack
+ * of frames (one per open object, array, operator, conditional, and so on),
+ * so nesting is only limited by memory. Operators are resolved by
+ * precedence, as declared in the grammar.
+ *
+ * It's selected when the compiler is built (with the DESCENT_PARSER option
+ * of CMake), in place of "yyparse". The push parser is still the one of
+ * Bison (see "createPushParser").
+ */
+
+/**
+ * Parses the tokens of the current source, into the current compiler state
+ * (see "currentCompilerState"). Returns what "yyparse" would: 0 if it's
+ * accepted, 1 if it's rejected, and 2 if memory is exhausted.
+ */
+int descentParse(void);
+
+#endif
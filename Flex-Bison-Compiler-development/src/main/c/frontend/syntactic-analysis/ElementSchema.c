@@ -0,0 +1,334 @@
+#include "ElementSchema.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The keys that an element can have, a bit each.
+ */
+typedef enum {
+	TYPE_KEY = 1 << 0,
+	CONTENT_KEY = 1 << 1,
+	STYLE_KEY = 1 << 2,
+	CLASS_KEY = 1 << 3,
+	ID_KEY = 1 << 4,
+	SRC_KEY = 1 << 5,
+	ALT_KEY = 1 << 6,
+	HREF_KEY = 1 << 7,
+	REF_KEY = 1 << 8,
+	EXT_REF_KEY = 1 << 9
+} ElementKey;
+
+/**
+ * What the value of the "content" of an element must be.
+ */
+typedef enum {
+	ANY_CONTENT,
+	ELEMENT_CONTENT,
+	STRING_CONTENT
+} ContentKind;
+
+/**
+ * The rules of a type of element. The type entry is always required, and
+ * exactly one of the link keys (if any) must be present. The content
+ * type is the one of the element required by ELEMENT_CONTENT, and each child
+ * is an element required once, without key.
+ */
+typedef struct {
+	const char * type;
+	unsigned int requiredKeys;
+	unsigned int allowedKeys;
+	unsigned int linkKeys;
+	ContentKind content;
+	const char * contentType;
+	const char * children[2];
+} ElementSchema;
+
+typedef struct {
+	const char * name;
+	ElementKey key;
+} KeyName;
+
+// The keys that every element with attributes allows, and those whose value
+// must be a string.
+#define ATTRIBUTE_KEYS (STYLE_KEY | CLASS_KEY | ID_KEY)
+#define LINK_KEYS (HREF_KEY | REF_KEY | EXT_REF_KEY)
+#define STRING_KEYS (CLASS_KEY | ID_KEY | SRC_KEY | ALT_KEY | LINK_KEYS)
+
+static const KeyName _keyNames[] = {
+	{ "type", TYPE_KEY },
+	{ "content", CONTENT_KEY },
+	{ "style", STYLE_KEY },
+	{ "class", CLASS_KEY },
+	{ "id", ID_KEY },
+	{ "src", SRC_KEY },
+	{ "alt", ALT_KEY },
+	{ "href", HREF_KEY },
+	{ "ref", REF_KEY },
+	{ "ext-ref", EXT_REF_KEY }
+};
+
+static const ElementSchema _schemas[] = {
+	{ "html", 0, 0, 0, ANY_CONTENT, NULL, { "head", "body" } },
+	{ "head", CONTENT_KEY, CONTENT_KEY, 0, ELEMENT_CONTENT, "title", { NULL, NULL } },
+	{ "title", CONTENT_KEY, CONTENT_KEY, 0, STRING_CONTENT, NULL, { NULL, NULL } },
+	{ "body", CONTENT_KEY, CONTENT_KEY | ATTRIBUTE_KEYS, 0, ANY_CONTENT, NULL, { NULL, NULL } },
+	{ "div", CONTENT_KEY, CONTENT_KEY | ATTRIBUTE_KEYS, 0, ANY_CONTENT, NULL, { NULL, NULL } },
+	{ "p", CONTENT_KEY, CONTENT_KEY | ATTRIBUTE_KEYS, 0, ANY_CONTENT, NULL, { NULL, NULL } },
+	{ "h1", CONTENT_KEY, CONTENT_KEY | ATTRIBUTE_KEYS, 0, ANY_CONTENT, NULL, { NULL, NULL } },
+	{ "img", SRC_KEY | ALT_KEY, SRC_KEY | ALT_KEY | ATTRIBUTE_KEYS, 0, ANY_CONTENT, NULL, { NULL, NULL } },
+	{ "a", CONTENT_KEY, CONTENT_KEY | LINK_KEYS | ATTRIBUTE_KEYS, LINK_KEYS, ANY_CONTENT, NULL, { NULL, NULL } },
+	{ "center", CONTENT_KEY, CONTENT_KEY | ATTRIBUTE_KEYS, 0, ANY_CONTENT, NULL, { NULL, NULL } }
+};
+
+// The elements of the structure of a page, that are allowed only where the
+// schemas require them (the root, its children, and the content of the head).
+static const char * _pageElements[] = { "html", "head", "title", "body" };
+
+#define SCHEMA_COUNT (sizeof(_schemas) / sizeof(ElementSchema))
+#define PAGE_ELEMENT_COUNT (sizeof(_pageElements) / sizeof(const char *))
+#define KEY_NAME_COUNT (sizeof(_keyNames) / sizeof(KeyName))
+#define MAXIMUM_CHILDREN (sizeof(((ElementSchema *) NULL)->children) / sizeof(const char *))
+
+static Logger * _logger = NULL;
+
+void initializeElementSchemaModule() {
+	_logger = createLogger("ElementSchema");
+}
+
+void shutdownElementSchemaModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static Entry * _findEntry(const Entries * entries, const char * key);
+static const ElementSchema * _findSchema(const char * type);
+static boolean _hasType(const Value * value, const char * type);
+static boolean _isString(const Value * value);
+static ElementKey _keyOf(const char * key);
+static const char * _nameOf(const ElementKey key);
+static const char * _pageElementOf(const Value * value);
+static boolean _validateChild(const ElementSchema * schema, const Entry * entry, boolean * hasChild);
+static boolean _validateValue(const ElementSchema * schema, const ElementKey key, const Entry * entry);
+
+/**
+ * The first entry with a key, or NULL.
+ */
+static Entry * _findEntry(const Entries * entries, const char * key) {
+	if (entries != NULL) {
+		for (int k = 0; k < entries->count; ++k) {
+			Entry * entry = entries->entries[k];
+			if (entry->key != NULL && strcmp(entry->key, key) == 0) {
+				return entry;
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * The schema of a type of element, or NULL if there is no such element.
+ */
+static const ElementSchema * _findSchema(const char * type) {
+	for (size_t k = 0; k < SCHEMA_COUNT; ++k) {
+		if (strcmp(_schemas[k].type, type) == 0) {
+			return &_schemas[k];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Whether a value is an element of a type.
+ */
+static boolean _hasType(const Value * value, const char * type) {
+	return value != NULL && value->type == OBJECT_VALUE && value->object != NULL
+		&& value->object->type != NULL && strcmp(value->object->type, type) == 0;
+}
+
+/**
+ * Whether a value is a string, or could be one (it depends on a loop
+ * variable, so it's known only while generating).
+ */
+static boolean _isString(const Value * value) {
+	return value != NULL && (value->type == STRING_VALUE || value->freeSlots != 0);
+}
+
+/**
+ * The bit of a key, or zero if no element has it.
+ */
+static ElementKey _keyOf(const char * key) {
+	for (size_t k = 0; k < KEY_NAME_COUNT; ++k) {
+		if (strcmp(_keyNames[k].name, key) == 0) {
+			return _keyNames[k].key;
+		}
+	}
+	return 0;
+}
+
+/**
+ * The name of a key, by its bit.
+ */
+static const char * _nameOf(const ElementKey key) {
+	for (size_t k = 0; k < KEY_NAME_COUNT; ++k) {
+		if (_keyNames[k].key == key) {
+			return _keyNames[k].name;
+		}
+	}
+	return "?";
+}
+
+/**
+ * The type of a value, if it's an element of the structure of a page, or
+ * NULL.
+ */
+static const char * _pageElementOf(const Value * value) {
+	for (size_t k = 0; k < PAGE_ELEMENT_COUNT; ++k) {
+		if (_hasType(value, _pageElements[k])) {
+			return _pageElements[k];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Validates an entry without key (an element on its own), that must be one
+ * of the children of the schema, and only once.
+ */
+static boolean _validateChild(const ElementSchema * schema, const Entry * entry, boolean * hasChild) {
+	for (size_t k = 0; k < MAXIMUM_CHILDREN && schema->children[k] != NULL; ++k) {
+		if (_hasType(entry->value, schema->children[k])) {
+			if (hasChild[k]) {
+				logError(_logger, "A \"%s\" element can have a single \"%s\" element.", schema->type, schema->children[k]);
+				return false;
+			}
+			hasChild[k] = true;
+			return true;
+		}
+	}
+	logError(_logger, "The entries of a \"%s\" element must have a key.", schema->type);
+	return false;
+}
+
+/**
+ * Validates the value of an entry with a key allowed by the schema.
+ */
+static boolean _validateValue(const ElementSchema * schema, const ElementKey key, const Entry * entry) {
+	if ((key & STRING_KEYS) && !_isString(entry->value)) {
+		logError(_logger, "The \"%s\" of a \"%s\" element must be a string.", entry->key, schema->type);
+		return false;
+	}
+	if (key == CONTENT_KEY && schema->content == STRING_CONTENT && !_isString(entry->value)) {
+		logError(_logger, "The content of a \"%s\" element must be a string.", schema->type);
+		return false;
+	}
+	if (key == CONTENT_KEY && schema->content == ELEMENT_CONTENT && !_hasType(entry->value, schema->contentType)) {
+		logError(_logger, "The content of a \"%s\" element must be a \"%s\" element.", schema->type, schema->contentType);
+		return false;
+	}
+	const char * pageElement = key == CONTENT_KEY && schema->content == ANY_CONTENT ? findPageElement(entry->value) : NULL;
+	if (pageElement != NULL) {
+		logError(_logger, "A \"%s\" element cannot be inside of a \"%s\" element.", pageElement, schema->type);
+		return false;
+	}
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+const char * validateElement(const Entries * entries) {
+	const Entry * typeEntry = _findEntry(entries, "type");
+	if (typeEntry == NULL || typeEntry->value == NULL || typeEntry->value->type != STRING_VALUE) {
+		logError(_logger, "An object must have a type.");
+		return NULL;
+	}
+	const ElementSchema * schema = _findSchema(typeEntry->value->string);
+	if (schema == NULL) {
+		logError(_logger, "There is no \"%s\" element.", typeEntry->value->string);
+		return NULL;
+	}
+	boolean isValid = true;
+	boolean hasChild[MAXIMUM_CHILDREN] = { false };
+	unsigned int keys = 0;
+	for (int k = 0; k < entries->count; ++k) {
+		const Entry * entry = entries->entries[k];
+		if (entry->key == NULL) {
+			isValid = _validateChild(schema, entry, hasChild) && isValid;
+			continue;
+		}
+		const ElementKey key = _keyOf(entry->key);
+		if (key == 0 || !((schema->allowedKeys | TYPE_KEY) & key)) {
+			logError(_logger, "A \"%s\" element cannot have a \"%s\".", schema->type, entry->key);
+			isValid = false;
+		}
+		else if (keys & key) {
+			logError(_logger, "The \"%s\" of a \"%s\" element is repeated.", entry->key, schema->type);
+			isValid = false;
+		}
+		else {
+			keys |= key;
+			isValid = _validateValue(schema, key, entry) && isValid;
+		}
+	}
+	for (unsigned int key = CONTENT_KEY; key <= EXT_REF_KEY; key <<= 1) {
+		if ((schema->requiredKeys & key) && !(keys & key)) {
+			logError(_logger, "A \"%s\" element must have a \"%s\".", schema->type, _nameOf(key));
+			isValid = false;
+		}
+	}
+	if (schema->linkKeys != 0 && __builtin_popcount(keys & schema->linkKeys) != 1) {
+		logError(_logger, "A \"%s\" element must have exactly one link (\"href\", \"ref\" or \"ext-ref\").", schema->type);
+		isValid = false;
+	}
+	for (size_t k = 0; k < MAXIMUM_CHILDREN && schema->children[k] != NULL; ++k) {
+		if (!hasChild[k]) {
+			logError(_logger, "A \"%s\" element must have a \"%s\" element.", schema->type, schema->children[k]);
+			isValid = false;
+		}
+	}
+	return isValid ? schema->type : NULL;
+}
+
+const char * findPageElement(const Value * value) {
+	if (value == NULL) {
+		return NULL;
+	}
+	switch (value->type) {
+		case OBJECT_VALUE:
+			return _pageElementOf(value);
+		case ARRAY_VALUE:
+			for (int k = 0; value->array != NULL && k < value->array->count; ++k) {
+				const char * type = findPageElement(value->array->elements[k]);
+				if (type != NULL) {
+					return type;
+				}
+			}
+			return NULL;
+		case FOR_VALUE:
+			return findPageElement(value->loop->body);
+		case IF_VALUE: {
+			const char * type = findPageElement(value->conditional->consequent);
+			return type != NULL ? type : findPageElement(value->conditional->alternative);
+		}
+		default:
+			return NULL;
+	}
+}
+
+Entry * findElementEntry(const Object * element, const char * key) {
+	return _findEntry(element->entries, key);
+}
+
+Object * findChildElement(const Object * element, const char * type) {
+	if (element->entries != NULL) {
+		for (int k = 0; k < element->entries->count; ++k) {
+			const Entry * entry = element->entries->entries[k];
+			if (entry->key == NULL && _hasType(entry->value, type)) {
+				return entry->value->object;
+			}
+		}
+	}
+	return NULL;
+}
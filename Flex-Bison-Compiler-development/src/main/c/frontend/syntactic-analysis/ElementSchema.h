@@ -0,0 +1,50 @@
+#ifndef ELEMENT_SCHEMA_HEADER
+#define ELEMENT_SCHEMA_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "AbstractSyntaxTree.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeElementSchemaModule();
+
+/** Shutdown module's internal state. */
+void shutdownElementSchemaModule();
+
+/**
+ * The grammar only knows generic objects (entries in any order, with any
+ * key), so the rules of each element are checked here, by the schema of its
+ * type: the keys it requires and allows, what their values must be, and the
+ * elements it has without key. Adding an element is adding a row to the
+ * table of schemas, instead of rules (and states) to the grammar.
+ */
+
+/**
+ * Validates the entries of an object against the schema of its type (the
+ * value of its "type" entry), logging every violation. Returns the name of
+ * the type, or NULL if the entries are not those of a valid element.
+ */
+const char * validateElement(const Entries * entries);
+
+/**
+ * The type of the first element of the structure of a page ("html", "head",
+ * "title" or "body") among the elements of a value (itself, or those of its
+ * arrays, loops and conditionals, but not of its elements), or NULL. Those
+ * are generated only as part of a page, so they cannot be content.
+ */
+const char * findPageElement(const Value * value);
+
+/**
+ * The entry of an element with a key, or NULL if it has none.
+ */
+Entry * findElementEntry(const Object * element, const char * key);
+
+/**
+ * The element of a type among the entries without key of another one (e.g.,
+ * the head of a page), or NULL if it has none.
+ */
+Object * findChildElement(const Object * element, const char * type);
+
+#endif
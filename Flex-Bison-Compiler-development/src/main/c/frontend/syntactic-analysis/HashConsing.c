@@ -0,0 +1,566 @@
+#include "HashConsing.h"
+
+/* MODULE INTERNAL STATE */
+
+typedef enum {
+	ARRAY_NODE,
+	OBJECT_NODE,
+	VALUE_NODE
+} NodeKind;
+
+typedef struct {
+	uint64_t hash;
+	void * node;
+	NodeKind kind;
+	// The canonical node of the shared table that took its place, once it's
+	// adopted (only in other tables).
+	void * adopted;
+} InternedNode;
+
+/**
+ * A node merged into an equal one while it was adopted, released when its
+ * table is destroyed (its parents in that table still point to it).
+ */
+typedef struct {
+	void * node;
+	NodeKind kind;
+} MergedNode;
+
+struct HashConsingTable {
+	InternedNode * nodes;
+	unsigned int capacity;
+	unsigned int occupied;
+
+	// Counted here instead of as statistics, since there is one per node.
+	unsigned int candidates;
+	unsigned int hits;
+
+	MergedNode * merged;
+	unsigned int mergedCount;
+	unsigned int mergedCapacity;
+};
+
+static const unsigned int _initialCapacity = 1024;
+static Logger * _logger = NULL;
+static char _tombstone;
+static HashConsingTable _sharedTable;
+static __thread HashConsingTable * _table = &_sharedTable;
+
+void initializeHashConsingModule() {
+	_logger = createLogger("HashConsing");
+	_sharedTable = (HashConsingTable) {
+		.nodes = calloc(_initialCapacity, sizeof(InternedNode)),
+		.capacity = _initialCapacity
+	};
+}
+
+void shutdownHashConsingModule() {
+	addToStatistic("hash-consing.candidates", _sharedTable.candidates);
+	addToStatistic("hash-consing.hits", _sharedTable.hits);
+	const double candidates = getStatistic("hash-consing.candidates");
+	if (0 < candidates) {
+		setStatistic("hash-consing.dedup-ratio", getStatistic("hash-consing.hits") / candidates);
+	}
+	if (_sharedTable.nodes != NULL) {
+		free(_sharedTable.nodes);
+		_sharedTable.nodes = NULL;
+	}
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _equalArrays(const Array * left, const Array * right);
+static boolean _equalEvaluations(const Evaluation * left, const Evaluation * right);
+static boolean _equalObjects(const Object * left, const Object * right);
+static boolean _equalStrings(const char * left, const char * right);
+static boolean _equalStyles(const StyleProperties * left, const StyleProperties * right);
+static boolean _equalValues(const Value * left, const Value * right);
+static boolean _equalNodes(const NodeKind kind, const void * left, const void * right);
+static Array * _adoptArray(HashConsingTable * table, Array * array);
+static void _adoptElement(HashConsingTable * table, HTMLElement * element);
+static Object * _adoptObject(HashConsingTable * table, Object * object);
+static Value * _adoptValue(HashConsingTable * table, Value * value);
+static InternedNode * _find(HashConsingTable * table, const uint64_t hash, const void * node);
+static void _forget(const uint64_t hash, const void * node);
+static void * _intern(HashConsingTable * table, const NodeKind kind, const uint64_t hash, void * node);
+static void _merge(HashConsingTable * table, const NodeKind kind, void * node);
+static void _rehash(HashConsingTable * table, const unsigned int capacity);
+
+static boolean _equalArrays(const Array * left, const Array * right) {
+	if (left->count != right->count) {
+		return false;
+	}
+	for (int k = 0; k < left->count; ++k) {
+		if (left->elements[k] != right->elements[k]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static boolean _equalEvaluations(const Evaluation * left, const Evaluation * right) {
+	if (left->count != right->count) {
+		return false;
+	}
+	for (unsigned int k = 0; k < left->count; ++k) {
+		if (left->instructions[k].type != right->instructions[k].type || left->instructions[k].operand != right->instructions[k].operand) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static boolean _equalObjects(const Object * left, const Object * right) {
+	if (!_equalStrings(left->type, right->type)) {
+		return false;
+	}
+	const int leftCount = left->entries == NULL ? 0 : left->entries->count;
+	const int rightCount = right->entries == NULL ? 0 : right->entries->count;
+	if (leftCount != rightCount) {
+		return false;
+	}
+	for (int k = 0; k < leftCount; ++k) {
+		const Entry * leftEntry = left->entries->entries[k];
+		const Entry * rightEntry = right->entries->entries[k];
+		if (!_equalStrings(leftEntry->key, rightEntry->key) || leftEntry->value != rightEntry->value
+				|| !_equalStyles(leftEntry->style, rightEntry->style)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static boolean _equalStrings(const char * left, const char * right) {
+	if (left == NULL || right == NULL) {
+		return left == right;
+	}
+	return strcmp(left, right) == 0;
+}
+
+/**
+ * Styles are equal if their canonical declarations are; a style that uses a
+ * loop variable has none, so it's only equal to itself.
+ */
+static boolean _equalStyles(const StyleProperties * left, const StyleProperties * right) {
+	if (left == NULL || right == NULL || left->declarations == NULL || right->declarations == NULL) {
+		return left == right;
+	}
+	return left->declarationsLength == right->declarationsLength
+		&& memcmp(left->declarations, right->declarations, left->declarationsLength) == 0;
+}
+
+static boolean _equalValues(const Value * left, const Value * right) {
+	if (left->type != right->type) {
+		return false;
+	}
+	switch (left->type) {
+		case STRING_VALUE: return _equalStrings(left->string, right->string);
+		case INCLUDE_VALUE: return _equalStrings(left->string, right->string);
+		case INTEGER_VALUE: return left->integer == right->integer;
+		case REAL_VALUE: return memcmp(&left->real, &right->real, sizeof(double)) == 0;
+		case BOOLEAN_VALUE: return left->boolean == right->boolean;
+		case NULL_VALUE: return true;
+		case OBJECT_VALUE: return left->object == right->object;
+		case ARRAY_VALUE: return left->array == right->array;
+		case FOR_VALUE:
+			return left->loop->slot == right->loop->slot
+				&& left->loop->iterable == right->loop->iterable
+				&& left->loop->body == right->loop->body;
+		case IF_VALUE:
+			return left->conditional->condition == right->conditional->condition
+				&& left->conditional->consequent == right->conditional->consequent
+				&& left->conditional->alternative == right->conditional->alternative;
+		case SLOT_VALUE: return left->slot == right->slot;
+		case EXPRESSION_VALUE: return _equalEvaluations(left->evaluation, right->evaluation);
+		default:
+			return false;
+	}
+}
+
+static boolean _equalNodes(const NodeKind kind, const void * left, const void * right) {
+	switch (kind) {
+		case ARRAY_NODE: return _equalArrays(left, right);
+		case OBJECT_NODE: return _equalObjects(left, right);
+		case VALUE_NODE: return _equalValues(left, right);
+		default:
+			return false;
+	}
+}
+
+/**
+ * Adopts the elements of an array, and then the array itself.
+ */
+static Array * _adoptArray(HashConsingTable * table, Array * array) {
+	InternedNode * interned = _find(table, array->hash, array);
+	if (interned == NULL || interned->adopted != NULL) {
+		return interned == NULL ? array : interned->adopted;
+	}
+	for (int k = 0; k < array->count; ++k) {
+		if (array->elements[k] != NULL) {
+			array->elements[k] = _adoptValue(table, array->elements[k]);
+		}
+	}
+	Array * canonical = _intern(&_sharedTable, ARRAY_NODE, array->hash, array);
+	if (canonical != NULL) {
+		canonical->references += array->references;
+		_merge(table, ARRAY_NODE, array);
+	}
+	interned->adopted = canonical == NULL ? array : canonical;
+	return interned->adopted;
+}
+
+/**
+ * Follows the values that an element lowered from an object borrows from its
+ * entries, once they are adopted (so they're only looked up).
+ */
+static void _adoptElement(HashConsingTable * table, HTMLElement * element) {
+	Value ** fields[4] = { NULL };
+	switch (element->type) {
+		case DIV_ELEMENT: fields[0] = &((HTMLElementDiv *) element)->content; break;
+		case P_ELEMENT: fields[0] = &((HTMLElementP *) element)->content; break;
+		case H1_ELEMENT: fields[0] = &((HTMLElementH1 *) element)->content; break;
+		case CENTER_ELEMENT: fields[0] = &((HTMLElementCenter *) element)->content; break;
+		case IMG_ELEMENT:
+			fields[0] = &((HTMLElementImg *) element)->src;
+			fields[1] = &((HTMLElementImg *) element)->alt;
+			break;
+		case A_ELEMENT:
+			fields[0] = &((HTMLElementA *) element)->content;
+			fields[1] = &((HTMLElementA *) element)->href;
+			fields[2] = &((HTMLElementA *) element)->ref;
+			fields[3] = &((HTMLElementA *) element)->extRef;
+			break;
+		default:
+			break;
+	}
+	for (unsigned int k = 0; k < 4 && fields[k] != NULL; ++k) {
+		if (*fields[k] != NULL) {
+			*fields[k] = _adoptValue(table, *fields[k]);
+		}
+	}
+}
+
+/**
+ * Adopts the values of the entries of an object (and those of its styles,
+ * and of its element), and then the object itself.
+ */
+static Object * _adoptObject(HashConsingTable * table, Object * object) {
+	InternedNode * interned = _find(table, object->hash, object);
+	if (interned == NULL || interned->adopted != NULL) {
+		return interned == NULL ? object : interned->adopted;
+	}
+	if (object->entries != NULL) {
+		for (int k = 0; k < object->entries->count; ++k) {
+			Entry * entry = object->entries->entries[k];
+			if (entry->value != NULL) {
+				entry->value = _adoptValue(table, entry->value);
+			}
+			for (int j = 0; entry->style != NULL && j < entry->style->count; ++j) {
+				StyleValue * styleValue = entry->style->properties[j]->value;
+				if (styleValue->type == EXPRESSION_STYLE) {
+					styleValue->expression = _adoptValue(table, styleValue->expression);
+				}
+			}
+		}
+	}
+	if (object->element != NULL) {
+		_adoptElement(table, object->element);
+	}
+	Object * canonical = _intern(&_sharedTable, OBJECT_NODE, object->hash, object);
+	if (canonical != NULL) {
+		canonical->references += object->references;
+		_merge(table, OBJECT_NODE, object);
+	}
+	interned->adopted = canonical == NULL ? object : canonical;
+	return interned->adopted;
+}
+
+/**
+ * Adopts the children of a value, and then the value itself. A node that was
+ * already adopted (it's shared by several parents) is adopted only once.
+ */
+static Value * _adoptValue(HashConsingTable * table, Value * value) {
+	InternedNode * interned = _find(table, value->hash, value);
+	if (interned == NULL || interned->adopted != NULL) {
+		return interned == NULL ? value : interned->adopted;
+	}
+	switch (value->type) {
+		case OBJECT_VALUE:
+			value->object = value->object == NULL ? NULL : _adoptObject(table, value->object);
+			break;
+		case ARRAY_VALUE:
+			value->array = value->array == NULL ? NULL : _adoptArray(table, value->array);
+			break;
+		case FOR_VALUE:
+			value->loop->iterable = _adoptValue(table, value->loop->iterable);
+			value->loop->body = _adoptValue(table, value->loop->body);
+			break;
+		case IF_VALUE:
+			value->conditional->condition = _adoptValue(table, value->conditional->condition);
+			value->conditional->consequent = _adoptValue(table, value->conditional->consequent);
+			if (value->conditional->alternative != NULL) {
+				value->conditional->alternative = _adoptValue(table, value->conditional->alternative);
+			}
+			break;
+		case EXPRESSION_VALUE:
+			for (unsigned int k = 0; k < value->evaluation->count; ++k) {
+				Instruction * instruction = &value->evaluation->instructions[k];
+				if (instruction->operand != NULL) {
+					instruction->operand = _adoptValue(table, instruction->operand);
+				}
+			}
+			break;
+		default:
+			break;
+	}
+	Value * canonical = _intern(&_sharedTable, VALUE_NODE, value->hash, value);
+	if (canonical != NULL) {
+		canonical->references += value->references;
+		_merge(table, VALUE_NODE, value);
+	}
+	interned->adopted = canonical == NULL ? value : canonical;
+	return interned->adopted;
+}
+
+/**
+ * The slot of the exact node (by address) in a table, or NULL if it was
+ * never interned there.
+ */
+static InternedNode * _find(HashConsingTable * table, const uint64_t hash, const void * node) {
+	if (table->nodes == NULL) {
+		return NULL;
+	}
+	const unsigned int mask = table->capacity - 1;
+	for (unsigned int k = hash & mask; table->nodes[k].node != NULL; k = (k + 1) & mask) {
+		if (table->nodes[k].node == node) {
+			return &table->nodes[k];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Removes the exact node (by address) from the table of the calling thread,
+ * leaving a tombstone so the probing sequences of other nodes aren't broken.
+ * Candidates that were never interned are silently ignored.
+ */
+static void _forget(const uint64_t hash, const void * node) {
+	InternedNode * interned = _find(_table, hash, node);
+	if (interned != NULL) {
+		interned->node = &_tombstone;
+	}
+}
+
+/**
+ * Returns the canonical node equal to the specified one, or inserts it and
+ * returns NULL. Linear probing keeps the probes on the same cache lines.
+ */
+static void * _intern(HashConsingTable * table, const NodeKind kind, const uint64_t hash, void * node) {
+	if (table->capacity < 2 * (table->occupied + 1)) {
+		_rehash(table, 2 * table->capacity);
+	}
+	const unsigned int mask = table->capacity - 1;
+	InternedNode * tombstone = NULL;
+	unsigned int k = hash & mask;
+	for (; table->nodes[k].node != NULL; k = (k + 1) & mask) {
+		if (table->nodes[k].node == &_tombstone) {
+			if (tombstone == NULL) {
+				tombstone = &table->nodes[k];
+			}
+		}
+		else if (table->nodes[k].hash == hash && table->nodes[k].kind == kind && _equalNodes(kind, table->nodes[k].node, node)) {
+			return table->nodes[k].node;
+		}
+	}
+	InternedNode * slot = tombstone == NULL ? &table->nodes[k] : tombstone;
+	if (tombstone == NULL) {
+		++table->occupied;
+	}
+	slot->hash = hash;
+	slot->node = node;
+	slot->kind = kind;
+	slot->adopted = NULL;
+	return NULL;
+}
+
+/**
+ * Remembers a node merged into an equal one while it was adopted (it can't
+ * be released yet: other nodes of its table may still point to it).
+ */
+static void _merge(HashConsingTable * table, const NodeKind kind, void * node) {
+	if (table->mergedCount == table->mergedCapacity) {
+		table->mergedCapacity = table->mergedCapacity == 0 ? 64 : 2 * table->mergedCapacity;
+		table->merged = realloc(table->merged, table->mergedCapacity * sizeof(MergedNode));
+	}
+	table->merged[table->mergedCount++] = (MergedNode) {
+		.node = node,
+		.kind = kind
+	};
+	++table->hits;
+}
+
+/**
+ * Rebuilds a table with a new capacity (a power of 2), dropping tombstones.
+ */
+static void _rehash(HashConsingTable * table, const unsigned int capacity) {
+	InternedNode * oldNodes = table->nodes;
+	const unsigned int oldCapacity = table->capacity;
+	table->nodes = calloc(capacity, sizeof(InternedNode));
+	table->capacity = capacity;
+	table->occupied = 0;
+	const unsigned int mask = capacity - 1;
+	for (unsigned int j = 0; j < oldCapacity; ++j) {
+		if (oldNodes[j].node != NULL && oldNodes[j].node != &_tombstone) {
+			unsigned int k = oldNodes[j].hash & mask;
+			while (table->nodes[k].node != NULL) {
+				k = (k + 1) & mask;
+			}
+			table->nodes[k] = oldNodes[j];
+			++table->occupied;
+		}
+	}
+	free(oldNodes);
+	logDebugging(_logger, "Table rehashed (capacity = %u, occupied = %u).", table->capacity, table->occupied);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Array * internArray(Array * array) {
+	uint64_t hash = ARRAY_VALUE;
+	for (int k = 0; k < array->count; ++k) {
+		hash = combineHashes(hash, array->elements[k] == NULL ? 0 : array->elements[k]->hash);
+	}
+	array->hash = hash;
+	++_table->candidates;
+	Array * canonical = _intern(_table, ARRAY_NODE, hash, array);
+	if (canonical == NULL) {
+		array->references = 1;
+		return array;
+	}
+	++_table->hits;
+	releaseArray(array);
+	++canonical->references;
+	return canonical;
+}
+
+Object * internObject(Object * object) {
+	uint64_t hash = hashString(object->type, OBJECT_VALUE);
+	if (object->entries != NULL) {
+		for (int k = 0; k < object->entries->count; ++k) {
+			const Entry * entry = object->entries->entries[k];
+			hash = combineHashes(hash, hashString(entry->key, 0));
+			hash = combineHashes(hash, entry->value == NULL ? 0 : entry->value->hash);
+			hash = combineHashes(hash, entry->style == NULL ? 0 : entry->style->hash);
+		}
+	}
+	object->hash = hash;
+	++_table->candidates;
+	Object * canonical = _intern(_table, OBJECT_NODE, hash, object);
+	if (canonical == NULL) {
+		object->references = 1;
+		return object;
+	}
+	++_table->hits;
+	releaseObject(object);
+	++canonical->references;
+	return canonical;
+}
+
+Value * internValue(Value * value) {
+	uint64_t payload = 0;
+	switch (value->type) {
+		case STRING_VALUE: payload = hashString(value->string, 0); break;
+		case INCLUDE_VALUE: payload = hashString(value->string, 0); break;
+		case INTEGER_VALUE: payload = (uint64_t) value->integer; break;
+		case REAL_VALUE: memcpy(&payload, &value->real, sizeof(double)); break;
+		case BOOLEAN_VALUE: payload = (uint64_t) value->boolean; break;
+		case NULL_VALUE: payload = 0; break;
+		case OBJECT_VALUE: payload = value->object == NULL ? 0 : value->object->hash; break;
+		case ARRAY_VALUE: payload = value->array == NULL ? 0 : value->array->hash; break;
+		case FOR_VALUE:
+			payload = combineHashes(value->loop->slot, value->loop->iterable->hash);
+			payload = combineHashes(payload, value->loop->body->hash);
+			break;
+		case IF_VALUE:
+			payload = combineHashes(value->conditional->condition->hash, value->conditional->consequent->hash);
+			payload = combineHashes(payload, value->conditional->alternative == NULL ? 0 : value->conditional->alternative->hash);
+			break;
+		case SLOT_VALUE: payload = (uint64_t) value->slot; break;
+		case EXPRESSION_VALUE:
+			for (unsigned int k = 0; k < value->evaluation->count; ++k) {
+				const Instruction * instruction = &value->evaluation->instructions[k];
+				payload = combineHashes(payload, instruction->operand == NULL ? instruction->type : instruction->operand->hash);
+			}
+			break;
+	}
+	value->hash = combineHashes(value->type, payload);
+	++_table->candidates;
+	Value * canonical = _intern(_table, VALUE_NODE, value->hash, value);
+	if (canonical == NULL) {
+		value->references = 1;
+		return value;
+	}
+	++_table->hits;
+	releaseValue(value);
+	++canonical->references;
+	return canonical;
+}
+
+void forgetArray(Array * array) {
+	_forget(array->hash, array);
+}
+
+void forgetObject(Object * object) {
+	_forget(object->hash, object);
+}
+
+void forgetValue(Value * value) {
+	_forget(value->hash, value);
+}
+
+HashConsingTable * createHashConsingTable() {
+	HashConsingTable * table = calloc(1, sizeof(HashConsingTable));
+	table->capacity = _initialCapacity;
+	table->nodes = calloc(table->capacity, sizeof(InternedNode));
+	return table;
+}
+
+void destroyHashConsingTable(HashConsingTable * table) {
+	if (table == NULL) {
+		return;
+	}
+	// Merged nodes point to canonical children, so they are released here.
+	for (unsigned int k = 0; k < table->mergedCount; ++k) {
+		const MergedNode * merged = &table->merged[k];
+		switch (merged->kind) {
+			case ARRAY_NODE:
+				((Array *) merged->node)->references = 1;
+				releaseArray(merged->node);
+				break;
+			case OBJECT_NODE:
+				((Object *) merged->node)->references = 1;
+				releaseObject(merged->node);
+				break;
+			case VALUE_NODE:
+				((Value *) merged->node)->references = 1;
+				releaseValue(merged->node);
+				break;
+		}
+	}
+	addToStatistic("hash-consing.candidates", table->candidates);
+	addToStatistic("hash-consing.hits", table->hits);
+	free(table->merged);
+	free(table->nodes);
+	free(table);
+}
+
+void useHashConsingTable(HashConsingTable * table) {
+	_table = table == NULL ? &_sharedTable : table;
+}
+
+Value * adoptValue(HashConsingTable * table, Value * value) {
+	return value == NULL ? NULL : _adoptValue(table, value);
+}
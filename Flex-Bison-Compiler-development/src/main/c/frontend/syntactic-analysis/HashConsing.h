@@ -0,0 +1,75 @@
+#ifndef HASH_CONSING_HEADER
+#define HASH_CONSING_HEADER
+
+#include "../../shared/Hash.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Statistics.h"
+#include "../../shared/Type.h"
+#include "AbstractSyntaxTree.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeHashConsingModule();
+
+/** Shutdown module's internal state. */
+void shutdownHashConsingModule();
+
+/**
+ * Hash-consing of the generic nodes of the AST. Every function receives a
+ * freshly built node whose children are already interned, and returns the
+ * canonical node that is structurally equal to it. If an equal node already
+ * exists, the candidate is released and the existing node gains one more
+ * reference; otherwise, the candidate becomes the canonical node.
+ *
+ * Because children are always canonical, structural equality reduces to
+ * comparing scalars and child pointers, so interning a node is O(1) in the
+ * size of its subtree.
+ *
+ * @see https://en.wikipedia.org/wiki/Hash_consing
+ */
+Array * internArray(Array * array);
+Object * internObject(Object * object);
+Value * internValue(Value * value);
+
+/**
+ * Removes a canonical node from the table. Must be called by the destructors
+ * just before the last reference to a node is released.
+ */
+void forgetArray(Array * array);
+void forgetObject(Object * object);
+void forgetValue(Value * value);
+
+/**
+ * A table of canonical nodes of its own, for a worker that builds values on
+ * another thread: nodes are interned in the shared table unless the calling
+ * thread uses another one (see "useHashConsingTable"). Nodes of different
+ * tables are never shared, so each table must be used by a thread at a time.
+ */
+typedef struct HashConsingTable HashConsingTable;
+
+HashConsingTable * createHashConsingTable();
+
+/**
+ * Destroys a table once every node interned in it was adopted or released.
+ * Must be called by a thread that uses the shared table.
+ */
+void destroyHashConsingTable(HashConsingTable * table);
+
+/**
+ * Makes the calling thread intern (and forget) nodes in a table of its own,
+ * or in the shared one again (if NULL).
+ */
+void useHashConsingTable(HashConsingTable * table);
+
+/**
+ * Moves a value interned in another table (and every node of its subtree)
+ * to the shared one, merging each node with the canonical one that is equal
+ * to it, if any. The reference to the value becomes a reference to the
+ * returned one. Must be called by a thread that uses the shared table, while
+ * no other thread uses the other one.
+ */
+Value * adoptValue(HashConsingTable * table, Value * value);
+
+#endif
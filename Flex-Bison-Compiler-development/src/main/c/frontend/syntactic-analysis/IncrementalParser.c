@@ -0,0 +1,631 @@
+#include "IncrementalParser.h"
+
+/* MODULE INTERNAL STATE */
+
+typedef struct Region Region;
+
+/**
+ * A balanced region of the source, and the composite value parsed from it.
+ * The offset is relative to the start of the parent (or of the source, for
+ * the root), so an edit only shifts the regions that follow it inside each
+ * one of its ancestors. The slot is the index of the value inside the entries
+ * (or elements) of the value of the parent.
+ */
+struct Region {
+	size_t offset;
+	size_t length;
+	Value * value;
+	Region * parent;
+	unsigned int index;
+	unsigned int slot;
+	Region ** children;
+	unsigned int count;
+	unsigned int capacity;
+};
+
+struct IncrementalDocument {
+	Buffer * source;
+	Value * root;
+
+	// The index of the regions, or NULL if the tree could not be indexed.
+	Region * rootRegion;
+
+	// Whether the last edit was rejected (so the tree is out of date).
+	boolean stale;
+
+	// The path to the region replaced by the last edit, if incremental, and
+	// the value it had (kept until the next edit, so it can be looked up).
+	boolean isIncremental;
+	unsigned int * path;
+	unsigned int depth;
+	unsigned int pathCapacity;
+	Value * changedValue;
+	Value * previousValue;
+};
+
+static Logger * _logger = NULL;
+
+void initializeIncrementalParserModule() {
+	_logger = createLogger("IncrementalParser");
+}
+
+void shutdownIncrementalParserModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static void _addRegion(Region * parent, Region * child);
+static StyleProperties * _copyStyle(const StyleProperties * style);
+static unsigned int _countRegions(const Value * value);
+static char * _duplicate(const char * string);
+static char * _duplicateBytes(const char * bytes, const size_t length);
+static Region * _findEnclosingRegion(Region * root, const size_t offset, const size_t removedLength, size_t * start);
+static boolean _isComposite(const Value * value);
+static boolean _isDeclaration(const char * text, const size_t length, const size_t offset);
+static boolean _isWordCharacter(const char character);
+static boolean _pairRegions(Region * region, Value * value);
+static boolean _pairSlot(Region * region, unsigned int * next, const unsigned int slot, Value * value, const unsigned int extraCount);
+static void _recordPath(IncrementalDocument * document, const Region * region);
+static void _releaseRegion(Region * region);
+static Value * _replaceSlot(const Value * parent, const unsigned int slot, Value * child);
+static SyntacticAnalysisStatus _reparseEntireSource(IncrementalDocument * document);
+static Region * _scanRegions(const char * text, const size_t length);
+static void _shiftFollowingSiblings(Region * region, const size_t insertedLength, const size_t removedLength);
+
+/**
+ * Appends a child region.
+ */
+static void _addRegion(Region * parent, Region * child) {
+	if (parent->count == parent->capacity) {
+		parent->capacity = parent->capacity == 0 ? 4 : 2 * parent->capacity;
+		parent->children = realloc(parent->children, parent->capacity * sizeof(Region *));
+	}
+	child->parent = parent;
+	child->index = parent->count;
+	parent->children[parent->count++] = child;
+}
+
+/**
+ * Copies a style (the entries of an object own theirs), using heap-memory.
+ */
+static StyleProperties * _copyStyle(const StyleProperties * style) {
+	if (style == NULL) {
+		return NULL;
+	}
+	StyleProperties * copy = calloc(1, sizeof(StyleProperties));
+	*copy = *style;
+	copy->properties = malloc(style->count * sizeof(StyleProperty *));
+	for (int k = 0; k < style->count; ++k) {
+		const StyleProperty * property = style->properties[k];
+		StyleValue * value = malloc(sizeof(StyleValue));
+		*value = *property->value;
+		if (value->type == STRING_STYLE || value->type == CSS_KEYWORD_STYLE) {
+			value->string = _duplicate(value->string);
+		}
+		else if (value->type == EXPRESSION_STYLE) {
+			++value->expression->references;
+		}
+		copy->properties[k] = malloc(sizeof(StyleProperty));
+		copy->properties[k]->key = _duplicate(property->key);
+		copy->properties[k]->value = value;
+	}
+	copy->declarations = _duplicateBytes(style->declarations, style->declarationsLength);
+	copy->attribute = _duplicateBytes(style->attribute, style->attributeLength);
+	return copy;
+}
+
+/**
+ * How many regions (but the ones nested in them) the source of a value spans:
+ * one if it's composite, and those of its parts if it's a loop, a conditional
+ * or an expression (parentheses have no region, see "_scanRegions").
+ */
+static unsigned int _countRegions(const Value * value) {
+	if (value == NULL) {
+		return 0;
+	}
+	switch (value->type) {
+		case OBJECT_VALUE:
+		case ARRAY_VALUE:
+			return 1;
+		case FOR_VALUE:
+			return _countRegions(value->loop->iterable) + _countRegions(value->loop->body);
+		case IF_VALUE:
+			return _countRegions(value->conditional->condition) + _countRegions(value->conditional->consequent)
+				+ _countRegions(value->conditional->alternative);
+		case EXPRESSION_VALUE: {
+			unsigned int count = 0;
+			for (unsigned int k = 0; k < value->evaluation->count; ++k) {
+				count += _countRegions(value->evaluation->instructions[k].operand);
+			}
+			return count;
+		}
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Duplicates a string (that may be NULL), using heap-memory.
+ */
+static char * _duplicate(const char * string) {
+	return string == NULL ? NULL : strdup(string);
+}
+
+/**
+ * Duplicates a block of bytes (that may be NULL), using heap-memory.
+ */
+static char * _duplicateBytes(const char * bytes, const size_t length) {
+	if (bytes == NULL) {
+		return NULL;
+	}
+	char * copy = malloc(length + 1);
+	memcpy(copy, bytes, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+/**
+ * Finds the smallest region whose inside (i.e., excluding its delimiters)
+ * encloses the removed range, descending with a binary search over the
+ * children of each region. Returns NULL if not even the root encloses it.
+ */
+static Region * _findEnclosingRegion(Region * root, const size_t offset, const size_t removedLength, size_t * start) {
+	size_t regionStart = root->offset;
+	if (!(regionStart < offset && offset + removedLength < regionStart + root->length)) {
+		return NULL;
+	}
+	Region * region = root;
+	while (0 < region->count) {
+		// The last child that starts before the edit.
+		unsigned int low = 0;
+		unsigned int high = region->count;
+		while (low < high) {
+			const unsigned int middle = low + (high - low) / 2;
+			if (regionStart + region->children[middle]->offset < offset) {
+				low = middle + 1;
+			}
+			else {
+				high = middle;
+			}
+		}
+		if (low == 0) {
+			break;
+		}
+		Region * child = region->children[low - 1];
+		const size_t childStart = regionStart + child->offset;
+		if (offset + removedLength >= childStart + child->length) {
+			break;
+		}
+		region = child;
+		regionStart = childStart;
+	}
+	*start = regionStart;
+	return region;
+}
+
+/**
+ * Whether the value spans a region of the source (an object or an array).
+ */
+static boolean _isComposite(const Value * value) {
+	return value != NULL && (value->type == OBJECT_VALUE || value->type == ARRAY_VALUE);
+}
+
+/**
+ * Whether the keyword that declares a variable starts at an offset of a text
+ * (and not just a word that contains it).
+ */
+static boolean _isDeclaration(const char * text, const size_t length, const size_t offset) {
+	return offset + 3 <= length && strncmp(text + offset, "var", 3) == 0
+		&& (offset == 0 || !_isWordCharacter(text[offset - 1]))
+		&& (length == offset + 3 || !_isWordCharacter(text[offset + 3]));
+}
+
+/**
+ * Whether a character can be part of a word (e.g., a key or a keyword).
+ */
+static boolean _isWordCharacter(const char character) {
+	return isalnum((unsigned char) character) || character == '_' || character == '-';
+}
+
+/**
+ * Binds each region to its value, walking both trees in pre-order. Fails if
+ * the children of a value do not match the child regions.
+ */
+static boolean _pairRegions(Region * region, Value * value) {
+	if (!_isComposite(value)) {
+		return false;
+	}
+	region->value = value;
+	unsigned int next = 0;
+	if (value->type == ARRAY_VALUE) {
+		const int count = value->array == NULL ? 0 : value->array->count;
+		for (int k = 0; k < count; ++k) {
+			if (!_pairSlot(region, &next, k, value->array->elements[k], 0)) {
+				return false;
+			}
+		}
+	}
+	else {
+		const Entries * entries = value->object == NULL ? NULL : value->object->entries;
+		const int count = entries == NULL ? 0 : entries->count;
+		for (int k = 0; k < count; ++k) {
+			const Entry * entry = entries->entries[k];
+			if (entry != NULL && !_pairSlot(region, &next, k, entry->value, entry->style == NULL ? 0 : 1)) {
+				return false;
+			}
+		}
+	}
+	return next == region->count;
+}
+
+/**
+ * Binds the next child regions of a region to the value at a slot of its
+ * value. A composite value has a region of its own, but the rest only span
+ * those of their parts (e.g., the body of a loop, that is a template), plus
+ * the extra ones given (e.g., the one of a style). These can't be reparsed
+ * alone, so they're left without value.
+ */
+static boolean _pairSlot(Region * region, unsigned int * next, const unsigned int slot, Value * value, const unsigned int extraCount) {
+	const unsigned int opaqueCount = extraCount + (_isComposite(value) ? 0 : _countRegions(value));
+	for (unsigned int k = 0; k < opaqueCount; ++k) {
+		if (region->count <= *next) {
+			return false;
+		}
+		region->children[*next]->slot = slot;
+		region->children[(*next)++]->value = NULL;
+	}
+	if (!_isComposite(value)) {
+		return true;
+	}
+	if (region->count <= *next) {
+		return false;
+	}
+	region->children[*next]->slot = slot;
+	return _pairRegions(region->children[(*next)++], value);
+}
+
+/**
+ * Records the indexes of the region and its ancestors (but the root), from
+ * the top down.
+ */
+static void _recordPath(IncrementalDocument * document, const Region * region) {
+	unsigned int depth = 0;
+	for (const Region * current = region; current->parent != NULL; current = current->parent) {
+		++depth;
+	}
+	if (document->pathCapacity < depth) {
+		document->pathCapacity = depth;
+		document->path = realloc(document->path, depth * sizeof(unsigned int));
+	}
+	document->depth = depth;
+	for (const Region * current = region; current->parent != NULL; current = current->parent) {
+		document->path[--depth] = current->index;
+	}
+	document->changedValue = region->value;
+	document->isIncremental = true;
+}
+
+/**
+ * Releases a region and its descendants (but not their values).
+ */
+static void _releaseRegion(Region * region) {
+	if (region == NULL) {
+		return;
+	}
+	for (unsigned int k = 0; k < region->count; ++k) {
+		_releaseRegion(region->children[k]);
+	}
+	free(region->children);
+	free(region);
+}
+
+/**
+ * Creates a copy of a composite value where the child at the slot is replaced.
+ * The replaced child is not released, and the ownership of the new one is
+ * transferred to the copy; every other child is shared with the original.
+ */
+static Value * _replaceSlot(const Value * parent, const unsigned int slot, Value * child) {
+	if (parent->type == ARRAY_VALUE) {
+		Array * array = createArray();
+		for (int k = 0; k < parent->array->count; ++k) {
+			Value * element = parent->array->elements[k];
+			if ((unsigned int) k == slot) {
+				element = child;
+			}
+			else if (element != NULL) {
+				++element->references;
+			}
+			addArrayElement(array, element);
+		}
+		return createArrayValue(array);
+	}
+	Entries * entries = createEntries();
+	for (int k = 0; k < parent->object->entries->count; ++k) {
+		const Entry * entry = parent->object->entries->entries[k];
+		Value * value = entry->value;
+		if ((unsigned int) k == slot) {
+			value = child;
+		}
+		else if (value != NULL) {
+			++value->references;
+		}
+		Entry * copy = createEntry(_duplicate(entry->key), value);
+		copy->style = _copyStyle(entry->style);
+		addEntry(entries, copy);
+	}
+	return createObjectValue(createObject(_duplicate(parent->object->type), entries));
+}
+
+/**
+ * Parses the entire source again, and rebuilds the index of its regions.
+ */
+static SyntacticAnalysisStatus _reparseEntireSource(IncrementalDocument * document) {
+	addToStatistic("incremental.full-reparses", 1);
+	Value * root = NULL;
+	const SyntacticAnalysisStatus status = parseValue(document->source->bytes, document->source->length, &root);
+	if (status != ACCEPT) {
+		document->stale = true;
+		return status;
+	}
+	_releaseRegion(document->rootRegion);
+	document->rootRegion = NULL;
+	Region * regions = _scanRegions(document->source->bytes, document->source->length);
+	if (regions != NULL && regions->count == 1 && _pairRegions(regions->children[0], root)) {
+		document->rootRegion = regions->children[0];
+		document->rootRegion->parent = NULL;
+		regions->count = 0;
+	}
+	else {
+		logDebugging(_logger, "The tree does not match the regions of the source (edits will reparse it entirely).");
+	}
+	_releaseRegion(regions);
+	if (document->root != NULL) {
+		releaseValue(document->root);
+	}
+	document->root = root;
+	document->stale = false;
+	document->isIncremental = false;
+	document->depth = 0;
+	document->changedValue = root;
+	return ACCEPT;
+}
+
+/**
+ * Indexes the balanced regions of a text, skipping strings and comments like
+ * the scanner does (where "(" and ")" are also braces, but have no region of
+ * their own, since they only group an expression). Returns a container
+ * region whose children are the top-level regions, or NULL if the text is
+ * unbalanced, ends inside a string or a comment, or declares a variable
+ * (its value is substituted wherever it's referenced, so the tree can't be
+ * paired with the regions, nor can a reference be reparsed alone).
+ */
+static Region * _scanRegions(const char * text, const size_t length) {
+	Region * container = calloc(1, sizeof(Region));
+	container->length = length;
+	Region * current = container;
+	size_t currentStart = 0;
+	for (size_t k = 0; k < length; ++k) {
+		const char character = text[k];
+		if (character == '"') {
+			for (++k; k < length && text[k] != '"'; ++k) {
+				if (text[k] == '\\') {
+					++k;
+				}
+			}
+			if (length <= k) {
+				_releaseRegion(container);
+				return NULL;
+			}
+		}
+		else if (character == '/' && k + 1 < length && text[k + 1] == '*') {
+			for (k += 2; k + 1 < length && !(text[k] == '*' && text[k + 1] == '/'); ++k);
+			if (length <= k + 1) {
+				_releaseRegion(container);
+				return NULL;
+			}
+			++k;
+		}
+		else if (character == 'v' && _isDeclaration(text, length, k)) {
+			_releaseRegion(container);
+			return NULL;
+		}
+		else if (character == '{' || character == '(' || character == '[') {
+			Region * region = calloc(1, sizeof(Region));
+			region->offset = k - currentStart;
+			// Temporarily, the length holds the delimiter that closes the region.
+			region->length = character == '[' ? ']' : character == '(' ? ')' : '}';
+			_addRegion(current, region);
+			current = region;
+			currentStart = k;
+		}
+		else if (character == '}' || character == ')' || character == ']') {
+			const boolean isBalanced = character == ']'
+				? current->length == ']'
+				: current->length == '}' || current->length == ')';
+			if (current == container || !isBalanced) {
+				_releaseRegion(container);
+				return NULL;
+			}
+			Region * region = current;
+			currentStart -= region->offset;
+			current = region->parent;
+			if (region->length == ')') {
+				// Parentheses only group (they have no value), so their regions are
+				// those of their parent.
+				--current->count;
+				for (unsigned int j = 0; j < region->count; ++j) {
+					region->children[j]->offset += region->offset;
+					_addRegion(current, region->children[j]);
+				}
+				region->count = 0;
+				_releaseRegion(region);
+			}
+			else {
+				region->length = k - currentStart - region->offset + 1;
+			}
+		}
+	}
+	if (current != container) {
+		_releaseRegion(container);
+		return NULL;
+	}
+	return container;
+}
+
+/**
+ * Shifts the siblings that follow a region after its length changed.
+ */
+static void _shiftFollowingSiblings(Region * region, const size_t insertedLength, const size_t removedLength) {
+	Region * parent = region->parent;
+	if (parent == NULL) {
+		return;
+	}
+	for (unsigned int k = region->index + 1; k < parent->count; ++k) {
+		parent->children[k]->offset += insertedLength;
+		parent->children[k]->offset -= removedLength;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+IncrementalDocument * createIncrementalDocument(const char * source, const size_t length) {
+	IncrementalDocument * document = calloc(1, sizeof(IncrementalDocument));
+	document->source = createBuffer(length + 1);
+	appendToBuffer(document->source, source, length);
+	_reparseEntireSource(document);
+	return document;
+}
+
+SyntacticAnalysisStatus editIncrementalDocument(IncrementalDocument * document, const size_t offset, const size_t removedLength, const char * inserted, const size_t insertedLength) {
+	Buffer * source = document->source;
+	if (source->length < offset + removedLength) {
+		logError(_logger, "The edit is out of the source (%zu + %zu > %zu).", offset, removedLength, source->length);
+		return REJECT;
+	}
+	addToStatistic("incremental.edits", 1);
+	if (document->previousValue != NULL) {
+		releaseValue(document->previousValue);
+		document->previousValue = NULL;
+	}
+	document->isIncremental = false;
+	// The region is found before the edit, since the index is not shifted yet.
+	size_t regionStart = 0;
+	Region * region = NULL;
+	if (!document->stale && document->rootRegion != NULL) {
+		region = _findEnclosingRegion(document->rootRegion, offset, removedLength, &regionStart);
+	}
+	reserveBuffer(source, insertedLength);
+	memmove(source->bytes + offset + insertedLength, source->bytes + offset + removedLength, source->length - offset - removedLength);
+	memcpy(source->bytes + offset, inserted, insertedLength);
+	source->length = source->length + insertedLength - removedLength;
+
+	// The smallest region with a value that is still balanced after the edit
+	// (but the root).
+	Region * replacement = NULL;
+	size_t replacementLength = 0;
+	while (region != NULL && region->parent != NULL) {
+		replacementLength = region->length + insertedLength - removedLength;
+		Region * regions = region->value == NULL ? NULL : _scanRegions(source->bytes + regionStart, replacementLength);
+		if (regions != NULL && regions->count == 1 && regions->children[0]->length == replacementLength) {
+			replacement = regions->children[0];
+			regions->count = 0;
+			_releaseRegion(regions);
+			break;
+		}
+		_releaseRegion(regions);
+		regionStart -= region->offset;
+		region = region->parent;
+	}
+	if (replacement == NULL) {
+		return _reparseEntireSource(document);
+	}
+	Value * value = NULL;
+	const SyntacticAnalysisStatus status = parseValue(source->bytes + regionStart, replacementLength, &value);
+	if (status != ACCEPT) {
+		_releaseRegion(replacement);
+		document->stale = true;
+		return status;
+	}
+	if (!_pairRegions(replacement, value)) {
+		releaseValue(value);
+		_releaseRegion(replacement);
+		return _reparseEntireSource(document);
+	}
+	addToStatistic("incremental.reparsed-bytes", replacementLength);
+
+	// Splices the new region, and copies the path from it up to the root.
+	Region * parent = region->parent;
+	replacement->offset = region->offset;
+	replacement->parent = parent;
+	replacement->index = region->index;
+	replacement->slot = region->slot;
+	parent->children[region->index] = replacement;
+	_shiftFollowingSiblings(replacement, insertedLength, removedLength);
+	Value * child = value;
+	for (Region * current = replacement; current->parent != NULL; current = current->parent) {
+		Region * ancestor = current->parent;
+		ancestor->value = _replaceSlot(ancestor->value, current->slot, child);
+		ancestor->length = ancestor->length + insertedLength - removedLength;
+		_shiftFollowingSiblings(ancestor, insertedLength, removedLength);
+		child = ancestor->value;
+	}
+	// Releasing the old root releases the old path (its siblings are shared).
+	document->previousValue = region->value;
+	++document->previousValue->references;
+	releaseValue(document->root);
+	document->root = child;
+	_releaseRegion(region);
+	_recordPath(document, replacement);
+	return ACCEPT;
+}
+
+IncrementalChange lastIncrementalChange(const IncrementalDocument * document) {
+	const IncrementalChange change = {
+		.isIncremental = document->isIncremental,
+		.path = document->path,
+		.depth = document->depth,
+		.value = document->changedValue,
+		.previousValue = document->previousValue
+	};
+	return change;
+}
+
+const Buffer * incrementalDocumentSource(const IncrementalDocument * document) {
+	return document->source;
+}
+
+Value * incrementalDocumentRoot(const IncrementalDocument * document) {
+	return document->root;
+}
+
+Program * createIncrementalProgram(const IncrementalDocument * document, CompilerState * compilerState) {
+	const Value * root = document->root;
+	if (root == NULL || document->stale) {
+		return NULL;
+	}
+	if (root->type != OBJECT_VALUE || root->object == NULL) {
+		logError(_logger, "The root of the page must be an \"html\" element.");
+		return NULL;
+	}
+	++root->object->references;
+	return PageSemanticAction(compilerState, root->object);
+}
+
+void destroyIncrementalDocument(IncrementalDocument * document) {
+	if (document == NULL) {
+		return;
+	}
+	if (document->root != NULL) {
+		releaseValue(document->root);
+	}
+	if (document->previousValue != NULL) {
+		releaseValue(document->previousValue);
+	}
+	_releaseRegion(document->rootRegion);
+	destroyBuffer(document->source);
+	free(document->path);
+	free(document);
+}
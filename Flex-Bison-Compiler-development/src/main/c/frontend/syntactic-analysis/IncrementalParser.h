@@ -0,0 +1,100 @@
+#ifndef INCREMENTAL_PARSER_HEADER
+#define INCREMENTAL_PARSER_HEADER
+
+#include "../../shared/Buffer.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Statistics.h"
+#include "../../shared/Type.h"
+#include "AbstractSyntaxTree.h"
+#include "BisonActions.h"
+#include "SyntacticAnalyzer.h"
+#include <ctype.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeIncrementalParserModule();
+
+/** Shutdown module's internal state. */
+void shutdownIncrementalParserModule();
+
+/**
+ * A source kept in memory together with its tree, that can be edited without
+ * parsing it again from scratch (e.g., by an editor, or a watch session).
+ *
+ * Every balanced "{...}" or "[...]" region of the source is indexed with the
+ * composite value parsed from it. After an edit, only the smallest region
+ * that encloses it is re-lexed and reparsed (if the edit unbalanced it, its
+ * parent is tried, and so on). The new subtree is spliced into the tree by
+ * copying the path from it up to the root: every other subtree is reused as
+ * is (values are hash-consed, so sharing them is free).
+ *
+ * The regions of a style, a loop, a conditional or an expression are not
+ * reparsed alone (their values are not composite, or are templates), so an
+ * edit inside them reparses the smallest region that encloses them instead.
+ * If the tree cannot be indexed (i.e., its composite values do not match the
+ * regions of the source, as when declarations were substituted), every edit
+ * reparses the entire source.
+ */
+typedef struct IncrementalDocument IncrementalDocument;
+
+/**
+ * What changed in the tree after the last edit. If the edit was incremental,
+ * the path holds the index of each region among its siblings, from the root
+ * down to the replaced one, the value is the new subtree, and the previous
+ * value is the one it replaced (e.g., to find its output in the output map of
+ * the generator, see "regenerateOutputSpan"). Otherwise (if the edit was
+ * rejected, or the entire source was parsed again), the entire tree must be
+ * considered new.
+ */
+typedef struct {
+	boolean isIncremental;
+	const unsigned int * path;
+	unsigned int depth;
+	Value * value;
+	const Value * previousValue;
+} IncrementalChange;
+
+/**
+ * Creates a document and parses its initial source (that is copied).
+ */
+IncrementalDocument * createIncrementalDocument(const char * source, const size_t length);
+
+/**
+ * Replaces "removedLength" bytes at "offset" with the inserted ones, and
+ * reparses what is needed. If the new source is rejected, the last valid
+ * tree is kept, and the next edit reparses the entire source.
+ */
+SyntacticAnalysisStatus editIncrementalDocument(IncrementalDocument * document, const size_t offset, const size_t removedLength, const char * inserted, const size_t insertedLength);
+
+/**
+ * Describes the last edit (valid until the next one).
+ */
+IncrementalChange lastIncrementalChange(const IncrementalDocument * document);
+
+/**
+ * The current source of the document.
+ */
+const Buffer * incrementalDocumentSource(const IncrementalDocument * document);
+
+/**
+ * The root value of the last valid tree of the document, or NULL if its
+ * source was never accepted. The tree is owned by the document.
+ */
+Value * incrementalDocumentRoot(const IncrementalDocument * document);
+
+/**
+ * Lowers the tree of the document to a page, as if its source was parsed as
+ * a program (see "PageSemanticAction"). Returns NULL if its last edit was
+ * rejected, or if it's not a page. The program takes its own reference to
+ * the tree, so it must be released with "releaseProgram".
+ */
+Program * createIncrementalProgram(const IncrementalDocument * document, CompilerState * compilerState);
+
+/**
+ * Releases the document and its tree.
+ */
+void destroyIncrementalDocument(IncrementalDocument * document);
+
+#endif
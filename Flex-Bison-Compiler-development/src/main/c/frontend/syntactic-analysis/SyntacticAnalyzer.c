@@ -1,13 +1,104 @@
 #include "SyntacticAnalyzer.h"
 #include "../lexical-analysis/LexicalAnalyzerContext.h"
+#include "../lexical-analysis/StructuralLexer.h"
+#include "DescentParser.h"
 
 /* MODULE INTERNAL STATE */
 
-static CompilerState * _currentCompilerState = NULL;
+/**
+ * A top-level element of the body, parsed on its own: the range of its
+ * tokens, and its value (once it's parsed).
+ */
+typedef struct {
+	size_t first;
+	size_t end;
+	Value * value;
+} SpeculativeChild;
+
+/**
+ * Some consecutive children, parsed by the same worker, and the table of the
+ * canonical nodes their values are built with.
+ */
+typedef struct {
+	SpeculativeChild * children;
+	size_t count;
+	HashConsingTable * table;
+	boolean succeed;
+} SpeculativeWorker;
+
+/**
+ * A source lexed on a thread of its own, while it's parsed (see "pipeline"
+ * in the configuration), and the ring its tokens are pushed into.
+ */
+typedef struct {
+	const char * source;
+	size_t length;
+	boolean structuralLexer;
+	RingBuffer * tokens;
+} LexerStage;
+
+/**
+ * What the last byte received by a push parse is part of: code, a string
+ * (or an escape sequence in it), or a comment (or maybe its end). A slash in
+ * code may begin a comment.
+ */
+typedef enum {
+	IN_CODE,
+	AFTER_SLASH,
+	IN_STRING,
+	IN_ESCAPE,
+	IN_COMMENT,
+	AFTER_STAR
+} ChunkContext;
+
+/**
+ * The bytes of a push parse that were received but not lexed yet, how many
+ * of them were already scanned, and where the last cut among those is (zero
+ * if none). The parser state is the one of Bison, and the code its last
+ * result (YYPUSH_MORE while it takes more tokens). The line and column are
+ * those where the pending bytes start.
+ */
+struct PushParser {
+	CompilerState * compilerState;
+	yypstate * parserState;
+	int code;
+	Buffer * pending;
+	size_t scanned;
+	size_t cut;
+	ChunkContext context;
+	unsigned int line;
+	unsigned int column;
+};
+
+// The tokens are published in batches, so the parser seldom waits for them.
+#define TOKEN_RING_CAPACITY (16 * 1024)
+#define TOKEN_BATCH_SIZE 256
+
+// The children are parsed speculatively only if each worker gets at least
+// this many tokens.
+#define MINIMUM_WORKER_TOKENS (16 * 1024)
+#define MAXIMUM_WORKERS 64
+
+#define PENDING_BYTES_CAPACITY (64 * 1024)
+
+// How deep the objects that are entries on their own are looked into.
+#define MAXIMUM_ENTRY_DEPTH 8
+
+static __thread CompilerState * _currentCompilerState = NULL;
+
+// The lines of the source (or segment) that the calling thread parses, that
+// are indexed only if a syntax error must be reported (NULL if unknown).
+static __thread LineIndex * _lines = NULL;
 static Logger * _logger = NULL;
+static unsigned int _processors = 1;
+
+// Whether a worker rejected a child (so the others can stop).
+static boolean _isSpeculationRejected = false;
 
 void initializeSyntacticAnalyzerModule() {
 	_logger = createLogger("SyntacticAnalyzer");
+	const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	_processors = processors < 1 ? 1 : processors < MAXIMUM_WORKERS ? processors : MAXIMUM_WORKERS;
 }
 
 void shutdownSyntacticAnalyzerModule() {
@@ -18,7 +109,8 @@ void shutdownSyntacticAnalyzerModule() {
 
 /** IMPORTED FUNCTIONS */
 
-extern LexicalAnalyzerContext * createLexicalAnalyzerContext();
+extern void flexScanBytes(const char * bytes, const unsigned int length, const Token startToken);
+extern void flexReleaseBytes(void);
 
 /**
  * Bison exported functions.
@@ -33,33 +125,448 @@ extern LexicalAnalyzerContext * createLexicalAnalyzerContext();
  */
 extern int yyparse(void);
 
-// Bison error-reporting function.
-void yyerror(const char * string) {
-	LexicalAnalyzerContext * lexicalAnalyzerContext = createLexicalAnalyzerContext();
-	logError(_logger, "Syntax error (on line %d).", lexicalAnalyzerContext->line);
+/* PRIVATE FUNCTIONS */
+
+static void _addChild(SpeculativeChild ** children, size_t * count, size_t * capacity, const size_t first, const size_t end);
+static size_t _closingToken(const size_t open);
+static void _findChildrenOfArray(const size_t open, SpeculativeChild ** children, size_t * count, size_t * capacity);
+static void _findChildrenOfObject(const size_t open, const unsigned int depth, SpeculativeChild ** children, size_t * count, size_t * capacity);
+static boolean _isDeclaredName(const size_t * names, const size_t nameCount, const size_t identifier);
+static void * _lexTokens(void * stage);
+static void * _parseChildren(void * worker);
+static void _parseSpeculatively(void);
+static void _pushTokens(PushParser * pushParser, const char * bytes, const size_t length, const boolean isLast);
+static void _releasePipedToken(PipedToken * pipedToken);
+static void _releaseSymbol(void * value);
+static int _runParser(void);
+static void _scanForCut(PushParser * pushParser);
+static void _stopLexing(RingBuffer * tokens, pthread_t lexer);
+static SyntacticAnalysisStatus _syntacticAnalysisStatus(const int code, CompilerState * compilerState);
+
+/**
+ * Appends a child to parse speculatively, growing the array if needed.
+ */
+static void _addChild(SpeculativeChild ** children, size_t * count, size_t * capacity, const size_t first, const size_t end) {
+	if (*count == *capacity) {
+		*capacity = *capacity == 0 ? 64 : 2 * *capacity;
+		*children = realloc(*children, *capacity * sizeof(SpeculativeChild));
+	}
+	(*children)[(*count)++] = (SpeculativeChild) {
+		.first = first,
+		.end = end,
+		.value = NULL
+	};
 }
 
-/* PUBLIC FUNCTIONS */
+/**
+ * The index of the token that closes the brace, bracket or parenthesis at
+ * "open" (of any kind, a mismatch is rejected by the parser anyway), or the
+ * count of tokens if it's never closed.
+ */
+static size_t _closingToken(const size_t open) {
+	const size_t count = structuralTokenCount();
+	size_t depth = 0;
+	for (size_t k = open; k < count; ++k) {
+		switch (structuralToken(k)) {
+			case OPEN_BRACE:
+			case OPEN_BRACKET:
+			case OPEN_PARENTHESIS:
+				++depth;
+				break;
+			case CLOSE_BRACE:
+			case CLOSE_BRACKET:
+			case CLOSE_PARENTHESIS:
+				if (--depth == 0) {
+					return k;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	return count;
+}
 
-CompilerState * currentCompilerState() {
-	return _currentCompilerState;
+/**
+ * Finds the objects among the elements of a "content" array. The array is
+ * the outermost scope, so only the variables declared by its own elements
+ * are visible to them: an object that uses one of those is left to the
+ * sequential parse.
+ */
+static void _findChildrenOfArray(const size_t open, SpeculativeChild ** children, size_t * count, size_t * capacity) {
+	const size_t close = _closingToken(open);
+	size_t * names = NULL;
+	size_t nameCount = 0;
+	for (size_t first = open + 1, k = open + 1; k <= close && k < structuralTokenCount(); ++k) {
+		const Token token = structuralToken(k);
+		if (token == OPEN_BRACE || token == OPEN_BRACKET || token == OPEN_PARENTHESIS) {
+			k = _closingToken(k);
+		}
+		else if (token == COMMA || k == close) {
+			if (first + 1 < k && structuralToken(first) == VAR && structuralToken(first + 1) == IDENTIFIER) {
+				names = realloc(names, (nameCount + 1) * sizeof(size_t));
+				names[nameCount++] = first + 1;
+			}
+			first = k + 1;
+		}
+	}
+	for (size_t first = open + 1, k = open + 1; k <= close && k < structuralTokenCount(); ++k) {
+		const Token token = structuralToken(k);
+		if (token == OPEN_BRACE || token == OPEN_BRACKET || token == OPEN_PARENTHESIS) {
+			k = _closingToken(k);
+		}
+		else if (token == COMMA || k == close) {
+			boolean isIndependent = first < k && structuralToken(first) == OPEN_BRACE;
+			// An identifier followed by a colon is declared (or a key),
+			// otherwise, it's used.
+			for (size_t j = first; j < k && isIndependent; ++j) {
+				isIndependent = structuralToken(j) != IDENTIFIER
+					|| (j + 1 < k && structuralToken(j + 1) == COLON)
+					|| !_isDeclaredName(names, nameCount, j);
+			}
+			if (isIndependent) {
+				_addChild(children, count, capacity, first, k);
+			}
+			first = k + 1;
+		}
+	}
+	free(names);
 }
 
-SyntacticAnalysisStatus parse(CompilerState * compilerState) {
-	logDebugging(_logger, "Parsing...");
-	_currentCompilerState = compilerState;
-	const int code = yyparse();
-	_currentCompilerState = NULL;
+/**
+ * Finds the children to parse speculatively in an object that is not a value
+ * (i.e., the root, or an entry on its own, like the head and the body of a
+ * page): those of its "content" array, and those of its entries that are
+ * objects on their own. Values are never looked into, since they could be
+ * inside a loop, or in the scope of an array.
+ */
+static void _findChildrenOfObject(const size_t open, const unsigned int depth, SpeculativeChild ** children, size_t * count, size_t * capacity) {
+	const size_t close = _closingToken(open);
+	for (size_t k = open + 1; k < close; ++k) {
+		const Token token = structuralToken(k);
+		if (token == CONTENT && k + 2 < close && structuralToken(k + 1) == COLON && structuralToken(k + 2) == OPEN_BRACKET) {
+			_findChildrenOfArray(k + 2, children, count, capacity);
+			k = _closingToken(k + 2);
+		}
+		else if (token == OPEN_BRACE && depth < MAXIMUM_ENTRY_DEPTH && (structuralToken(k - 1) == COMMA || structuralToken(k - 1) == OPEN_BRACE)) {
+			_findChildrenOfObject(k, depth + 1, children, count, capacity);
+			k = _closingToken(k);
+		}
+		else if (token == OPEN_BRACE || token == OPEN_BRACKET || token == OPEN_PARENTHESIS) {
+			k = _closingToken(k);
+		}
+	}
+}
+
+/**
+ * Whether the identifier at some token has the name of a variable declared
+ * at the top-level of a "content" array (by the identifiers of the names).
+ */
+static boolean _isDeclaredName(const size_t * names, const size_t nameCount, const size_t identifier) {
+	size_t length = 0;
+	const char * lexeme = structuralLexeme(identifier, &length);
+	for (size_t k = 0; k < nameCount; ++k) {
+		size_t nameLength = 0;
+		const char * name = structuralLexeme(names[k], &nameLength);
+		if (nameLength == length && memcmp(name, lexeme, length) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Lexes a source on its own thread (with the structural lexer, if enabled
+ * and possible, or with Flex), pushing every token into the ring, up to the
+ * end of the source (or until the parser cancels the ring).
+ */
+static void * _lexTokens(void * stage) {
+	LexerStage * lexerStage = stage;
+	const boolean isStructural = lexerStage->source != NULL
+		&& lexerStage->structuralLexer
+		&& structuralScanBytes(lexerStage->source, lexerStage->length, 0);
+	if (lexerStage->source != NULL && !isStructural) {
+		flexScanBytes(lexerStage->source, lexerStage->length, 0);
+	}
+	PipedToken pipedToken;
+	do {
+		pipedToken.token = nextToken(&pipedToken.value);
+		pipedToken.offset = currentTokenOffset();
+		if (!pushToRingBuffer(lexerStage->tokens, &pipedToken)) {
+			_releasePipedToken(&pipedToken);
+			break;
+		}
+	} while (pipedToken.token != 0);
+	closeRingBuffer(lexerStage->tokens);
+	if (isStructural) {
+		structuralReleaseBytes();
+	}
+	else if (lexerStage->source != NULL) {
+		flexReleaseBytes();
+	}
+	return NULL;
+}
+
+/**
+ * Parses the children of a worker, in order, each one as a single value,
+ * with a state (and a table of canonical nodes) of its own. Errors are not
+ * logged, since the sequential parse reports them again. Stops as soon as
+ * any worker rejects a child.
+ */
+static void * _parseChildren(void * worker) {
+	SpeculativeWorker * speculativeWorker = worker;
+	useHashConsingTable(speculativeWorker->table);
+	muteLogging(true);
+	speculativeWorker->succeed = true;
+	for (size_t k = 0; k < speculativeWorker->count && speculativeWorker->succeed; ++k) {
+		SpeculativeChild * child = &speculativeWorker->children[k];
+		CompilerState compilerState = {
+			.abstractSyntaxtTree = NULL,
+			.succeed = false,
+			.symbolTable = createSymbolTable(_releaseSymbol),
+			.loopDepth = 0
+		};
+		_currentCompilerState = &compilerState;
+		structuralScanRange(child->first, child->end, START_VALUE);
+		const int code = __atomic_load_n(&_isSpeculationRejected, __ATOMIC_RELAXED) ? 1 : _runParser();
+		structuralReleaseBytes();
+		destroySymbolTable(compilerState.symbolTable);
+		_currentCompilerState = NULL;
+		speculativeWorker->succeed = code == 0 && compilerState.succeed;
+		child->value = speculativeWorker->succeed ? compilerState.abstractSyntaxtTree : NULL;
+	}
+	if (!speculativeWorker->succeed) {
+		__atomic_store_n(&_isSpeculationRejected, true, __ATOMIC_RELAXED);
+	}
+	muteLogging(false);
+	useHashConsingTable(NULL);
+	return NULL;
+}
+
+/**
+ * Finds the top-level elements of the body (by matching brackets over the
+ * tokens), splits them in consecutive groups of about the same length (one
+ * per processor), and parses each group on its own thread. If every one is
+ * accepted, their values are adopted by the shared table (in order), and
+ * spliced in place of their tokens, so the parse of the source takes them as
+ * they are. Otherwise, they are dropped, and the source is parsed entirely.
+ */
+static void _parseSpeculatively(void) {
+	SpeculativeChild * children = NULL;
+	size_t count = 0;
+	size_t capacity = 0;
+	if (0 < structuralTokenCount() && structuralToken(0) == OPEN_BRACE) {
+		_findChildrenOfObject(0, 0, &children, &count, &capacity);
+	}
+	size_t tokens = 0;
+	for (size_t k = 0; k < count; ++k) {
+		tokens += children[k].end - children[k].first;
+	}
+	size_t workerCount = tokens / MINIMUM_WORKER_TOKENS < _processors ? tokens / MINIMUM_WORKER_TOKENS : _processors;
+	workerCount = count < workerCount ? count : workerCount;
+	if (workerCount < 2) {
+		free(children);
+		return;
+	}
+	SpeculativeWorker workers[MAXIMUM_WORKERS];
+	pthread_t threads[MAXIMUM_WORKERS];
+	boolean isWorking[MAXIMUM_WORKERS] = { false };
+	__atomic_store_n(&_isSpeculationRejected, false, __ATOMIC_RELAXED);
+	for (size_t w = 0, k = 0, accumulated = 0; w < workerCount; ++w) {
+		workers[w] = (SpeculativeWorker) {
+			.children = &children[k],
+			.count = 0,
+			.table = createHashConsingTable(),
+			.succeed = false
+		};
+		const size_t target = (w + 1) * tokens / workerCount;
+		for (; k < count && (accumulated < target || w + 1 == workerCount); ++k, ++workers[w].count) {
+			accumulated += children[k].end - children[k].first;
+		}
+		isWorking[w] = pthread_create(&threads[w], NULL, _parseChildren, &workers[w]) == 0;
+		if (!isWorking[w]) {
+			// This thread reads the entire source, so it can't be a worker.
+			__atomic_store_n(&_isSpeculationRejected, true, __ATOMIC_RELAXED);
+		}
+	}
+	for (size_t w = 0; w < workerCount; ++w) {
+		if (isWorking[w]) {
+			pthread_join(threads[w], NULL);
+		}
+	}
+	const boolean succeed = !__atomic_load_n(&_isSpeculationRejected, __ATOMIC_RELAXED);
+	for (size_t w = 0; w < workerCount; ++w) {
+		for (size_t k = 0; k < workers[w].count; ++k) {
+			SpeculativeChild * child = &workers[w].children[k];
+			if (succeed) {
+				structuralSpliceValue(child->first, child->end, adoptValue(workers[w].table, child->value));
+			}
+			else if (child->value != NULL) {
+				useHashConsingTable(workers[w].table);
+				releaseValue(child->value);
+				useHashConsingTable(NULL);
+			}
+		}
+		destroyHashConsingTable(workers[w].table);
+	}
+	if (succeed) {
+		addToStatistic("parser.speculative-children", count);
+	}
+	else {
+		logDebugging(_logger, "A child of the body was rejected, so the source is parsed sequentially.");
+		addToStatistic("parser.speculative-fallbacks", 1);
+	}
+	free(children);
+}
+
+/**
+ * Lexes a segment of a push parse (one that ends where no token continues),
+ * like "parse" lexes an entire source, and pushes its tokens to the parser
+ * until the parse ends (and the end of the source, if it's the last one).
+ * The offsets of the tokens are those in the segment, so the line and column
+ * of a syntax error are counted from where it starts.
+ */
+static void _pushTokens(PushParser * pushParser, const char * bytes, const size_t length, const boolean isLast) {
+	const boolean isStructural = pushParser->compilerState->configuration.structuralLexer
+		&& structuralScanBytes(bytes, length, 0);
+	if (!isStructural) {
+		flexScanBytes(bytes, length, 0);
+	}
+	_lines = createLineIndex(bytes, length, pushParser->line, pushParser->column);
+	union SemanticValue value;
+	while (pushParser->code == YYPUSH_MORE) {
+		const int token = nextToken(&value);
+		if (token == 0 && !isLast) {
+			break;
+		}
+		pushParser->code = yypush_parse(pushParser->parserState, token, &value);
+	}
+	destroyLineIndex(_lines);
+	_lines = NULL;
+	if (isStructural) {
+		structuralReleaseBytes();
+	}
+	else {
+		flexReleaseBytes();
+	}
+	const size_t newlines = countNewlines(bytes, length);
+	if (newlines == 0) {
+		pushParser->column += length;
+	}
+	else {
+		size_t lineStart = length;
+		while (bytes[lineStart - 1] != '\n') {
+			--lineStart;
+		}
+		pushParser->line += newlines;
+		pushParser->column = 1 + (length - lineStart);
+	}
+}
+
+/**
+ * Releases the semantic value of a token that the parser never took.
+ */
+static void _releasePipedToken(PipedToken * pipedToken) {
+	if (pipedToken->token == STRING || pipedToken->token == IDENTIFIER) {
+		free(pipedToken->value.string);
+	}
+}
+
+/**
+ * Releases the value bound to a variable, once it goes out of scope.
+ */
+static void _releaseSymbol(void * value) {
+	releaseValue(value);
+}
+
+/**
+ * Runs the parser the compiler was built with, over the current source: the
+ * one of Bison, or the hand-written one (see "DescentParser").
+ */
+static int _runParser(void) {
+#ifdef DESCENT_PARSER
+	return descentParse();
+#else
+	return yyparse();
+#endif
+}
+
+/**
+ * Scans the bytes of a push parse received since the last scan (following
+ * strings and comments) for the last cut, right after a byte that ends any
+ * token: a whitespace, a brace, a bracket, a colon or a comma, in code.
+ */
+static void _scanForCut(PushParser * pushParser) {
+	const char * bytes = pushParser->pending->bytes;
+	for (size_t k = pushParser->scanned; k < pushParser->pending->length; ++k) {
+		switch (pushParser->context) {
+			case AFTER_SLASH:
+				if (bytes[k] == '*') {
+					pushParser->context = IN_COMMENT;
+					break;
+				}
+				// Otherwise, the slash was a division, and this byte is code.
+				pushParser->context = IN_CODE;
+				/* fall through */
+			case IN_CODE:
+				switch (bytes[k]) {
+					case '"':
+						pushParser->context = IN_STRING;
+						break;
+					case '/':
+						pushParser->context = AFTER_SLASH;
+						break;
+					case ' ': case '\t': case '\n': case '\v': case '\f': case '\r':
+					case '{': case '}': case '[': case ']': case ':': case ',':
+						pushParser->cut = k + 1;
+						break;
+					default:
+						break;
+				}
+				break;
+			case IN_STRING:
+				pushParser->context = bytes[k] == '\\' ? IN_ESCAPE : bytes[k] == '"' ? IN_CODE : IN_STRING;
+				break;
+			case IN_ESCAPE:
+				pushParser->context = IN_STRING;
+				break;
+			case IN_COMMENT:
+			case AFTER_STAR:
+				pushParser->context = bytes[k] == '*' ? AFTER_STAR
+					: pushParser->context == AFTER_STAR && bytes[k] == '/' ? IN_CODE : IN_COMMENT;
+				break;
+		}
+	}
+	pushParser->scanned = pushParser->pending->length;
+}
+
+/**
+ * Stops the lexer of a parse that ended (maybe before the end of the
+ * source), and releases the tokens that the parser never took.
+ */
+static void _stopLexing(RingBuffer * tokens, pthread_t lexer) {
+	receiveTokens(NULL);
+	cancelRingBuffer(tokens);
+	pthread_join(lexer, NULL);
+	PipedToken pipedToken;
+	while (popFromRingBuffer(tokens, &pipedToken)) {
+		_releasePipedToken(&pipedToken);
+	}
+	destroyRingBuffer(tokens);
+}
+
+/**
+ * The status of a parse, by the result of Bison.
+ */
+static SyntacticAnalysisStatus _syntacticAnalysisStatus(const int code, CompilerState * compilerState) {
 	SyntacticAnalysisStatus syntacticAnalysisStatus;
-	logDebugging(_logger, "Parsing is done.");
 	switch (code) {
 		case 0:
 			if (compilerState->succeed == true) {
 				return ACCEPT;
 			}
-			else {
-				syntacticAnalysisStatus = REJECT;
-			}
+			syntacticAnalysisStatus = REJECT;
+			break;
 		case 1:
 			syntacticAnalysisStatus = REJECT;
 			break;
@@ -74,3 +581,168 @@ SyntacticAnalysisStatus parse(CompilerState * compilerState) {
 	compilerState->succeed = false;
 	return syntacticAnalysisStatus;
 }
+
+// Bison error-reporting function.
+void yyerror(const char * string) {
+	// The message of Bison is replaced by the location of the error.
+	(void) string;
+	if (_lines == NULL) {
+		logError(_logger, "Syntax error.");
+		return;
+	}
+	unsigned int line = 0;
+	unsigned int column = 0;
+	locateOffset(_lines, currentTokenOffset(), &line, &column);
+	logError(_logger, "Syntax error (on line %u, column %u).", line, column);
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompilerState * currentCompilerState() {
+	return _currentCompilerState;
+}
+
+SyntacticAnalysisStatus parse(CompilerState * compilerState) {
+	logDebugging(_logger, "Parsing...");
+	_currentCompilerState = compilerState;
+	compilerState->symbolTable = createSymbolTable(_releaseSymbol);
+	compilerState->loopDepth = 0;
+	compilerState->arrayDepth = 0;
+	LexerStage lexerStage = {
+		.source = compilerState->source,
+		.length = compilerState->sourceLength,
+		.structuralLexer = compilerState->configuration.structuralLexer,
+		.tokens = NULL
+	};
+	pthread_t lexer;
+	boolean isPipelined = false;
+	if (compilerState->configuration.pipeline) {
+		lexerStage.tokens = createRingBuffer(sizeof(PipedToken), TOKEN_RING_CAPACITY, TOKEN_BATCH_SIZE);
+		isPipelined = pthread_create(&lexer, NULL, _lexTokens, &lexerStage) == 0;
+		if (isPipelined) {
+			receiveTokens(lexerStage.tokens);
+		}
+		else {
+			destroyRingBuffer(lexerStage.tokens);
+		}
+	}
+	const boolean isStructural = !isPipelined
+		&& compilerState->source != NULL
+		&& compilerState->configuration.structuralLexer
+		&& structuralScanBytes(compilerState->source, compilerState->sourceLength, 0);
+	if (!isPipelined && compilerState->source != NULL && !isStructural) {
+		flexScanBytes(compilerState->source, compilerState->sourceLength, 0);
+	}
+	if (isStructural && compilerState->configuration.parallelParser) {
+		_parseSpeculatively();
+	}
+	_lines = compilerState->source == NULL ? NULL : createLineIndex(compilerState->source, compilerState->sourceLength, 1, 1);
+	const int code = _runParser();
+	destroyLineIndex(_lines);
+	_lines = NULL;
+	if (isPipelined) {
+		_stopLexing(lexerStage.tokens, lexer);
+	}
+	else if (isStructural) {
+		structuralReleaseBytes();
+	}
+	else if (compilerState->source != NULL) {
+		flexReleaseBytes();
+	}
+	destroySymbolTable(compilerState->symbolTable);
+	compilerState->symbolTable = NULL;
+	_currentCompilerState = NULL;
+	logDebugging(_logger, "Parsing is done.");
+	return _syntacticAnalysisStatus(code, compilerState);
+}
+
+SyntacticAnalysisStatus parseValue(const char * source, const size_t length, Value ** value) {
+	logDebugging(_logger, "Parsing a value of %zu bytes...", length);
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.succeed = false,
+		.source = source,
+		.sourceLength = length,
+		.output = NULL,
+		.symbolTable = createSymbolTable(_releaseSymbol),
+		.loopDepth = 0,
+		.arrayDepth = 0,
+		.elements = NULL,
+		.includedPartials = 0,
+		.value = 0
+	};
+	_currentCompilerState = &compilerState;
+	flexScanBytes(source, length, START_VALUE);
+	_lines = createLineIndex(source, length, 1, 1);
+	const int code = _runParser();
+	destroyLineIndex(_lines);
+	_lines = NULL;
+	flexReleaseBytes();
+	destroySymbolTable(compilerState.symbolTable);
+	_currentCompilerState = NULL;
+	*value = NULL;
+	if (code == 0 && compilerState.succeed) {
+		*value = compilerState.abstractSyntaxtTree;
+		return ACCEPT;
+	}
+	return code == 2 ? OUT_OF_MEMORY : REJECT;
+}
+
+PushParser * createPushParser(CompilerState * compilerState) {
+	logDebugging(_logger, "Parsing chunk by chunk...");
+	compilerState->symbolTable = createSymbolTable(_releaseSymbol);
+	compilerState->loopDepth = 0;
+	compilerState->arrayDepth = 0;
+	PushParser * pushParser = malloc(sizeof(PushParser));
+	*pushParser = (PushParser) {
+		.compilerState = compilerState,
+		.parserState = yypstate_new(),
+		.code = YYPUSH_MORE,
+		.pending = createBuffer(PENDING_BYTES_CAPACITY),
+		.scanned = 0,
+		.cut = 0,
+		.context = IN_CODE,
+		.line = 1,
+		.column = 1
+	};
+	if (pushParser->parserState == NULL) {
+		pushParser->code = 2;
+	}
+	return pushParser;
+}
+
+boolean pushToParser(PushParser * pushParser, const char * bytes, const size_t length) {
+	if (pushParser->code != YYPUSH_MORE) {
+		return false;
+	}
+	Buffer * pending = pushParser->pending;
+	appendToBuffer(pending, bytes, length);
+	_scanForCut(pushParser);
+	if (0 < pushParser->cut) {
+		_currentCompilerState = pushParser->compilerState;
+		_pushTokens(pushParser, pending->bytes, pushParser->cut, false);
+		_currentCompilerState = NULL;
+		pending->length -= pushParser->cut;
+		memmove(pending->bytes, pending->bytes + pushParser->cut, pending->length);
+		pushParser->scanned = pending->length;
+		pushParser->cut = 0;
+	}
+	return pushParser->code == YYPUSH_MORE;
+}
+
+SyntacticAnalysisStatus closePushParser(PushParser * pushParser) {
+	CompilerState * compilerState = pushParser->compilerState;
+	_currentCompilerState = compilerState;
+	if (pushParser->code == YYPUSH_MORE) {
+		_pushTokens(pushParser, pushParser->pending->bytes, pushParser->pending->length, true);
+	}
+	const int code = pushParser->code;
+	yypstate_delete(pushParser->parserState);
+	destroyBuffer(pushParser->pending);
+	free(pushParser);
+	destroySymbolTable(compilerState->symbolTable);
+	compilerState->symbolTable = NULL;
+	_currentCompilerState = NULL;
+	logDebugging(_logger, "Parsing is done.");
+	return _syntacticAnalysisStatus(code, compilerState);
+}
@@ -2,7 +2,16 @@
 #define SYNTACTIC_ANALYZER_HEADER
 
 #include "../../shared/CompilerState.h"
+#include "../../shared/LineIndex.h"
 #include "../../shared/Logger.h"
+#include "../../shared/Statistics.h"
+#include "AbstractSyntaxTree.h"
+#include "HashConsing.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 /** Bison imported functions. */
 
@@ -25,13 +34,54 @@ typedef enum {
 /**
  * Retrieves the current compiler state. The state must be accessed during the
  * parsing phase (i.e., during a call to the "parse" function). Outside of the
- * parse, the state is set to NULL.
+ * parse, the state is set to NULL. Each thread that parses has its own.
  */
 CompilerState * currentCompilerState();
 
 /**
- * Executes the parsing phase of the compiler.
+ * Executes the parsing phase of the compiler. With the parallel parser, the
+ * children of the body are parsed first, at the same time; with the
+ * pipeline, the source is lexed on a thread of its own while it's parsed
+ * (see "CompilerConfiguration").
  */
 SyntacticAnalysisStatus parse(CompilerState * compilerState);
 
+/**
+ * Parses a source that holds a single value (e.g., an object or an array cut
+ * from a bigger source), instead of an entire program. On success, the value
+ * is returned through the last argument.
+ */
+SyntacticAnalysisStatus parseValue(const char * source, const size_t length, Value ** value);
+
+/**
+ * A parse of a source that arrives in chunks of any size (e.g., from a pipe
+ * or a socket), fed as they come, instead of read entirely up-front. Each
+ * chunk is lexed up to the last point where a token can't continue (a
+ * whitespace, a brace, a bracket, a colon or a comma, outside of a string or
+ * comment), and its tokens are pushed to the parser right away, so the
+ * grammar actions run while the rest of the source is still on its way (see
+ * "elements" in the compiler state). The remainder is kept for the next one.
+ * Only one source can be lexed at a time, so a push parse must not overlap
+ * another parse, and its chunks must be pushed from the same thread.
+ */
+typedef struct PushParser PushParser;
+
+/**
+ * Begins the push parse of a program into a compiler state (like "parse",
+ * but without a source).
+ */
+PushParser * createPushParser(CompilerState * compilerState);
+
+/**
+ * Feeds the next chunk of the source. Returns false once the parse ended
+ * (i.e., the source was rejected), so the rest can be dropped.
+ */
+boolean pushToParser(PushParser * pushParser, const char * bytes, const size_t length);
+
+/**
+ * Feeds the end of the source, and destroys the push parser. Returns the
+ * same status that "parse" would for the entire source.
+ */
+SyntacticAnalysisStatus closePushParser(PushParser * pushParser);
+
 #endif
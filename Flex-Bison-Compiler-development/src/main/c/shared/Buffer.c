@@ -0,0 +1,76 @@
+#include "Buffer.h"
+
+/* PUBLIC FUNCTIONS */
+
+Buffer * createBuffer(const size_t capacity) {
+	Buffer * buffer = calloc(1, sizeof(Buffer));
+	buffer->capacity = capacity < 16 ? 16 : capacity;
+	buffer->bytes = calloc(buffer->capacity, sizeof(char));
+	buffer->length = 0;
+	return buffer;
+}
+
+void destroyBuffer(Buffer * buffer) {
+	if (buffer != NULL) {
+		if (buffer->bytes != NULL) {
+			free(buffer->bytes);
+		}
+		free(buffer);
+	}
+}
+
+void appendToBuffer(Buffer * buffer, const char * bytes, const size_t length) {
+	reserveBuffer(buffer, length);
+	memcpy(buffer->bytes + buffer->length, bytes, length);
+	buffer->length += length;
+}
+
+void appendFormattedToBuffer(Buffer * buffer, const char * const format, va_list arguments) {
+	va_list copy;
+	va_copy(copy, arguments);
+	const size_t available = buffer->capacity - buffer->length;
+	const int length = vsnprintf(buffer->bytes + buffer->length, available, format, copy);
+	va_end(copy);
+	if (length < 0) {
+		return;
+	}
+	if (available <= (size_t) length) {
+		// The null-terminator must fit too, although it's not accounted.
+		reserveBuffer(buffer, 1 + length);
+		vsnprintf(buffer->bytes + buffer->length, 1 + length, format, arguments);
+	}
+	buffer->length += length;
+}
+
+size_t appendStreamToBuffer(Buffer * buffer, FILE * stream) {
+	const size_t initialLength = buffer->length;
+	size_t read = 0;
+	do {
+		reserveBuffer(buffer, 64 * 1024);
+		read = fread(buffer->bytes + buffer->length, sizeof(char), buffer->capacity - buffer->length, stream);
+		buffer->length += read;
+	} while (0 < read);
+	return buffer->length - initialLength;
+}
+
+void appendRangeToBuffer(Buffer * buffer, const size_t offset, const size_t length) {
+	reserveBuffer(buffer, length);
+	memcpy(buffer->bytes + buffer->length, buffer->bytes + offset, length);
+	buffer->length += length;
+}
+
+void clearBuffer(Buffer * buffer) {
+	buffer->length = 0;
+}
+
+void reserveBuffer(Buffer * buffer, const size_t extraLength) {
+	const size_t requiredCapacity = buffer->length + extraLength;
+	if (buffer->capacity < requiredCapacity) {
+		size_t capacity = 2 * buffer->capacity;
+		while (capacity < requiredCapacity) {
+			capacity *= 2;
+		}
+		buffer->bytes = realloc(buffer->bytes, capacity);
+		buffer->capacity = capacity;
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef BUFFER_HEADER
+#define BUFFER_HEADER
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A growable array of bytes, allocated in heap-memory. The content is not
+ * null-terminated, so always use the length to read it.
+ */
+typedef struct {
+	char * bytes;
+	size_t length;
+	size_t capacity;
+} Buffer;
+
+/**
+ * Creates a new empty buffer with (at least) the specified initial capacity.
+ */
+Buffer * createBuffer(const size_t capacity);
+
+/**
+ * Destroy a buffer and its resources.
+ */
+void destroyBuffer(Buffer * buffer);
+
+/**
+ * Appends a sequence of bytes at the end of the buffer.
+ */
+void appendToBuffer(Buffer * buffer, const char * bytes, const size_t length);
+
+/**
+ * Appends a formatted string (without the null-terminator) at the end of the
+ * buffer.
+ *
+ * @see https://cplusplus.com/reference/cstdio/vsnprintf/
+ */
+void appendFormattedToBuffer(Buffer * buffer, const char * const format, va_list arguments);
+
+/**
+ * Appends the entire content of a stream (until EOF) at the end of the
+ * buffer. Returns the number of bytes read.
+ */
+size_t appendStreamToBuffer(Buffer * buffer, FILE * stream);
+
+/**
+ * Appends a copy of a range of the buffer at its own end. This is safe even
+ * if the buffer must be reallocated.
+ */
+void appendRangeToBuffer(Buffer * buffer, const size_t offset, const size_t length);
+
+/**
+ * Drops the content of the buffer, but keeps its capacity.
+ */
+void clearBuffer(Buffer * buffer);
+
+/**
+ * Ensures that the buffer can hold, at least, the specified amount of extra
+ * bytes without being reallocated.
+ */
+void reserveBuffer(Buffer * buffer, const size_t extraLength);
+
+#endif
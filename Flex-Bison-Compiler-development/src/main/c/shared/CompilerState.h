@@ -1,7 +1,11 @@
 #ifndef COMPILER_STATE_HEADER
 #define COMPILER_STATE_HEADER
 
+#include "Buffer.h"
+#include "RingBuffer.h"
+#include "SymbolTable.h"
 #include "Type.h"
+#include <stddef.h>
 
 /**
  * The general status of a compilation.
@@ -11,6 +15,62 @@ typedef enum {
 	FAILED = 1
 } CompilationStatus;
 
+/**
+ * The configuration of a compilation, taken from the command-line arguments.
+ */
+typedef struct {
+	// The directory of the persistent caches, or NULL if caching is disabled.
+	const char * cacheDirectory;
+
+	// The maximum size, in bytes, of the result cache (LRU-evicted).
+	size_t maximumCacheSize;
+
+	// Whether results are shared with concurrent compilers through memory.
+	boolean useSharedCache;
+
+	// The directory of the sources to watch, or NULL to compile the standard
+	// input once.
+	const char * watchDirectory;
+
+	// The directory of the outputs of a watch or a site build (by default,
+	// the directory of the sources).
+	const char * outputDirectory;
+
+	// The directory of the pages of a site to build, or NULL.
+	const char * siteDirectory;
+
+	// The directory where the included partials are looked up (by default,
+	// the one of the sources).
+	const char * partialDirectory;
+
+	// How many pages of a site are built at the same time.
+	unsigned int jobs;
+
+	// Whether styles are written inline on each element, instead of as shared
+	// classes declared in the head.
+	boolean inlineStyles;
+
+	// Whether in-memory sources are lexed from a structural index built with
+	// SIMD, instead of with Flex (that is still used if they can't be).
+	boolean structuralLexer;
+
+	// Whether the children of the body are parsed at the same time, on their
+	// own (with the structural lexer), before the rest of the source.
+	boolean parallelParser;
+
+	// Whether the source is lexed, parsed and generated at the same time, each
+	// phase on its own thread (instead of with the parallel parser).
+	boolean pipeline;
+
+	// Whether the standard input is parsed while it's read, chunk by chunk
+	// (so it's never looked up in the caches, since it's not known up-front).
+	boolean stream;
+	// Whether the source is only validated: every check of the frontend runs,
+	// but nothing that only the backend needs is built, and nothing is
+	// generated.
+	boolean check;
+} CompilerConfiguration;
+
 /**
  * The global state of the compiler. Should transport every data structure
  * needed across the different phases of a compilation.
@@ -22,10 +82,35 @@ typedef struct {
 	// A flag that indicates the current state of the compilation so far.
 	boolean succeed;
 
-	// TODO: Add an stack to handle nested scopes.
-	// TODO: Add a symbol table.
-	// TODO: Add configuration.
-	// TODO: ...
+	// The entire source code, when it was read up-front (otherwise, Flex
+	// reads it from the standard input).
+	const char * source;
+	size_t sourceLength;
+
+	// The generated output.
+	Buffer * output;
+
+	// The configuration of the compilation.
+	CompilerConfiguration configuration;
+
+	// The variables in scope while parsing, and their values (references are
+	// resolved as soon as they are parsed).
+	SymbolTable * symbolTable;
+
+	// How many loops enclose the value being parsed (the variable of the next
+	// one takes this slot).
+	unsigned int loopDepth;
+
+	// How many arrays enclose the value being parsed.
+	unsigned int arrayDepth;
+
+	// Where the elements of the outermost arrays are pushed as soon as they
+	// are parsed, to be generated ahead (NULL if they aren't).
+	RingBuffer * elements;
+
+	// How many partials were spliced into the output (if any, the output
+	// depends on them too, and not only on the source).
+	unsigned int includedPartials;
 
 	// The computed value of the entire program (only for the calculator).
 	int value;
@@ -0,0 +1,336 @@
+#include "DependencyGraph.h"
+
+/* MODULE INTERNAL STATE */
+
+#define GRAPH_HEADER "dependency-graph 1"
+
+typedef struct {
+	char * name;
+	uint64_t hash;
+	unsigned int * dependencies;
+	unsigned int count;
+	unsigned int capacity;
+} Node;
+
+struct DependencyGraph {
+	Node * nodes;
+	unsigned int count;
+	unsigned int capacity;
+};
+
+static Logger * _logger = NULL;
+
+void initializeDependencyGraphModule() {
+	_logger = createLogger("DependencyGraph");
+}
+
+void shutdownDependencyGraphModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _haveSameDependencies(const DependencyGraph * current, const unsigned int node, const DependencyGraph * previous, const unsigned int previousNode);
+static void _release(const DependencyGraph * graph, const unsigned int node, const boolean * marked, unsigned int * pending, unsigned int * ready, unsigned int * readyCount);
+
+/**
+ * Whether a node has the same dependencies (by name) in both graphs.
+ */
+static boolean _haveSameDependencies(const DependencyGraph * current, const unsigned int node, const DependencyGraph * previous, const unsigned int previousNode) {
+	const Node * currentNode = &current->nodes[node];
+	const Node * oldNode = &previous->nodes[previousNode];
+	if (currentNode->count != oldNode->count) {
+		return false;
+	}
+	for (unsigned int k = 0; k < currentNode->count; ++k) {
+		const char * name = current->nodes[currentNode->dependencies[k]].name;
+		boolean found = false;
+		for (unsigned int j = 0; j < oldNode->count && !found; ++j) {
+			found = strcmp(previous->nodes[oldNode->dependencies[j]].name, name) == 0;
+		}
+		if (!found) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Once a node is built, releases every marked node that depends on it, and
+ * queues the ones without pending dependencies.
+ */
+static void _release(const DependencyGraph * graph, const unsigned int node, const boolean * marked, unsigned int * pending, unsigned int * ready, unsigned int * readyCount) {
+	for (unsigned int k = 0; k < graph->count; ++k) {
+		if (!marked[k] || pending[k] == 0) {
+			continue;
+		}
+		const Node * dependent = &graph->nodes[k];
+		for (unsigned int j = 0; j < dependent->count; ++j) {
+			if (dependent->dependencies[j] == node && --pending[k] == 0) {
+				ready[(*readyCount)++] = k;
+			}
+		}
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+DependencyGraph * createDependencyGraph() {
+	return calloc(1, sizeof(DependencyGraph));
+}
+
+void destroyDependencyGraph(DependencyGraph * graph) {
+	if (graph == NULL) {
+		return;
+	}
+	for (unsigned int k = 0; k < graph->count; ++k) {
+		free(graph->nodes[k].name);
+		free(graph->nodes[k].dependencies);
+	}
+	free(graph->nodes);
+	free(graph);
+}
+
+unsigned int addGraphNode(DependencyGraph * graph, const char * name, const uint64_t hash) {
+	if (graph->count == graph->capacity) {
+		graph->capacity = graph->capacity == 0 ? 64 : 2 * graph->capacity;
+		graph->nodes = realloc(graph->nodes, graph->capacity * sizeof(Node));
+	}
+	Node * node = &graph->nodes[graph->count];
+	node->name = strdup(name);
+	node->hash = hash;
+	node->dependencies = NULL;
+	node->count = 0;
+	node->capacity = 0;
+	return graph->count++;
+}
+
+void addGraphDependency(DependencyGraph * graph, const unsigned int node, const unsigned int dependency) {
+	Node * target = &graph->nodes[node];
+	for (unsigned int k = 0; k < target->count; ++k) {
+		if (target->dependencies[k] == dependency) {
+			return;
+		}
+	}
+	if (target->count == target->capacity) {
+		target->capacity = target->capacity == 0 ? 4 : 2 * target->capacity;
+		target->dependencies = realloc(target->dependencies, target->capacity * sizeof(unsigned int));
+	}
+	target->dependencies[target->count++] = dependency;
+}
+
+int findGraphNode(const DependencyGraph * graph, const char * name) {
+	for (unsigned int k = 0; k < graph->count; ++k) {
+		if (strcmp(graph->nodes[k].name, name) == 0) {
+			return k;
+		}
+	}
+	return -1;
+}
+
+unsigned int graphNodeCount(const DependencyGraph * graph) {
+	return graph->count;
+}
+
+const char * graphNodeName(const DependencyGraph * graph, const unsigned int node) {
+	return graph->nodes[node].name;
+}
+
+void setGraphNodeHash(DependencyGraph * graph, const unsigned int node, const uint64_t hash) {
+	graph->nodes[node].hash = hash;
+}
+
+DependencyGraph * loadDependencyGraph(const char * path) {
+	FILE * file = fopen(path, "r");
+	if (file == NULL) {
+		return NULL;
+	}
+	// One line per node ("hash<TAB>name<TAB>dependency-index..."), after a header.
+	DependencyGraph * graph = createDependencyGraph();
+	char * line = NULL;
+	size_t capacity = 0;
+	boolean succeed = getline(&line, &capacity, file) != -1 && strncmp(line, GRAPH_HEADER, strlen(GRAPH_HEADER)) == 0;
+	while (succeed && getline(&line, &capacity, file) != -1) {
+		line[strcspn(line, "\n")] = '\0';
+		char * cursor = NULL;
+		const char * hash = strtok_r(line, "\t", &cursor);
+		const char * name = strtok_r(NULL, "\t", &cursor);
+		if (hash == NULL || name == NULL) {
+			succeed = false;
+			break;
+		}
+		const unsigned int node = addGraphNode(graph, name, strtoull(hash, NULL, 16));
+		const char * dependency;
+		while ((dependency = strtok_r(NULL, "\t", &cursor)) != NULL) {
+			addGraphDependency(graph, node, (unsigned int) strtoul(dependency, NULL, 10));
+		}
+	}
+	free(line);
+	fclose(file);
+	for (unsigned int k = 0; succeed && k < graph->count; ++k) {
+		for (unsigned int j = 0; j < graph->nodes[k].count; ++j) {
+			succeed = succeed && graph->nodes[k].dependencies[j] < graph->count;
+		}
+	}
+	if (!succeed) {
+		logWarning(_logger, "Ignoring a malformed dependency graph: %s", path);
+		destroyDependencyGraph(graph);
+		return NULL;
+	}
+	return graph;
+}
+
+boolean storeDependencyGraph(const DependencyGraph * graph, const char * path) {
+	char temporaryPath[4096];
+	snprintf(temporaryPath, sizeof(temporaryPath), "%s.%ld.tmp", path, (long) getpid());
+	FILE * file = fopen(temporaryPath, "w");
+	if (file == NULL) {
+		logError(_logger, "Cannot write the dependency graph: %s", path);
+		return false;
+	}
+	fprintf(file, "%s\n", GRAPH_HEADER);
+	for (unsigned int k = 0; k < graph->count; ++k) {
+		const Node * node = &graph->nodes[k];
+		fprintf(file, "%016llx\t%s", (unsigned long long) node->hash, node->name);
+		for (unsigned int j = 0; j < node->count; ++j) {
+			fprintf(file, "\t%u", node->dependencies[j]);
+		}
+		fputc('\n', file);
+	}
+	boolean succeed = ferror(file) == 0;
+	succeed = fclose(file) == 0 && succeed;
+	succeed = succeed && rename(temporaryPath, path) == 0;
+	if (!succeed) {
+		logError(_logger, "Cannot write the dependency graph: %s", path);
+		remove(temporaryPath);
+	}
+	return succeed;
+}
+
+unsigned int markAffectedGraphNodes(const DependencyGraph * current, const DependencyGraph * previous, boolean * marked) {
+	for (unsigned int k = 0; k < current->count; ++k) {
+		const Node * node = &current->nodes[k];
+		const int previousNode = previous == NULL ? -1 : findGraphNode(previous, node->name);
+		marked[k] = marked[k]
+			|| previousNode < 0
+			|| node->hash == 0
+			|| previous->nodes[previousNode].hash != node->hash
+			|| !_haveSameDependencies(current, k, previous, previousNode);
+	}
+	// Propagates the marks to the dependents, until nothing changes.
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (unsigned int k = 0; k < current->count; ++k) {
+			const Node * node = &current->nodes[k];
+			for (unsigned int j = 0; j < node->count && !marked[k]; ++j) {
+				if (marked[node->dependencies[j]]) {
+					marked[k] = true;
+					changed = true;
+				}
+			}
+		}
+	}
+	unsigned int count = 0;
+	for (unsigned int k = 0; k < current->count; ++k) {
+		count += marked[k] ? 1 : 0;
+	}
+	return count;
+}
+
+unsigned int buildDependencyGraph(const DependencyGraph * graph, const boolean * marked, const unsigned int jobs, NodeBuilder builder, void * context, boolean * failed) {
+	const unsigned int count = graph->count;
+	unsigned int * pending = calloc(count + 1, sizeof(unsigned int));
+	unsigned int * ready = calloc(count + 1, sizeof(unsigned int));
+	pid_t * workers = calloc(count + 1, sizeof(pid_t));
+	boolean * started = calloc(count + 1, sizeof(boolean));
+	unsigned int readyCount = 0;
+	unsigned int remaining = 0;
+	for (unsigned int k = 0; k < count; ++k) {
+		failed[k] = false;
+		if (!marked[k]) {
+			continue;
+		}
+		++remaining;
+		for (unsigned int j = 0; j < graph->nodes[k].count; ++j) {
+			const unsigned int dependency = graph->nodes[k].dependencies[j];
+			pending[k] += marked[dependency] && dependency != k ? 1 : 0;
+		}
+		if (pending[k] == 0) {
+			ready[readyCount++] = k;
+		}
+	}
+	unsigned int running = 0;
+	unsigned int built = 0;
+	while (0 < remaining) {
+		if (readyCount == 0 && running == 0) {
+			// Only cycles are left: breaks one, at the node with less dependencies.
+			unsigned int candidate = count;
+			for (unsigned int k = 0; k < count; ++k) {
+				if (marked[k] && !started[k] && (candidate == count || pending[k] < pending[candidate])) {
+					candidate = k;
+				}
+			}
+			logDebugging(_logger, "Breaking a dependency cycle at \"%s\".", graph->nodes[candidate].name);
+			pending[candidate] = 0;
+			ready[readyCount++] = candidate;
+		}
+		while (0 < readyCount && (running < jobs || jobs <= 1)) {
+			const unsigned int node = ready[--readyCount];
+			started[node] = true;
+			if (jobs <= 1) {
+				failed[node] = !builder(node, graph->nodes[node].name, context);
+				built += failed[node] ? 0 : 1;
+				--remaining;
+				_release(graph, node, marked, pending, ready, &readyCount);
+				continue;
+			}
+			fflush(stdout);
+			fflush(stderr);
+			const pid_t worker = fork();
+			if (worker == 0) {
+				const boolean succeed = builder(node, graph->nodes[node].name, context);
+				fflush(stdout);
+				fflush(stderr);
+				_exit(succeed ? 0 : 1);
+			}
+			if (worker < 0) {
+				failed[node] = true;
+				--remaining;
+				_release(graph, node, marked, pending, ready, &readyCount);
+				continue;
+			}
+			workers[node] = worker;
+			++running;
+		}
+		if (0 < running) {
+			int status;
+			const pid_t worker = wait(&status);
+			if (worker < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				break;
+			}
+			for (unsigned int k = 0; k < count; ++k) {
+				if (workers[k] == worker) {
+					workers[k] = 0;
+					failed[k] = !(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+					built += failed[k] ? 0 : 1;
+					--running;
+					--remaining;
+					_release(graph, k, marked, pending, ready, &readyCount);
+					break;
+				}
+			}
+		}
+	}
+	addToStatistic("dependency-graph.built-nodes", built);
+	free(started);
+	free(workers);
+	free(ready);
+	free(pending);
+	return built;
+}
@@ -0,0 +1,93 @@
+#ifndef DEPENDENCY_GRAPH_HEADER
+#define DEPENDENCY_GRAPH_HEADER
+
+#include "Logger.h"
+#include "Statistics.h"
+#include "Type.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+void initializeDependencyGraphModule();
+
+/** Shutdown module's internal state. */
+void shutdownDependencyGraphModule();
+
+/**
+ * A graph of named nodes (e.g., the pages of a site), each one with the hash
+ * of its content and the nodes it depends on. It can be persisted, so a new
+ * build can compare it with the graph of the last one, and build only the
+ * nodes that changed (or that depend on a node that changed).
+ */
+typedef struct DependencyGraph DependencyGraph;
+
+/**
+ * Builds a node (by name) and returns true if it was built. The context is
+ * the one given to "buildDependencyGraph".
+ */
+typedef boolean (*NodeBuilder)(const unsigned int node, const char * name, void * context);
+
+DependencyGraph * createDependencyGraph();
+
+void destroyDependencyGraph(DependencyGraph * graph);
+
+/**
+ * Adds a node (the name is copied) and returns its index.
+ */
+unsigned int addGraphNode(DependencyGraph * graph, const char * name, const uint64_t hash);
+
+/**
+ * Records that a node depends on another one (repeated edges are ignored).
+ */
+void addGraphDependency(DependencyGraph * graph, const unsigned int node, const unsigned int dependency);
+
+/**
+ * The index of the node with the name, or -1 if it doesn't exist.
+ */
+int findGraphNode(const DependencyGraph * graph, const char * name);
+
+unsigned int graphNodeCount(const DependencyGraph * graph);
+
+const char * graphNodeName(const DependencyGraph * graph, const unsigned int node);
+
+/**
+ * Changes the hash of a node (e.g., a zero hash forces it to be built the
+ * next time, if it could not be built now).
+ */
+void setGraphNodeHash(DependencyGraph * graph, const unsigned int node, const uint64_t hash);
+
+/**
+ * Loads a graph stored with "storeDependencyGraph", or returns NULL if the
+ * file doesn't exist or it's malformed.
+ */
+DependencyGraph * loadDependencyGraph(const char * path);
+
+/**
+ * Stores the graph in a file (written aside and renamed).
+ */
+boolean storeDependencyGraph(const DependencyGraph * graph, const char * path);
+
+/**
+ * Marks every node of the current graph that changed since the previous one
+ * (that may be NULL): new nodes, nodes with a different hash, and nodes with
+ * different dependencies (by name). Then, marks every node that depends on a
+ * marked one, transitively. Returns how many nodes are marked.
+ */
+unsigned int markAffectedGraphNodes(const DependencyGraph * current, const DependencyGraph * previous, boolean * marked);
+
+/**
+ * Builds the marked nodes, each one after its marked dependencies, running up
+ * to "jobs" builders at the same time (each one in a child process, if more
+ * than one). Nodes in a cycle are built in any order, once the rest of their
+ * dependencies are. The nodes that could not be built are marked as failed.
+ * Returns how many nodes were built.
+ */
+unsigned int buildDependencyGraph(const DependencyGraph * graph, const boolean * marked, const unsigned int jobs, NodeBuilder builder, void * context, boolean * failed);
+
+#endif
@@ -0,0 +1,107 @@
+#include "FilePatcher.h"
+
+/* MODULE INTERNAL STATE */
+
+#define BLOCK_SIZE (256 * 1024)
+
+static Logger * _logger = NULL;
+
+void initializeFilePatcherModule() {
+	_logger = createLogger("FilePatcher");
+}
+
+void shutdownFilePatcherModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _moveRange(const int descriptor, const off_t from, const off_t to, const size_t length);
+static boolean _readFully(const int descriptor, char * bytes, const size_t length, const off_t offset);
+static boolean _writeFully(const int descriptor, const char * bytes, const size_t length, const off_t offset);
+
+/**
+ * Moves a range of the file, block by block, in the direction that never
+ * overwrites bytes that were not moved yet.
+ */
+static boolean _moveRange(const int descriptor, const off_t from, const off_t to, const size_t length) {
+	if (from == to || length == 0) {
+		return true;
+	}
+	char * block = malloc(BLOCK_SIZE);
+	boolean succeed = true;
+	for (size_t moved = 0; moved < length && succeed;) {
+		const size_t size = length - moved < BLOCK_SIZE ? length - moved : BLOCK_SIZE;
+		// Forwards (the tail grows) from the end; backwards from the beginning.
+		const off_t position = to > from ? (off_t) (length - moved - size) : (off_t) moved;
+		succeed = _readFully(descriptor, block, size, from + position)
+			&& _writeFully(descriptor, block, size, to + position);
+		moved += size;
+	}
+	free(block);
+	return succeed;
+}
+
+/**
+ * Reads exactly the specified bytes at the offset.
+ */
+static boolean _readFully(const int descriptor, char * bytes, const size_t length, const off_t offset) {
+	for (size_t read = 0; read < length;) {
+		const ssize_t count = pread(descriptor, bytes + read, length - read, offset + read);
+		if (count <= 0) {
+			return false;
+		}
+		read += count;
+	}
+	return true;
+}
+
+/**
+ * Writes exactly the specified bytes at the offset.
+ */
+static boolean _writeFully(const int descriptor, const char * bytes, const size_t length, const off_t offset) {
+	for (size_t written = 0; written < length;) {
+		const ssize_t count = pwrite(descriptor, bytes + written, length - written, offset + written);
+		if (count <= 0) {
+			return false;
+		}
+		written += count;
+	}
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean patchFile(const char * path, const size_t offset, const size_t removedLength, const char * inserted, const size_t insertedLength) {
+	const int descriptor = open(path, O_RDWR);
+	if (descriptor < 0) {
+		logError(_logger, "Cannot open the file to patch: %s", path);
+		return false;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) < 0 || (size_t) status.st_size < offset + removedLength) {
+		logError(_logger, "The patch is out of the file: %s", path);
+		close(descriptor);
+		return false;
+	}
+	const size_t size = status.st_size;
+	const size_t tailLength = size - offset - removedLength;
+	const off_t tailFrom = offset + removedLength;
+	const off_t tailTo = offset + insertedLength;
+	boolean succeed = _moveRange(descriptor, tailFrom, tailTo, tailLength)
+		&& _writeFully(descriptor, inserted, insertedLength, offset);
+	if (succeed && insertedLength < removedLength) {
+		succeed = ftruncate(descriptor, size + insertedLength - removedLength) == 0;
+	}
+	succeed = close(descriptor) == 0 && succeed;
+	if (succeed) {
+		addToStatistic("file-patcher.patches", 1);
+		addToStatistic("file-patcher.moved-bytes", tailFrom == tailTo ? 0 : tailLength);
+	}
+	else {
+		logError(_logger, "Cannot patch the file: %s", path);
+	}
+	return succeed;
+}
@@ -0,0 +1,30 @@
+#ifndef FILE_PATCHER_HEADER
+#define FILE_PATCHER_HEADER
+
+#include "Logger.h"
+#include "Statistics.h"
+#include "Type.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+void initializeFilePatcherModule();
+
+/** Shutdown module's internal state. */
+void shutdownFilePatcherModule();
+
+/**
+ * Replaces the bytes in the range [offset, offset + removedLength) of a file
+ * with the inserted ones, in place: only the tail that follows the range is
+ * moved (in blocks, from the end if the file grows, or from the beginning if
+ * it shrinks), and the rest of the file is never read nor written.
+ *
+ * Unlike a rewrite followed by a rename, a concurrent reader may observe the
+ * file while it's being patched.
+ */
+boolean patchFile(const char * path, const size_t offset, const size_t removedLength, const char * inserted, const size_t insertedLength);
+
+#endif
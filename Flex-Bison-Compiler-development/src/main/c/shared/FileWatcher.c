@@ -0,0 +1,139 @@
+#include "FileWatcher.h"
+
+/* MODULE INTERNAL STATE */
+
+#define EVENT_BUFFER_SIZE (64 * 1024)
+#define POLL_TIMEOUT 1000
+
+static Logger * _logger = NULL;
+static volatile sig_atomic_t _stopped = 0;
+
+void initializeFileWatcherModule() {
+	_logger = createLogger("FileWatcher");
+}
+
+void shutdownFileWatcherModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _isIgnored(const char * name);
+static void _reportExistingFiles(const char * directory, FileEventHandler handler, void * context);
+static void _stop(int signalNumber);
+
+/**
+ * Whether the name belongs to a hidden or backup file (e.g., the swap and
+ * temporary files of the editors).
+ */
+static boolean _isIgnored(const char * name) {
+	const size_t length = strlen(name);
+	return length == 0 || name[0] == '.' || name[length - 1] == '~';
+}
+
+/**
+ * Reports every regular file already in the directory as changed.
+ */
+static void _reportExistingFiles(const char * directory, FileEventHandler handler, void * context) {
+	DIR * stream = opendir(directory);
+	if (stream == NULL) {
+		return;
+	}
+	struct dirent * entry;
+	while (!_stopped && (entry = readdir(stream)) != NULL) {
+		if (_isIgnored(entry->d_name)) {
+			continue;
+		}
+		char * path = concatenate(3, directory, "/", entry->d_name);
+		struct stat status;
+		if (stat(path, &status) == 0 && S_ISREG(status.st_mode)) {
+			handler(path, FILE_CHANGED, context);
+		}
+		free(path);
+	}
+	closedir(stream);
+}
+
+/**
+ * Stops the watch loop (installed for SIGINT and SIGTERM).
+ */
+static void _stop(int signalNumber) {
+	(void) signalNumber;
+	_stopped = 1;
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean watchDirectory(const char * directory, FileEventHandler handler, void * context) {
+	const int descriptor = inotify_init1(IN_CLOEXEC);
+	if (descriptor < 0) {
+		logError(_logger, "Cannot initialize inotify.");
+		return false;
+	}
+	const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+	if (inotify_add_watch(descriptor, directory, mask) < 0) {
+		logError(_logger, "Cannot watch the directory: %s", directory);
+		close(descriptor);
+		return false;
+	}
+	// Without SA_RESTART, so the signals also interrupt the "poll".
+	struct sigaction action;
+	struct sigaction previousInterrupt;
+	struct sigaction previousTermination;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = _stop;
+	sigemptyset(&action.sa_mask);
+	_stopped = 0;
+	sigaction(SIGINT, &action, &previousInterrupt);
+	sigaction(SIGTERM, &action, &previousTermination);
+
+	_reportExistingFiles(directory, handler, context);
+	logInformation(_logger, "Watching \"%s\" (press Ctrl+C to stop)...", directory);
+	char * events = malloc(EVENT_BUFFER_SIZE);
+	struct pollfd target = {
+		.fd = descriptor,
+		.events = POLLIN
+	};
+	while (!_stopped) {
+		if (poll(&target, 1, POLL_TIMEOUT) <= 0) {
+			continue;
+		}
+		const ssize_t length = read(descriptor, events, EVENT_BUFFER_SIZE);
+		if (length <= 0) {
+			continue;
+		}
+		// Reports each file once (the last event wins), in order of appearance.
+		for (ssize_t offset = 0; offset < length && !_stopped;) {
+			const struct inotify_event * event = (const struct inotify_event *) (events + offset);
+			offset += sizeof(struct inotify_event) + event->len;
+			if (event->len == 0 || _isIgnored(event->name) || (event->mask & IN_ISDIR)) {
+				continue;
+			}
+			boolean isRepeated = false;
+			for (ssize_t next = offset; next < length && !isRepeated;) {
+				const struct inotify_event * other = (const struct inotify_event *) (events + next);
+				next += sizeof(struct inotify_event) + other->len;
+				isRepeated = other->len != 0 && strcmp(other->name, event->name) == 0;
+			}
+			if (isRepeated) {
+				continue;
+			}
+			const FileEvent fileEvent = (event->mask & (IN_DELETE | IN_MOVED_FROM)) ? FILE_REMOVED : FILE_CHANGED;
+			char * path = concatenate(3, directory, "/", event->name);
+			handler(path, fileEvent, context);
+			free(path);
+		}
+	}
+	free(events);
+	sigaction(SIGINT, &previousInterrupt, NULL);
+	sigaction(SIGTERM, &previousTermination, NULL);
+	close(descriptor);
+	logInformation(_logger, "Watch stopped.");
+	return true;
+}
+
+void scanDirectory(const char * directory, FileEventHandler handler, void * context) {
+	_reportExistingFiles(directory, handler, context);
+}
@@ -0,0 +1,57 @@
+#ifndef FILE_WATCHER_HEADER
+#define FILE_WATCHER_HEADER
+
+#include "Logger.h"
+#include "String.h"
+#include "Type.h"
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+void initializeFileWatcherModule();
+
+/** Shutdown module's internal state. */
+void shutdownFileWatcherModule();
+
+/**
+ * The kind of change of a watched file.
+ */
+typedef enum {
+	FILE_CHANGED,
+	FILE_REMOVED
+} FileEvent;
+
+/**
+ * Receives the path of a changed (or removed) file, and the context given to
+ * "watchDirectory".
+ */
+typedef void (*FileEventHandler)(const char * path, const FileEvent event, void * context);
+
+/**
+ * Watches the regular files of a directory with inotify, and calls the
+ * handler every time one of them is written (once it is closed) or removed.
+ * Every existing file is reported as changed before waiting for events, and
+ * the events of a single read are coalesced, so a burst of writes to the same
+ * file is reported once. Hidden and backup files (ending in '~') are ignored.
+ *
+ * Blocks until the process receives SIGINT or SIGTERM, and then returns true
+ * (or false, if the directory cannot be watched).
+ *
+ * @see https://man7.org/linux/man-pages/man7/inotify.7.html
+ */
+boolean watchDirectory(const char * directory, FileEventHandler handler, void * context);
+
+/**
+ * Reports every regular file of a directory as changed, once (i.e., without
+ * watching it). Hidden and backup files are ignored, like in a watch.
+ */
+void scanDirectory(const char * directory, FileEventHandler handler, void * context);
+
+#endif
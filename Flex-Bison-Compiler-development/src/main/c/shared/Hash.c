@@ -0,0 +1,117 @@
+#include "Hash.h"
+
+/* PRIVATE FUNCTIONS */
+
+static const uint64_t _prime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t _prime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t _prime3 = 0x165667B19E3779F9ULL;
+static const uint64_t _prime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t _prime5 = 0x27D4EB2F165667C5ULL;
+
+static uint64_t _avalanche(uint64_t hash);
+static uint64_t _mergeRound(uint64_t accumulator, const uint64_t value);
+static uint32_t _read32(const unsigned char * bytes);
+static uint64_t _read64(const unsigned char * bytes);
+static uint64_t _rotateLeft(const uint64_t value, const unsigned int bits);
+static uint64_t _round(uint64_t accumulator, const uint64_t input);
+
+/**
+ * Spreads the entropy of every bit of the hash over the entire word.
+ */
+static uint64_t _avalanche(uint64_t hash) {
+	hash ^= hash >> 33;
+	hash *= _prime2;
+	hash ^= hash >> 29;
+	hash *= _prime3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+static uint64_t _mergeRound(uint64_t accumulator, const uint64_t value) {
+	accumulator ^= _round(0, value);
+	return accumulator * _prime1 + _prime4;
+}
+
+/**
+ * Unaligned little-endian reads. The "memcpy" is optimized away by the
+ * compiler into a single load on every relevant architecture.
+ */
+static uint32_t _read32(const unsigned char * bytes) {
+	uint32_t value;
+	memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+static uint64_t _read64(const unsigned char * bytes) {
+	uint64_t value;
+	memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+static uint64_t _rotateLeft(const uint64_t value, const unsigned int bits) {
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t _round(uint64_t accumulator, const uint64_t input) {
+	accumulator += input * _prime2;
+	accumulator = _rotateLeft(accumulator, 31);
+	return accumulator * _prime1;
+}
+
+/* PUBLIC FUNCTIONS */
+
+uint64_t hashBytes(const void * bytes, const size_t length, const uint64_t seed) {
+	const unsigned char * cursor = bytes;
+	const unsigned char * const end = cursor + length;
+	uint64_t hash;
+	if (32 <= length) {
+		const unsigned char * const limit = end - 32;
+		uint64_t v1 = seed + _prime1 + _prime2;
+		uint64_t v2 = seed + _prime2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - _prime1;
+		do {
+			v1 = _round(v1, _read64(cursor));
+			v2 = _round(v2, _read64(cursor + 8));
+			v3 = _round(v3, _read64(cursor + 16));
+			v4 = _round(v4, _read64(cursor + 24));
+			cursor += 32;
+		} while (cursor <= limit);
+		hash = _rotateLeft(v1, 1) + _rotateLeft(v2, 7) + _rotateLeft(v3, 12) + _rotateLeft(v4, 18);
+		hash = _mergeRound(hash, v1);
+		hash = _mergeRound(hash, v2);
+		hash = _mergeRound(hash, v3);
+		hash = _mergeRound(hash, v4);
+	}
+	else {
+		hash = seed + _prime5;
+	}
+	hash += (uint64_t) length;
+	while (cursor + 8 <= end) {
+		hash ^= _round(0, _read64(cursor));
+		hash = _rotateLeft(hash, 27) * _prime1 + _prime4;
+		cursor += 8;
+	}
+	if (cursor + 4 <= end) {
+		hash ^= (uint64_t) _read32(cursor) * _prime1;
+		hash = _rotateLeft(hash, 23) * _prime2 + _prime3;
+		cursor += 4;
+	}
+	while (cursor < end) {
+		hash ^= (*cursor) * _prime5;
+		hash = _rotateLeft(hash, 11) * _prime1;
+		++cursor;
+	}
+	return _avalanche(hash);
+}
+
+uint64_t hashString(const char * string, const uint64_t seed) {
+	if (string == NULL) {
+		return _avalanche(seed + _prime5);
+	}
+	return hashBytes(string, strlen(string), seed);
+}
+
+uint64_t combineHashes(const uint64_t accumulated, const uint64_t value) {
+	return _avalanche(_rotateLeft(accumulated, 27) * _prime1 + _round(_prime4, value));
+}
@@ -0,0 +1,28 @@
+#ifndef HASH_HEADER
+#define HASH_HEADER
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Computes the 64-bit hash of a sequence of bytes. The algorithm is XXH64, so
+ * the result is stable across executions and platforms, and can be persisted.
+ *
+ * @see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+ */
+uint64_t hashBytes(const void * bytes, const size_t length, const uint64_t seed);
+
+/**
+ * Analog to "hashBytes", but for null-terminated strings. A NULL string has
+ * a well-defined hash too.
+ */
+uint64_t hashString(const char * string, const uint64_t seed);
+
+/**
+ * Mixes a 64-bit value into an accumulated hash. The operation is not
+ * commutative, so the order of the combined values matters.
+ */
+uint64_t combineHashes(const uint64_t accumulated, const uint64_t value);
+
+#endif
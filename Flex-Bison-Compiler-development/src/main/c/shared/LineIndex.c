@@ -0,0 +1,171 @@
+#include "LineIndex.h"
+
+/* MODULE INTERNAL STATE */
+
+typedef uint64_t (*NewlineClassifier)(const uint8_t * block);
+
+struct LineIndex {
+	const char * source;
+	size_t length;
+	unsigned int firstLine;
+	unsigned int firstColumn;
+
+	// The offsets of the new-lines, in order (once indexed).
+	size_t * newlines;
+	size_t count;
+	boolean isIndexed;
+};
+
+/* PRIVATE FUNCTIONS */
+
+static NewlineClassifier _classifier(void);
+static void _indexNewlines(LineIndex * lineIndex);
+
+#if defined(__SSE2__)
+	static uint64_t _newlinesSSE2(const uint8_t * block);
+#else
+	static uint64_t _newlinesScalar(const uint8_t * block);
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+	static uint64_t _newlinesAVX2(const uint8_t * block);
+#endif
+
+/**
+ * The widest classifier that the processor supports.
+ */
+static NewlineClassifier _classifier(void) {
+	#if defined(__x86_64__) || defined(__i386__)
+		if (__builtin_cpu_supports("avx2")) {
+			return _newlinesAVX2;
+		}
+	#endif
+	#if defined(__SSE2__)
+		return _newlinesSSE2;
+	#else
+		return _newlinesScalar;
+	#endif
+}
+
+/**
+ * Finds the offsets of every new-line of the source, 64 bytes at a time: a
+ * first pass counts them (so the array is allocated once), and a second one
+ * stores them.
+ */
+static void _indexNewlines(LineIndex * lineIndex) {
+	const NewlineClassifier classifier = _classifier();
+	const uint8_t * bytes = (const uint8_t *) lineIndex->source;
+	const size_t blocks = lineIndex->length / 64;
+	lineIndex->newlines = malloc((1 + countNewlines(lineIndex->source, lineIndex->length)) * sizeof(size_t));
+	lineIndex->count = 0;
+	for (size_t block = 0; block < blocks; ++block) {
+		for (uint64_t newlines = classifier(bytes + 64 * block); newlines != 0; newlines &= newlines - 1) {
+			lineIndex->newlines[lineIndex->count++] = 64 * block + __builtin_ctzll(newlines);
+		}
+	}
+	for (size_t offset = 64 * blocks; offset < lineIndex->length; ++offset) {
+		if (bytes[offset] == '\n') {
+			lineIndex->newlines[lineIndex->count++] = offset;
+		}
+	}
+	lineIndex->isIndexed = true;
+}
+
+#if defined(__SSE2__)
+	/**
+	 * The new-lines of a block, 16 bytes at a time.
+	 */
+	static uint64_t _newlinesSSE2(const uint8_t * block) {
+		const __m128i newline = _mm_set1_epi8('\n');
+		uint64_t newlines = 0;
+		for (unsigned int k = 0; k < 64; k += 16) {
+			const __m128i v = _mm_loadu_si128((const __m128i *) (block + k));
+			newlines |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)) << k;
+		}
+		return newlines;
+	}
+#else
+	/**
+	 * The new-lines of a block, a bit per byte, one byte at a time.
+	 */
+	static uint64_t _newlinesScalar(const uint8_t * block) {
+		uint64_t newlines = 0;
+		for (unsigned int k = 0; k < 64; ++k) {
+			newlines |= (uint64_t) (block[k] == '\n') << k;
+		}
+		return newlines;
+	}
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+	/**
+	 * The new-lines of a block, 32 bytes at a time (only called if the
+	 * processor supports AVX2).
+	 */
+	__attribute__((target("avx2")))
+	static uint64_t _newlinesAVX2(const uint8_t * block) {
+		const __m256i newline = _mm256_set1_epi8('\n');
+		const __m256i low = _mm256_loadu_si256((const __m256i *) block);
+		const __m256i high = _mm256_loadu_si256((const __m256i *) (block + 32));
+		return (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(low, newline))
+			| ((uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(high, newline)) << 32);
+	}
+#endif
+
+/* PUBLIC FUNCTIONS */
+
+LineIndex * createLineIndex(const char * source, const size_t length, const unsigned int firstLine, const unsigned int firstColumn) {
+	LineIndex * lineIndex = malloc(sizeof(LineIndex));
+	*lineIndex = (LineIndex) {
+		.source = source,
+		.length = length,
+		.firstLine = firstLine,
+		.firstColumn = firstColumn,
+		.newlines = NULL,
+		.count = 0,
+		.isIndexed = false
+	};
+	return lineIndex;
+}
+
+void destroyLineIndex(LineIndex * lineIndex) {
+	if (lineIndex != NULL) {
+		free(lineIndex->newlines);
+		free(lineIndex);
+	}
+}
+
+void locateOffset(LineIndex * lineIndex, const size_t offset, unsigned int * line, unsigned int * column) {
+	if (!lineIndex->isIndexed) {
+		_indexNewlines(lineIndex);
+	}
+	const size_t position = offset < lineIndex->length ? offset : lineIndex->length;
+	// The first new-line at the position (or after it).
+	size_t low = 0;
+	size_t high = lineIndex->count;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (lineIndex->newlines[middle] < position) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	*line = lineIndex->firstLine + (unsigned int) low;
+	*column = low == 0
+		? lineIndex->firstColumn + (unsigned int) position
+		: 1 + (unsigned int) (position - lineIndex->newlines[low - 1] - 1);
+}
+
+size_t countNewlines(const char * bytes, const size_t length) {
+	const NewlineClassifier classifier = _classifier();
+	const size_t blocks = length / 64;
+	size_t count = 0;
+	for (size_t block = 0; block < blocks; ++block) {
+		count += __builtin_popcountll(classifier((const uint8_t *) bytes + 64 * block));
+	}
+	for (size_t offset = 64 * blocks; offset < length; ++offset) {
+		count += bytes[offset] == '\n';
+	}
+	return count;
+}
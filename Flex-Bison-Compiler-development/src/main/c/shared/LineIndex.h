@@ -0,0 +1,45 @@
+#ifndef LINE_INDEX_HEADER
+#define LINE_INDEX_HEADER
+
+#include "Type.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+#endif
+
+/**
+ * The lines of a source, so the lexers only have to track the offset of each
+ * token, and the line and column of one are computed when a diagnostic needs
+ * them. The offsets of the new-lines are indexed on the first lookup (with
+ * AVX2 or SSE2 if available, and a scalar fallback otherwise), so a source
+ * without errors is never indexed at all.
+ */
+typedef struct LineIndex LineIndex;
+
+/**
+ * Creates the (empty) index of a source, whose first byte is at a line and
+ * column (e.g., a chunk of a bigger source, cut in the middle of a line). The
+ * source must outlive the index.
+ */
+LineIndex * createLineIndex(const char * source, const size_t length, const unsigned int firstLine, const unsigned int firstColumn);
+
+/**
+ * Destroy an index and its resources.
+ */
+void destroyLineIndex(LineIndex * lineIndex);
+
+/**
+ * The line and column (both counted from 1, the column in bytes) of an offset
+ * of the source (or of its end, if it's beyond it).
+ */
+void locateOffset(LineIndex * lineIndex, const size_t offset, unsigned int * line, unsigned int * column);
+
+/**
+ * How many new-lines there are in a sequence of bytes.
+ */
+size_t countNewlines(const char * bytes, const size_t length);
+
+#endif
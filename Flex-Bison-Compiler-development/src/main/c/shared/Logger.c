@@ -1,5 +1,10 @@
 #include "Logger.h"
 
+/* MODULE INTERNAL STATE */
+
+// Whether the loggers are muted on this thread.
+static __thread boolean _isMuted = false;
+
 /* PRIVATE FUNCTIONS */
 
 static void _log(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments);
@@ -11,7 +16,7 @@ static const char * _toContextString(const LoggingLevel loggingLevel);
  * Logs a new message at the specified level, using a format string.
  */
 static void _log(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments) {
-	if (logger->loggingLevel <= loggingLevel) {
+	if (logger->loggingLevel <= loggingLevel && !_isMuted) {
 		const char * context = _toContextString(loggingLevel);
 		char * effectiveFormat = concatenate(6, context, "[", logger->name, "] ", format, "\n");
 		if (ERROR <= loggingLevel) {
@@ -85,6 +90,10 @@ void destroyLogger(Logger * logger) {
 	}
 }
 
+void muteLogging(const boolean isMuted) {
+	_isMuted = isMuted;
+}
+
 void logCritical(const Logger * logger, const char * const format, ...) {
 	va_list arguments;
 	va_start(arguments, format);
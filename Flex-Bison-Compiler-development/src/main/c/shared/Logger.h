@@ -3,6 +3,7 @@
 
 #include "Environment.h"
 #include "String.h"
+#include "Type.h"
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -86,6 +87,12 @@ Logger * createLogger(char * name);
  */
 void destroyLogger(Logger * logger);
 
+/**
+ * Mutes (or unmutes) every logger, but only on the calling thread (e.g., while
+ * it does speculative work, whose errors are reported again if they matter).
+ */
+void muteLogging(const boolean isMuted);
+
 /** Logs at CRITICAL level. */
 void logCritical(const Logger * logger, const char * const format, ...);
 
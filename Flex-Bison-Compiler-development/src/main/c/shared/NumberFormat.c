@@ -0,0 +1,606 @@
+#include "NumberFormat.h"
+
+/* PRIVATE FUNCTIONS */
+
+/**
+ * A floating-point number with a 64-bit significand and no implicit bit
+ * (the "do-it-yourself" floating-point of Grisu).
+ */
+typedef struct {
+	uint64_t significand;
+	int exponent;
+} DiyFloat;
+
+static const char _digitPairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const uint64_t _powersOf10[] = {
+	UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000), UINT64_C(10000),
+	UINT64_C(100000), UINT64_C(1000000), UINT64_C(10000000), UINT64_C(100000000),
+	UINT64_C(1000000000), UINT64_C(10000000000), UINT64_C(100000000000),
+	UINT64_C(1000000000000), UINT64_C(10000000000000), UINT64_C(100000000000000),
+	UINT64_C(1000000000000000), UINT64_C(10000000000000000),
+	UINT64_C(100000000000000000), UINT64_C(1000000000000000000),
+	UINT64_C(10000000000000000000)
+};
+
+/**
+ * The normalized powers of ten 10^-348, 10^-340, ..., 10^340 (rounded to 64
+ * bits), and their binary exponents.
+ */
+static const uint64_t _cachedPowersSignificand[] = {
+	UINT64_C(0xfa8fd5a0081c0288), UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x8b16fb203055ac76),
+	UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0xe61acf033d1a45df),
+	UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0xbe5691ef416bd60c),
+	UINT64_C(0x8dd01fad907ffc3c), UINT64_C(0xd3515c2831559a83), UINT64_C(0x9d71ac8fada6c9b5),
+	UINT64_C(0xea9c227723ee8bcb), UINT64_C(0xaecc49914078536d), UINT64_C(0x823c12795db6ce57),
+	UINT64_C(0xc21094364dfb5637), UINT64_C(0x9096ea6f3848984f), UINT64_C(0xd77485cb25823ac7),
+	UINT64_C(0xa086cfcd97bf97f4), UINT64_C(0xef340a98172aace5), UINT64_C(0xb23867fb2a35b28e),
+	UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x936b9fcebb25c996),
+	UINT64_C(0xdbac6c247d62a584), UINT64_C(0xa3ab66580d5fdaf6), UINT64_C(0xf3e2f893dec3f126),
+	UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x87625f056c7c4a8b), UINT64_C(0xc9bcff6034c13053),
+	UINT64_C(0x964e858c91ba2655), UINT64_C(0xdff9772470297ebd), UINT64_C(0xa6dfbd9fb8e5b88f),
+	UINT64_C(0xf8a95fcf88747d94), UINT64_C(0xb94470938fa89bcf), UINT64_C(0x8a08f0f8bf0f156b),
+	UINT64_C(0xcdb02555653131b6), UINT64_C(0x993fe2c6d07b7fac), UINT64_C(0xe45c10c42a2b3b06),
+	UINT64_C(0xaa242499697392d3), UINT64_C(0xfd87b5f28300ca0e), UINT64_C(0xbce5086492111aeb),
+	UINT64_C(0x8cbccc096f5088cc), UINT64_C(0xd1b71758e219652c), UINT64_C(0x9c40000000000000),
+	UINT64_C(0xe8d4a51000000000), UINT64_C(0xad78ebc5ac620000), UINT64_C(0x813f3978f8940984),
+	UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x8f7e32ce7bea5c70), UINT64_C(0xd5d238a4abe98068),
+	UINT64_C(0x9f4f2726179a2245), UINT64_C(0xed63a231d4c4fb27), UINT64_C(0xb0de65388cc8ada8),
+	UINT64_C(0x83c7088e1aab65db), UINT64_C(0xc45d1df942711d9a), UINT64_C(0x924d692ca61be758),
+	UINT64_C(0xda01ee641a708dea), UINT64_C(0xa26da3999aef774a), UINT64_C(0xf209787bb47d6b85),
+	UINT64_C(0xb454e4a179dd1877), UINT64_C(0x865b86925b9bc5c2), UINT64_C(0xc83553c5c8965d3d),
+	UINT64_C(0x952ab45cfa97a0b3), UINT64_C(0xde469fbd99a05fe3), UINT64_C(0xa59bc234db398c25),
+	UINT64_C(0xf6c69a72a3989f5c), UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x88fcf317f22241e2),
+	UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x98165af37b2153df), UINT64_C(0xe2a0b5dc971f303a),
+	UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0xbb764c4ca7a44410),
+	UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0xd01fef10a657842c), UINT64_C(0x9b10a4e5e9913129),
+	UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0xac2820d9623bf429), UINT64_C(0x80444b5e7aa7cf85),
+	UINT64_C(0xbf21e44003acdd2d), UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0xd433179d9c8cb841),
+	UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0xeb96bf6ebadf77d9), UINT64_C(0xaf87023b9bf0ee6b)
+};
+
+static const int16_t _cachedPowersExponent[] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+	-954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+	-688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+	-422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+	-157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+	109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+	641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+	907, 933, 960, 986, 1013, 1039, 1066
+};
+
+/**
+ * The powers of ten that are exactly representable as doubles.
+ */
+static const double _exactPowersOf10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * The powers of five 5^-64, 5^-63, ..., 5^64, normalized to 128 bits (the
+ * high and the low halves), truncated (or rounded up, for the negative
+ * ones), as needed by the Eisel-Lemire algorithm. Beyond this range, reals
+ * are converted with "strtod".
+ */
+#define MINIMUM_POWER_OF_5 -64
+#define MAXIMUM_POWER_OF_5 64
+
+static const uint64_t _powersOf5[][2] = {
+	{ UINT64_C(0xa87fea27a539e9a5), UINT64_C(0x3f2398d747b36224) }, { UINT64_C(0xd29fe4b18e88640e), UINT64_C(0x8eec7f0d19a03aad) },
+	{ UINT64_C(0x83a3eeeef9153e89), UINT64_C(0x1953cf68300424ac) }, { UINT64_C(0xa48ceaaab75a8e2b), UINT64_C(0x5fa8c3423c052dd7) },
+	{ UINT64_C(0xcdb02555653131b6), UINT64_C(0x3792f412cb06794d) }, { UINT64_C(0x808e17555f3ebf11), UINT64_C(0xe2bbd88bbee40bd0) },
+	{ UINT64_C(0xa0b19d2ab70e6ed6), UINT64_C(0x5b6aceaeae9d0ec4) }, { UINT64_C(0xc8de047564d20a8b), UINT64_C(0xf245825a5a445275) },
+	{ UINT64_C(0xfb158592be068d2e), UINT64_C(0xeed6e2f0f0d56712) }, { UINT64_C(0x9ced737bb6c4183d), UINT64_C(0x55464dd69685606b) },
+	{ UINT64_C(0xc428d05aa4751e4c), UINT64_C(0xaa97e14c3c26b886) }, { UINT64_C(0xf53304714d9265df), UINT64_C(0xd53dd99f4b3066a8) },
+	{ UINT64_C(0x993fe2c6d07b7fab), UINT64_C(0xe546a8038efe4029) }, { UINT64_C(0xbf8fdb78849a5f96), UINT64_C(0xde98520472bdd033) },
+	{ UINT64_C(0xef73d256a5c0f77c), UINT64_C(0x963e66858f6d4440) }, { UINT64_C(0x95a8637627989aad), UINT64_C(0xdde7001379a44aa8) },
+	{ UINT64_C(0xbb127c53b17ec159), UINT64_C(0x5560c018580d5d52) }, { UINT64_C(0xe9d71b689dde71af), UINT64_C(0xaab8f01e6e10b4a6) },
+	{ UINT64_C(0x9226712162ab070d), UINT64_C(0xcab3961304ca70e8) }, { UINT64_C(0xb6b00d69bb55c8d1), UINT64_C(0x3d607b97c5fd0d22) },
+	{ UINT64_C(0xe45c10c42a2b3b05), UINT64_C(0x8cb89a7db77c506a) }, { UINT64_C(0x8eb98a7a9a5b04e3), UINT64_C(0x77f3608e92adb242) },
+	{ UINT64_C(0xb267ed1940f1c61c), UINT64_C(0x55f038b237591ed3) }, { UINT64_C(0xdf01e85f912e37a3), UINT64_C(0x6b6c46dec52f6688) },
+	{ UINT64_C(0x8b61313bbabce2c6), UINT64_C(0x2323ac4b3b3da015) }, { UINT64_C(0xae397d8aa96c1b77), UINT64_C(0xabec975e0a0d081a) },
+	{ UINT64_C(0xd9c7dced53c72255), UINT64_C(0x96e7bd358c904a21) }, { UINT64_C(0x881cea14545c7575), UINT64_C(0x7e50d64177da2e54) },
+	{ UINT64_C(0xaa242499697392d2), UINT64_C(0xdde50bd1d5d0b9e9) }, { UINT64_C(0xd4ad2dbfc3d07787), UINT64_C(0x955e4ec64b44e864) },
+	{ UINT64_C(0x84ec3c97da624ab4), UINT64_C(0xbd5af13bef0b113e) }, { UINT64_C(0xa6274bbdd0fadd61), UINT64_C(0xecb1ad8aeacdd58e) },
+	{ UINT64_C(0xcfb11ead453994ba), UINT64_C(0x67de18eda5814af2) }, { UINT64_C(0x81ceb32c4b43fcf4), UINT64_C(0x80eacf948770ced7) },
+	{ UINT64_C(0xa2425ff75e14fc31), UINT64_C(0xa1258379a94d028d) }, { UINT64_C(0xcad2f7f5359a3b3e), UINT64_C(0x096ee45813a04330) },
+	{ UINT64_C(0xfd87b5f28300ca0d), UINT64_C(0x8bca9d6e188853fc) }, { UINT64_C(0x9e74d1b791e07e48), UINT64_C(0x775ea264cf55347e) },
+	{ UINT64_C(0xc612062576589dda), UINT64_C(0x95364afe032a819e) }, { UINT64_C(0xf79687aed3eec551), UINT64_C(0x3a83ddbd83f52205) },
+	{ UINT64_C(0x9abe14cd44753b52), UINT64_C(0xc4926a9672793543) }, { UINT64_C(0xc16d9a0095928a27), UINT64_C(0x75b7053c0f178294) },
+	{ UINT64_C(0xf1c90080baf72cb1), UINT64_C(0x5324c68b12dd6339) }, { UINT64_C(0x971da05074da7bee), UINT64_C(0xd3f6fc16ebca5e04) },
+	{ UINT64_C(0xbce5086492111aea), UINT64_C(0x88f4bb1ca6bcf585) }, { UINT64_C(0xec1e4a7db69561a5), UINT64_C(0x2b31e9e3d06c32e6) },
+	{ UINT64_C(0x9392ee8e921d5d07), UINT64_C(0x3aff322e62439fd0) }, { UINT64_C(0xb877aa3236a4b449), UINT64_C(0x09befeb9fad487c3) },
+	{ UINT64_C(0xe69594bec44de15b), UINT64_C(0x4c2ebe687989a9b4) }, { UINT64_C(0x901d7cf73ab0acd9), UINT64_C(0x0f9d37014bf60a11) },
+	{ UINT64_C(0xb424dc35095cd80f), UINT64_C(0x538484c19ef38c95) }, { UINT64_C(0xe12e13424bb40e13), UINT64_C(0x2865a5f206b06fba) },
+	{ UINT64_C(0x8cbccc096f5088cb), UINT64_C(0xf93f87b7442e45d4) }, { UINT64_C(0xafebff0bcb24aafe), UINT64_C(0xf78f69a51539d749) },
+	{ UINT64_C(0xdbe6fecebdedd5be), UINT64_C(0xb573440e5a884d1c) }, { UINT64_C(0x89705f4136b4a597), UINT64_C(0x31680a88f8953031) },
+	{ UINT64_C(0xabcc77118461cefc), UINT64_C(0xfdc20d2b36ba7c3e) }, { UINT64_C(0xd6bf94d5e57a42bc), UINT64_C(0x3d32907604691b4d) },
+	{ UINT64_C(0x8637bd05af6c69b5), UINT64_C(0xa63f9a49c2c1b110) }, { UINT64_C(0xa7c5ac471b478423), UINT64_C(0x0fcf80dc33721d54) },
+	{ UINT64_C(0xd1b71758e219652b), UINT64_C(0xd3c36113404ea4a9) }, { UINT64_C(0x83126e978d4fdf3b), UINT64_C(0x645a1cac083126ea) },
+	{ UINT64_C(0xa3d70a3d70a3d70a), UINT64_C(0x3d70a3d70a3d70a4) }, { UINT64_C(0xcccccccccccccccc), UINT64_C(0xcccccccccccccccd) },
+	{ UINT64_C(0x8000000000000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xa000000000000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xc800000000000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xfa00000000000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0x9c40000000000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xc350000000000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xf424000000000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0x9896800000000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xbebc200000000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xee6b280000000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0x9502f90000000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xba43b74000000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xe8d4a51000000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0x9184e72a00000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xb5e620f480000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xe35fa931a0000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0x8e1bc9bf04000000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xb1a2bc2ec5000000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xde0b6b3a76400000), UINT64_C(0x0000000000000000) }, { UINT64_C(0x8ac7230489e80000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xad78ebc5ac620000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xd8d726b7177a8000), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0x878678326eac9000), UINT64_C(0x0000000000000000) }, { UINT64_C(0xa968163f0a57b400), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xd3c21bcecceda100), UINT64_C(0x0000000000000000) }, { UINT64_C(0x84595161401484a0), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0xa56fa5b99019a5c8), UINT64_C(0x0000000000000000) }, { UINT64_C(0xcecb8f27f4200f3a), UINT64_C(0x0000000000000000) },
+	{ UINT64_C(0x813f3978f8940984), UINT64_C(0x4000000000000000) }, { UINT64_C(0xa18f07d736b90be5), UINT64_C(0x5000000000000000) },
+	{ UINT64_C(0xc9f2c9cd04674ede), UINT64_C(0xa400000000000000) }, { UINT64_C(0xfc6f7c4045812296), UINT64_C(0x4d00000000000000) },
+	{ UINT64_C(0x9dc5ada82b70b59d), UINT64_C(0xf020000000000000) }, { UINT64_C(0xc5371912364ce305), UINT64_C(0x6c28000000000000) },
+	{ UINT64_C(0xf684df56c3e01bc6), UINT64_C(0xc732000000000000) }, { UINT64_C(0x9a130b963a6c115c), UINT64_C(0x3c7f400000000000) },
+	{ UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x4b9f100000000000) }, { UINT64_C(0xf0bdc21abb48db20), UINT64_C(0x1e86d40000000000) },
+	{ UINT64_C(0x96769950b50d88f4), UINT64_C(0x1314448000000000) }, { UINT64_C(0xbc143fa4e250eb31), UINT64_C(0x17d955a000000000) },
+	{ UINT64_C(0xeb194f8e1ae525fd), UINT64_C(0x5dcfab0800000000) }, { UINT64_C(0x92efd1b8d0cf37be), UINT64_C(0x5aa1cae500000000) },
+	{ UINT64_C(0xb7abc627050305ad), UINT64_C(0xf14a3d9e40000000) }, { UINT64_C(0xe596b7b0c643c719), UINT64_C(0x6d9ccd05d0000000) },
+	{ UINT64_C(0x8f7e32ce7bea5c6f), UINT64_C(0xe4820023a2000000) }, { UINT64_C(0xb35dbf821ae4f38b), UINT64_C(0xdda2802c8a800000) },
+	{ UINT64_C(0xe0352f62a19e306e), UINT64_C(0xd50b2037ad200000) }, { UINT64_C(0x8c213d9da502de45), UINT64_C(0x4526f422cc340000) },
+	{ UINT64_C(0xaf298d050e4395d6), UINT64_C(0x9670b12b7f410000) }, { UINT64_C(0xdaf3f04651d47b4c), UINT64_C(0x3c0cdd765f114000) },
+	{ UINT64_C(0x88d8762bf324cd0f), UINT64_C(0xa5880a69fb6ac800) }, { UINT64_C(0xab0e93b6efee0053), UINT64_C(0x8eea0d047a457a00) },
+	{ UINT64_C(0xd5d238a4abe98068), UINT64_C(0x72a4904598d6d880) }, { UINT64_C(0x85a36366eb71f041), UINT64_C(0x47a6da2b7f864750) },
+	{ UINT64_C(0xa70c3c40a64e6c51), UINT64_C(0x999090b65f67d924) }, { UINT64_C(0xd0cf4b50cfe20765), UINT64_C(0xfff4b4e3f741cf6d) },
+	{ UINT64_C(0x82818f1281ed449f), UINT64_C(0xbff8f10e7a8921a4) }, { UINT64_C(0xa321f2d7226895c7), UINT64_C(0xaff72d52192b6a0d) },
+	{ UINT64_C(0xcbea6f8ceb02bb39), UINT64_C(0x9bf4f8a69f764490) }, { UINT64_C(0xfee50b7025c36a08), UINT64_C(0x02f236d04753d5b4) },
+	{ UINT64_C(0x9f4f2726179a2245), UINT64_C(0x01d762422c946590) }, { UINT64_C(0xc722f0ef9d80aad6), UINT64_C(0x424d3ad2b7b97ef5) },
+	{ UINT64_C(0xf8ebad2b84e0d58b), UINT64_C(0xd2e0898765a7deb2) }, { UINT64_C(0x9b934c3b330c8577), UINT64_C(0x63cc55f49f88eb2f) },
+	{ UINT64_C(0xc2781f49ffcfa6d5), UINT64_C(0x3cbf6b71c76b25fb) }
+};
+
+static DiyFloat _cachedPower(const int exponent, int * decimalExponent);
+static boolean _eiselLemire(uint64_t significand, const int exponent, const boolean negative, double * result);
+static void _generateDigits(const DiyFloat w, const DiyFloat upper, uint64_t delta, char * digits, unsigned int * length, int * decimalExponent);
+static void _grisu2(const double value, char * digits, unsigned int * length, int * decimalExponent);
+static DiyFloat _multiply(const DiyFloat x, const DiyFloat y);
+static unsigned int _prettify(char * digits, const unsigned int length, const int decimalExponent);
+static void _round(char * digits, const unsigned int length, const uint64_t delta, uint64_t rest, const uint64_t tenKappa, const uint64_t distance);
+static unsigned int _writeExponent(int exponent, char * destination);
+
+/**
+ * A cached power of ten c = 10^-k, such that the exponent of the product of
+ * a significand with the specified binary exponent and c lands in the range
+ * [-60, -32] (so its integral part fits in 32 bits). Writes k.
+ */
+static DiyFloat _cachedPower(const int exponent, int * decimalExponent) {
+	const double approximation = (-61 - exponent) * 0.30102999566398114 + 347;
+	int k = (int) approximation;
+	if (0.0 < approximation - k) {
+		++k;
+	}
+	const unsigned int index = (k >> 3) + 1;
+	*decimalExponent = -(-348 + (int) (index << 3));
+	return (DiyFloat) {
+		.significand = _cachedPowersSignificand[index],
+		.exponent = _cachedPowersExponent[index]
+	};
+}
+
+/**
+ * Generates the shortest digits of a number between the lower and upper
+ * boundaries (the upper one, and the distance to the lower one, is "delta"),
+ * as close as possible to w.
+ */
+static void _generateDigits(const DiyFloat w, const DiyFloat upper, uint64_t delta, char * digits, unsigned int * length, int * decimalExponent) {
+	const DiyFloat one = {
+		.significand = UINT64_C(1) << -upper.exponent,
+		.exponent = upper.exponent
+	};
+	const uint64_t distance = upper.significand - w.significand;
+	uint32_t integral = (uint32_t) (upper.significand >> -one.exponent);
+	uint64_t fractional = upper.significand & (one.significand - 1);
+	int kappa = 1;
+	while (kappa < 10 && _powersOf10[kappa] <= integral) {
+		++kappa;
+	}
+	*length = 0;
+	while (0 < kappa) {
+		const uint32_t digit = integral / _powersOf10[kappa - 1];
+		integral %= _powersOf10[kappa - 1];
+		if (digit != 0 || *length != 0) {
+			digits[(*length)++] = '0' + digit;
+		}
+		--kappa;
+		const uint64_t rest = ((uint64_t) integral << -one.exponent) + fractional;
+		if (rest <= delta) {
+			*decimalExponent += kappa;
+			_round(digits, *length, delta, rest, _powersOf10[kappa] << -one.exponent, distance);
+			return;
+		}
+	}
+	while (true) {
+		fractional *= 10;
+		delta *= 10;
+		const char digit = (char) (fractional >> -one.exponent);
+		if (digit != 0 || *length != 0) {
+			digits[(*length)++] = '0' + digit;
+		}
+		fractional &= one.significand - 1;
+		--kappa;
+		if (fractional < delta) {
+			*decimalExponent += kappa;
+			const int index = -kappa;
+			_round(digits, *length, delta, fractional, one.significand, distance * (index < 20 ? _powersOf10[index] : 0));
+			return;
+		}
+	}
+}
+
+/**
+ * Converts significand * 10^exponent to the nearest double, with the
+ * Eisel-Lemire algorithm: the significand is multiplied by the truncated
+ * 128-bit power of five, and the product is rounded, unless it's too close
+ * to a halfway point to decide (then, it fails, and "strtod" should be used
+ * instead). The significand can't be zero.
+ */
+static boolean _eiselLemire(uint64_t significand, const int exponent, const boolean negative, double * result) {
+	const uint64_t * power = _powersOf5[exponent - MINIMUM_POWER_OF_5];
+	// The binary exponent of 10^exponent (floor(exponent * log2(10))), plus
+	// the bias and the bits of the significand.
+	const int64_t binaryExponent = (((152170 + 65536) * (int64_t) exponent) >> 16) + 1024 + 63;
+	int leadingZeros = __builtin_clzll(significand);
+	significand <<= leadingZeros;
+	unsigned __int128 product = (unsigned __int128) significand * power[0];
+	uint64_t lower = (uint64_t) product;
+	uint64_t upper = (uint64_t) (product >> 64);
+	if ((upper & 0x1FF) == 0x1FF && lower + significand < lower) {
+		// The truncated high half is not precise enough: use the low half too.
+		product = (unsigned __int128) significand * power[1];
+		const uint64_t productLow = (uint64_t) product;
+		const uint64_t productMiddle = lower + (uint64_t) (product >> 64);
+		if (productMiddle < lower) {
+			++upper;
+		}
+		if (productMiddle + 1 == 0 && (upper & 0x1FF) == 0x1FF && productLow + significand < productLow) {
+			return false;
+		}
+		lower = productMiddle;
+	}
+	const uint64_t upperBit = upper >> 63;
+	uint64_t mantissa = upper >> (upperBit + 9);
+	leadingZeros += 1 ^ upperBit;
+	if (lower == 0 && (upper & 0x1FF) == 0 && (mantissa & 3) == 1) {
+		// Exactly halfway between two doubles.
+		return false;
+	}
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if ((UINT64_C(1) << 53) <= mantissa) {
+		mantissa = UINT64_C(1) << 52;
+		--leadingZeros;
+	}
+	mantissa &= ~(UINT64_C(1) << 52);
+	const int64_t realExponent = binaryExponent - leadingZeros;
+	if (realExponent < 1 || 2046 < realExponent) {
+		// Subnormal, or infinite.
+		return false;
+	}
+	const uint64_t bits = mantissa | ((uint64_t) realExponent << 52) | ((uint64_t) negative << 63);
+	memcpy(result, &bits, sizeof(double));
+	return true;
+}
+
+/**
+ * Generates the digits of a positive (and finite) double, such that the
+ * number is digits * 10^decimalExponent.
+ */
+static void _grisu2(const double value, char * digits, unsigned int * length, int * decimalExponent) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(double));
+	const int biasedExponent = (int) ((bits >> 52) & 0x7FF);
+	const uint64_t hiddenBit = UINT64_C(1) << 52;
+	DiyFloat v = {
+		.significand = bits & (hiddenBit - 1),
+		.exponent = 1 - 1075
+	};
+	if (biasedExponent != 0) {
+		v.significand += hiddenBit;
+		v.exponent = biasedExponent - 1075;
+	}
+
+	// The boundaries: the halfway points to the neighbouring doubles.
+	DiyFloat upper = {
+		.significand = (v.significand << 1) + 1,
+		.exponent = v.exponent - 1
+	};
+	while (!(upper.significand & (hiddenBit << 1))) {
+		upper.significand <<= 1;
+		--upper.exponent;
+	}
+	upper.significand <<= 64 - 52 - 2;
+	upper.exponent -= 64 - 52 - 2;
+	DiyFloat lower = v.significand == hiddenBit
+		? (DiyFloat) { .significand = (v.significand << 2) - 1, .exponent = v.exponent - 2 }
+		: (DiyFloat) { .significand = (v.significand << 1) - 1, .exponent = v.exponent - 1 };
+	lower.significand <<= lower.exponent - upper.exponent;
+	lower.exponent = upper.exponent;
+
+	const int shift = __builtin_clzll(v.significand);
+	v.significand <<= shift;
+	v.exponent -= shift;
+	const DiyFloat power = _cachedPower(upper.exponent, decimalExponent);
+	const DiyFloat w = _multiply(v, power);
+	DiyFloat scaledUpper = _multiply(upper, power);
+	DiyFloat scaledLower = _multiply(lower, power);
+	// The products may be off by one unit, so the interval is shrunk.
+	++scaledLower.significand;
+	--scaledUpper.significand;
+	_generateDigits(w, scaledUpper, scaledUpper.significand - scaledLower.significand, digits, length, decimalExponent);
+}
+
+/**
+ * The product of two numbers, with the significand rounded to 64 bits.
+ */
+static DiyFloat _multiply(const DiyFloat x, const DiyFloat y) {
+	const unsigned __int128 product = (unsigned __int128) x.significand * y.significand;
+	uint64_t high = (uint64_t) (product >> 64);
+	if ((uint64_t) product & (UINT64_C(1) << 63)) {
+		++high;
+	}
+	return (DiyFloat) {
+		.significand = high,
+		.exponent = x.exponent + y.exponent + 64
+	};
+}
+
+/**
+ * Lays out the digits (in place) in decimal notation if the number is not
+ * too large nor too small, or in scientific notation otherwise. Returns the
+ * final length.
+ */
+static unsigned int _prettify(char * digits, const unsigned int length, const int decimalExponent) {
+	// The number is in [10^(point - 1), 10^point).
+	const int point = (int) length + decimalExponent;
+	if (0 <= decimalExponent && point <= 21) {
+		// E.g., 1234e7 is 12340000000.0
+		memset(digits + length, '0', point - length);
+		digits[point] = '.';
+		digits[point + 1] = '0';
+		return point + 2;
+	}
+	if (0 < point && point <= 21) {
+		// E.g., 1234e-2 is 12.34
+		memmove(digits + point + 1, digits + point, length - point);
+		digits[point] = '.';
+		return length + 1;
+	}
+	if (-6 < point && point <= 0) {
+		// E.g., 1234e-6 is 0.001234
+		const unsigned int offset = 2 - point;
+		memmove(digits + offset, digits, length);
+		digits[0] = '0';
+		digits[1] = '.';
+		memset(digits + 2, '0', offset - 2);
+		return length + offset;
+	}
+	if (length == 1) {
+		// E.g., 1e30
+		digits[1] = 'e';
+		return 2 + _writeExponent(point - 1, digits + 2);
+	}
+	// E.g., 1234e30 is 1.234e33
+	memmove(digits + 2, digits + 1, length - 1);
+	digits[1] = '.';
+	digits[length + 1] = 'e';
+	return length + 2 + _writeExponent(point - 1, digits + length + 2);
+}
+
+/**
+ * Moves the last digit towards w while the number stays inside the
+ * boundaries and gets closer to it.
+ */
+static void _round(char * digits, const unsigned int length, const uint64_t delta, uint64_t rest, const uint64_t tenKappa, const uint64_t distance) {
+	while (rest < distance && tenKappa <= delta - rest
+			&& (rest + tenKappa < distance || rest + tenKappa - distance < distance - rest)) {
+		--digits[length - 1];
+		rest += tenKappa;
+	}
+}
+
+/**
+ * Writes a decimal exponent, with its sign.
+ */
+static unsigned int _writeExponent(int exponent, char * destination) {
+	unsigned int length = 0;
+	destination[length++] = exponent < 0 ? '-' : '+';
+	if (exponent < 0) {
+		exponent = -exponent;
+	}
+	if (100 <= exponent) {
+		destination[length++] = '0' + exponent / 100;
+		exponent %= 100;
+		memcpy(destination + length, &_digitPairs[2 * exponent], 2);
+		return length + 2;
+	}
+	if (10 <= exponent) {
+		memcpy(destination + length, &_digitPairs[2 * exponent], 2);
+		return length + 2;
+	}
+	destination[length++] = '0' + exponent;
+	return length;
+}
+
+/* PUBLIC FUNCTIONS */
+
+unsigned int formatInteger(const int64_t value, char * destination) {
+	// The magnitude, even of the minimum (whose negation overflows).
+	uint64_t magnitude = value < 0 ? UINT64_C(0) - (uint64_t) value : (uint64_t) value;
+	char reversed[MAXIMUM_INTEGER_LENGTH];
+	unsigned int size = MAXIMUM_INTEGER_LENGTH;
+	while (100 <= magnitude) {
+		const unsigned int pair = 2 * (magnitude % 100);
+		magnitude /= 100;
+		reversed[--size] = _digitPairs[pair + 1];
+		reversed[--size] = _digitPairs[pair];
+	}
+	if (10 <= magnitude) {
+		reversed[--size] = _digitPairs[2 * magnitude + 1];
+		reversed[--size] = _digitPairs[2 * magnitude];
+	}
+	else {
+		reversed[--size] = '0' + magnitude;
+	}
+	unsigned int length = 0;
+	if (value < 0) {
+		destination[length++] = '-';
+	}
+	memcpy(destination + length, reversed + size, MAXIMUM_INTEGER_LENGTH - size);
+	return length + MAXIMUM_INTEGER_LENGTH - size;
+}
+
+unsigned int formatReal(const double value, char * destination) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(double));
+	const boolean isFinite = ((bits >> 52) & 0x7FF) != 0x7FF;
+	if (!isFinite && (bits & ((UINT64_C(1) << 52) - 1)) != 0) {
+		memcpy(destination, "NaN", 3);
+		return 3;
+	}
+	unsigned int length = 0;
+	if (bits >> 63) {
+		destination[length++] = '-';
+	}
+	if (!isFinite) {
+		memcpy(destination + length, "Infinity", 8);
+		return length + 8;
+	}
+	const double magnitude = value < 0 ? -value : value;
+	if (magnitude == 0.0) {
+		memcpy(destination + length, "0.0", 3);
+		return length + 3;
+	}
+	unsigned int digitsLength = 0;
+	int decimalExponent = 0;
+	_grisu2(magnitude, destination + length, &digitsLength, &decimalExponent);
+	return length + _prettify(destination + length, digitsLength, decimalExponent);
+}
+
+void appendIntegerToBuffer(Buffer * buffer, const int64_t value) {
+	char number[MAXIMUM_INTEGER_LENGTH];
+	appendToBuffer(buffer, number, formatInteger(value, number));
+}
+
+void appendRealToBuffer(Buffer * buffer, const double value) {
+	char number[MAXIMUM_REAL_LENGTH];
+	appendToBuffer(buffer, number, formatReal(value, number));
+}
+
+NumberType parseNumber(const char * text, const size_t length, int64_t * integer, double * real) {
+	size_t k = 0;
+	const boolean negative = 0 < length && text[0] == '-';
+	if (negative) {
+		++k;
+	}
+	// The first 19 significant digits (always fit in 64 bits), and the
+	// decimal exponent of the last one.
+	uint64_t significand = 0;
+	unsigned int digits = 0;
+	int exponent = 0;
+	boolean truncated = false;
+	boolean isInteger = true;
+	const size_t integralStart = k;
+	for (; k < length && '0' <= text[k] && text[k] <= '9'; ++k) {
+		if (digits < 19) {
+			significand = 10 * significand + (text[k] - '0');
+			digits += significand != 0;
+		}
+		else {
+			truncated |= text[k] != '0';
+			++exponent;
+		}
+	}
+	if (k == integralStart) {
+		return MALFORMED_NUMBER;
+	}
+	if (k < length && text[k] == '.') {
+		isInteger = false;
+		const size_t fractionStart = ++k;
+		for (; k < length && '0' <= text[k] && text[k] <= '9'; ++k) {
+			if (digits < 19) {
+				significand = 10 * significand + (text[k] - '0');
+				digits += significand != 0;
+				--exponent;
+			}
+			else {
+				truncated |= text[k] != '0';
+			}
+		}
+		if (k == fractionStart) {
+			return MALFORMED_NUMBER;
+		}
+	}
+	if (k < length && (text[k] == 'e' || text[k] == 'E')) {
+		isInteger = false;
+		++k;
+		const boolean negativeExponent = k < length && text[k] == '-';
+		if (k < length && (text[k] == '-' || text[k] == '+')) {
+			++k;
+		}
+		const size_t exponentStart = k;
+		int explicitExponent = 0;
+		for (; k < length && '0' <= text[k] && text[k] <= '9'; ++k) {
+			// Large enough to overflow (or underflow) any double.
+			if (explicitExponent < 100000) {
+				explicitExponent = 10 * explicitExponent + (text[k] - '0');
+			}
+		}
+		if (k == exponentStart) {
+			return MALFORMED_NUMBER;
+		}
+		exponent += negativeExponent ? -explicitExponent : explicitExponent;
+	}
+	if (k != length) {
+		return MALFORMED_NUMBER;
+	}
+	if (isInteger) {
+		if (0 < exponent || (uint64_t) INT64_MAX + negative < significand) {
+			return OUT_OF_RANGE_NUMBER;
+		}
+		*integer = negative ? (int64_t) (0 - significand) : (int64_t) significand;
+		return INTEGER_NUMBER;
+	}
+	if (significand == 0) {
+		*real = negative ? -0.0 : 0.0;
+		return REAL_NUMBER;
+	}
+	if (!truncated && -22 <= exponent && exponent <= 22 && significand <= (UINT64_C(1) << 53)) {
+		// Both the significand and the power of ten are exact, so a single
+		// (correctly rounded) operation is too.
+		const double value = (double) significand;
+		*real = exponent < 0 ? value / _exactPowersOf10[-exponent] : value * _exactPowersOf10[exponent];
+		*real = negative ? -*real : *real;
+		return REAL_NUMBER;
+	}
+	if (MINIMUM_POWER_OF_5 <= exponent && exponent <= MAXIMUM_POWER_OF_5 && _eiselLemire(significand, exponent, negative, real)) {
+		// If truncated, the real lies between significand and significand + 1,
+		// so it's exact only if both round to the same double.
+		double upperBound;
+		if (!truncated || (_eiselLemire(significand + 1, exponent, negative, &upperBound) && upperBound == *real)) {
+			return REAL_NUMBER;
+		}
+	}
+	char * copy = malloc(length + 1);
+	memcpy(copy, text, length);
+	copy[length] = '\0';
+	*real = strtod(copy, NULL);
+	free(copy);
+	return isinf(*real) ? OUT_OF_RANGE_NUMBER : REAL_NUMBER;
+}
@@ -0,0 +1,73 @@
+#ifndef NUMBER_FORMAT_HEADER
+#define NUMBER_FORMAT_HEADER
+
+#include "Buffer.h"
+#include "Type.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The maximum length of a formatted integer or real (without a
+ * null-terminator).
+ */
+#define MAXIMUM_INTEGER_LENGTH 20
+#define MAXIMUM_REAL_LENGTH 32
+
+/**
+ * The kind of a number read by "parseNumber".
+ */
+typedef enum {
+	INTEGER_NUMBER,
+	REAL_NUMBER,
+	// An integer beyond 64 bits, or a real beyond the range of a double.
+	OUT_OF_RANGE_NUMBER,
+	MALFORMED_NUMBER
+} NumberType;
+
+/**
+ * Writes the decimal representation of an integer (not null-terminated),
+ * two digits at a time, and returns its length. Unlike "printf", it never
+ * depends on the locale.
+ */
+unsigned int formatInteger(const int64_t value, char * destination);
+
+/**
+ * Writes the shortest decimal representation of a real that reads back as
+ * the same double (not null-terminated), and returns its length. The digits
+ * are generated with Grisu2, so it never depends on the locale, and it's
+ * always exact (although, in a few rare cases, a digit longer than the
+ * shortest possible one).
+ *
+ * The result always reads as a real: it has a decimal point (e.g., "1.0")
+ * or an exponent (e.g., "1e+21" or "1.5e-7"). Non-finite values are written
+ * as "NaN", "Infinity" and "-Infinity".
+ *
+ * @see https://www.cs.tufts.edu/~nr/cs257/archive/florian-loitsch/printf.pdf
+ */
+unsigned int formatReal(const double value, char * destination);
+
+/**
+ * Analog to "formatInteger" and "formatReal", but appended straight at the
+ * end of a buffer.
+ */
+void appendIntegerToBuffer(Buffer * buffer, const int64_t value);
+void appendRealToBuffer(Buffer * buffer, const double value);
+
+/**
+ * Reads a number (an optional minus sign, digits, an optional fraction and
+ * an optional exponent) in a single pass, classifying it while converting
+ * it: without fraction nor exponent, it's an integer (written in "integer"),
+ * otherwise, a real (written in "real"). The text doesn't need to be
+ * null-terminated.
+ *
+ * Reals are converted exactly, as "strtod" does, but most of them through a
+ * fast path: a single floating-point operation when the significand and the
+ * exponent are small, or an Eisel-Lemire 128-bit multiplication otherwise.
+ *
+ * @see https://arxiv.org/abs/2101.11408
+ */
+NumberType parseNumber(const char * text, const size_t length, int64_t * integer, double * real);
+
+#endif
@@ -0,0 +1,189 @@
+#include "ResultCache.h"
+
+/* MODULE INTERNAL STATE */
+
+#define RESULT_EXTENSION ".result"
+
+// The AST images share the directory (see "AbstractSyntaxTreeCache"), and
+// the bound of the cache.
+#define AST_IMAGE_EXTENSION ".ast"
+
+typedef struct {
+	char * path;
+	size_t size;
+	struct timespec lastUse;
+} CachedResult;
+
+static Logger * _logger = NULL;
+
+void initializeResultCacheModule() {
+	_logger = createLogger("ResultCache");
+}
+
+void shutdownResultCacheModule() {
+	const double hits = getStatistic("result-cache.hits");
+	const double lookups = hits + getStatistic("result-cache.misses");
+	if (0 < lookups) {
+		setStatistic("result-cache.hit-ratio", hits / lookups);
+	}
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static int _compareByLastUse(const void * left, const void * right);
+static void _evict(const char * directory, const size_t maximumSize);
+static boolean _hasExtension(const char * name, const char * extension);
+static char * _resultPath(const char * directory, const uint64_t key);
+
+/**
+ * Sorts cached results from the least to the most recently used.
+ */
+static int _compareByLastUse(const void * left, const void * right) {
+	const struct timespec * leftTime = &((const CachedResult *) left)->lastUse;
+	const struct timespec * rightTime = &((const CachedResult *) right)->lastUse;
+	if (leftTime->tv_sec != rightTime->tv_sec) {
+		return leftTime->tv_sec < rightTime->tv_sec ? -1 : 1;
+	}
+	if (leftTime->tv_nsec != rightTime->tv_nsec) {
+		return leftTime->tv_nsec < rightTime->tv_nsec ? -1 : 1;
+	}
+	return 0;
+}
+
+/**
+ * Removes the least recently used results and AST images until the total
+ * size of the cache fits in the maximum size. Files removed concurrently by
+ * other processes are silently skipped.
+ */
+static void _evict(const char * directory, const size_t maximumSize) {
+	DIR * stream = opendir(directory);
+	if (stream == NULL) {
+		return;
+	}
+	CachedResult * results = NULL;
+	size_t count = 0;
+	size_t capacity = 0;
+	size_t totalSize = 0;
+	struct dirent * entry;
+	while ((entry = readdir(stream)) != NULL) {
+		if (!_hasExtension(entry->d_name, RESULT_EXTENSION) && !_hasExtension(entry->d_name, AST_IMAGE_EXTENSION)) {
+			continue;
+		}
+		char * path = concatenate(3, directory, "/", entry->d_name);
+		struct stat status;
+		if (stat(path, &status) < 0) {
+			free(path);
+			continue;
+		}
+		if (count == capacity) {
+			capacity = capacity == 0 ? 64 : 2 * capacity;
+			results = realloc(results, capacity * sizeof(CachedResult));
+		}
+		results[count].path = path;
+		results[count].size = status.st_size;
+		results[count].lastUse = status.st_mtim;
+		totalSize += status.st_size;
+		++count;
+	}
+	closedir(stream);
+	if (maximumSize < totalSize) {
+		qsort(results, count, sizeof(CachedResult), _compareByLastUse);
+		for (size_t k = 0; k < count && maximumSize < totalSize; ++k) {
+			if (unlink(results[k].path) == 0) {
+				totalSize -= results[k].size;
+				addToStatistic("result-cache.evictions", 1);
+				logDebugging(_logger, "Evicted: %s", results[k].path);
+			}
+		}
+	}
+	for (size_t k = 0; k < count; ++k) {
+		free(results[k].path);
+	}
+	free(results);
+}
+
+/**
+ * Whether a file name ends with an extension (and it's not only that).
+ */
+static boolean _hasExtension(const char * name, const char * extension) {
+	const size_t nameLength = strlen(name);
+	const size_t extensionLength = strlen(extension);
+	return extensionLength < nameLength && strcmp(name + nameLength - extensionLength, extension) == 0;
+}
+
+/**
+ * The path of the file that holds the result of a key, using heap-memory.
+ */
+static char * _resultPath(const char * directory, const uint64_t key) {
+	char name[40];
+	snprintf(name, sizeof(name), "/%016llx" RESULT_EXTENSION, (unsigned long long) key);
+	return concatenate(2, directory, name);
+}
+
+/* PUBLIC FUNCTIONS */
+
+uint64_t resultCacheKey(const char * source, const size_t length, const char * options) {
+	const uint64_t seed = combineHashes(hashString(compilerBuildIdentifier(), 0), hashString(options, 0));
+	return hashBytes(source, length, seed);
+}
+
+boolean loadCachedResult(const char * directory, const uint64_t key, Buffer * output) {
+	char * path = _resultPath(directory, key);
+	FILE * file = fopen(path, "rb");
+	if (file == NULL) {
+		free(path);
+		addToStatistic("result-cache.misses", 1);
+		return false;
+	}
+	const size_t initialLength = output->length;
+	appendStreamToBuffer(output, file);
+	const boolean succeed = ferror(file) == 0;
+	fclose(file);
+	if (succeed) {
+		// Refreshes the recency of the result (used by the eviction).
+		utimensat(AT_FDCWD, path, NULL, 0);
+		addToStatistic("result-cache.hits", 1);
+	}
+	else {
+		output->length = initialLength;
+		addToStatistic("result-cache.misses", 1);
+	}
+	free(path);
+	return succeed;
+}
+
+void evictCachedArtifacts(const char * directory, const size_t maximumSize) {
+	_evict(directory, maximumSize);
+}
+
+void storeCachedResult(const char * directory, const uint64_t key, const char * result, const size_t length, const size_t maximumSize) {
+	if (mkdir(directory, 0755) < 0 && errno != EEXIST) {
+		logWarning(_logger, "Cannot create the cache directory: %s", directory);
+		return;
+	}
+	char * path = _resultPath(directory, key);
+	char temporarySuffix[32];
+	snprintf(temporarySuffix, sizeof(temporarySuffix), ".%ld.tmp", (long) getpid());
+	char * temporaryPath = concatenate(2, path, temporarySuffix);
+	// Written aside and renamed, so a concurrent reader never sees half a result.
+	FILE * file = fopen(temporaryPath, "wb");
+	boolean succeed = false;
+	if (file != NULL) {
+		succeed = fwrite(result, sizeof(char), length, file) == length;
+		succeed = fclose(file) == 0 && succeed;
+		succeed = succeed && rename(temporaryPath, path) == 0;
+	}
+	if (succeed) {
+		addToStatistic("result-cache.stores", 1);
+		_evict(directory, maximumSize);
+	}
+	else {
+		logWarning(_logger, "Cannot write the cached result: %s", path);
+		remove(temporaryPath);
+	}
+	free(temporaryPath);
+	free(path);
+}
@@ -0,0 +1,63 @@
+#ifndef RESULT_CACHE_HEADER
+#define RESULT_CACHE_HEADER
+
+#include "Buffer.h"
+#include "Hash.h"
+#include "Logger.h"
+#include "Statistics.h"
+#include "String.h"
+#include "Type.h"
+#include "Version.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+void initializeResultCacheModule();
+
+/** Shutdown module's internal state. */
+void shutdownResultCacheModule();
+
+/**
+ * A content-addressed cache of whole compilation results, stored as one file
+ * per result inside a directory. The key of a result is the hash of the
+ * source, the output options and the build identifier of the compiler, so
+ * a new build never reuses the outputs of an older one.
+ *
+ * The cache is bounded in size: every time a result is stored, the least
+ * recently used ones are evicted (the modification time of each file is
+ * refreshed on every hit, and used as the recency). The AST images stored in
+ * the same directory count, and are evicted the same way.
+ */
+
+/**
+ * Computes the key of the result of compiling a source with some options.
+ */
+uint64_t resultCacheKey(const char * source, const size_t length, const char * options);
+
+/**
+ * Appends the cached result of the key to the output buffer, if it exists,
+ * and returns true. Otherwise, returns false and leaves the output intact.
+ */
+boolean loadCachedResult(const char * directory, const uint64_t key, Buffer * output);
+
+/**
+ * Evicts the least recently used results and AST images of a directory
+ * until its size is under the specified maximum (e.g., after an AST image
+ * was stored there).
+ */
+void evictCachedArtifacts(const char * directory, const size_t maximumSize);
+
+/**
+ * Stores the result of a key, and then evicts the least recently used
+ * results until the size of the cache is under the specified maximum.
+ */
+void storeCachedResult(const char * directory, const uint64_t key, const char * result, const size_t length, const size_t maximumSize);
+
+#endif
@@ -0,0 +1,152 @@
+#include "RingBuffer.h"
+
+/* MODULE INTERNAL STATE */
+
+// How many times a side checks the other one before yielding its processor.
+#define MAXIMUM_SPINS 64
+
+#define CACHE_LINE_SIZE 64
+
+/**
+ * The positions are counters of items (never wrapped), so a side is full or
+ * empty only by their difference. Each group of fields is written by a
+ * single side, and lives on its own cache line.
+ */
+struct RingBuffer {
+	// Published by the producer, and read by the consumer.
+	size_t tail __attribute__((aligned(CACHE_LINE_SIZE)));
+	boolean isClosed;
+
+	// Published by the consumer, and read by the producer.
+	size_t head __attribute__((aligned(CACHE_LINE_SIZE)));
+	boolean isCancelled;
+
+	// Private to the producer: the next position, the last one published,
+	// and the last head it read.
+	size_t pushed __attribute__((aligned(CACHE_LINE_SIZE)));
+	size_t published;
+	size_t knownHead;
+
+	// Private to the consumer: the next position, the last one published,
+	// and the last tail it read.
+	size_t popped __attribute__((aligned(CACHE_LINE_SIZE)));
+	size_t released;
+	size_t knownTail;
+
+	// Never written after the creation.
+	char * slots __attribute__((aligned(CACHE_LINE_SIZE)));
+	size_t itemSize;
+	size_t capacity;
+	size_t batchSize;
+};
+
+/* PRIVATE FUNCTIONS */
+
+static void _wait(const unsigned int spins);
+
+/**
+ * Waits a little before checking the other side again: at first, it just
+ * spins (the other side is likely running on another processor), but then
+ * it yields.
+ */
+static void _wait(const unsigned int spins) {
+	if (MAXIMUM_SPINS <= spins) {
+		sched_yield();
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+RingBuffer * createRingBuffer(const size_t itemSize, const size_t capacity, const size_t batchSize) {
+	RingBuffer * ring = NULL;
+	if (posix_memalign((void **) &ring, CACHE_LINE_SIZE, sizeof(RingBuffer)) != 0) {
+		return NULL;
+	}
+	memset(ring, 0, sizeof(RingBuffer));
+	ring->capacity = 16;
+	while (ring->capacity < capacity) {
+		ring->capacity *= 2;
+	}
+	ring->itemSize = itemSize;
+	ring->batchSize = batchSize < 1 ? 1 : batchSize < ring->capacity ? batchSize : ring->capacity;
+	ring->slots = malloc(ring->capacity * itemSize);
+	return ring;
+}
+
+void destroyRingBuffer(RingBuffer * ring) {
+	if (ring != NULL) {
+		free(ring->slots);
+		free(ring);
+	}
+}
+
+boolean pushToRingBuffer(RingBuffer * ring, const void * item) {
+	if (ring->pushed == ring->published && __atomic_load_n(&ring->isCancelled, __ATOMIC_ACQUIRE)) {
+		return false;
+	}
+	if (ring->pushed - ring->knownHead == ring->capacity) {
+		flushRingBuffer(ring);
+		for (unsigned int spins = 0; ; ++spins) {
+			ring->knownHead = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+			if (ring->pushed - ring->knownHead < ring->capacity) {
+				break;
+			}
+			if (__atomic_load_n(&ring->isCancelled, __ATOMIC_ACQUIRE)) {
+				return false;
+			}
+			_wait(spins);
+		}
+	}
+	memcpy(ring->slots + (ring->pushed & (ring->capacity - 1)) * ring->itemSize, item, ring->itemSize);
+	if (ring->batchSize <= ++ring->pushed - ring->published) {
+		flushRingBuffer(ring);
+	}
+	return true;
+}
+
+void flushRingBuffer(RingBuffer * ring) {
+	if (ring->published != ring->pushed) {
+		ring->published = ring->pushed;
+		__atomic_store_n(&ring->tail, ring->pushed, __ATOMIC_RELEASE);
+	}
+}
+
+void closeRingBuffer(RingBuffer * ring) {
+	flushRingBuffer(ring);
+	__atomic_store_n(&ring->isClosed, true, __ATOMIC_RELEASE);
+}
+
+boolean popFromRingBuffer(RingBuffer * ring, void * item) {
+	if (ring->popped == ring->knownTail) {
+		// The producer may be waiting for room.
+		if (ring->released != ring->popped) {
+			ring->released = ring->popped;
+			__atomic_store_n(&ring->head, ring->popped, __ATOMIC_RELEASE);
+		}
+		for (unsigned int spins = 0; ; ++spins) {
+			ring->knownTail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+			if (ring->popped != ring->knownTail) {
+				break;
+			}
+			if (__atomic_load_n(&ring->isClosed, __ATOMIC_ACQUIRE)) {
+				// The tail was published before closing, so this one is the last.
+				ring->knownTail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+				if (ring->popped == ring->knownTail) {
+					return false;
+				}
+				break;
+			}
+			_wait(spins);
+		}
+	}
+	memcpy(item, ring->slots + (ring->popped & (ring->capacity - 1)) * ring->itemSize, ring->itemSize);
+	if (ring->batchSize <= ++ring->popped - ring->released) {
+		ring->released = ring->popped;
+		__atomic_store_n(&ring->head, ring->popped, __ATOMIC_RELEASE);
+	}
+	return true;
+}
+
+void cancelRingBuffer(RingBuffer * ring) {
+	__atomic_store_n(&ring->isCancelled, true, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,66 @@
+#ifndef RING_BUFFER_HEADER
+#define RING_BUFFER_HEADER
+
+#include "Type.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A lock-free queue of fixed-size items, between a single producer thread
+ * and a single consumer thread. Items are copied in and out of a circular
+ * array of slots, but the positions of each side are published only once
+ * per batch of items (or before waiting for the other side), so the threads
+ * seldom touch the same cache lines. A side that must wait spins a little
+ * and then yields its processor.
+ *
+ * @see https://www.1024cores.net/home/lock-free-algorithms/queues
+ */
+typedef struct RingBuffer RingBuffer;
+
+/**
+ * Creates an empty ring of items of a size, with (at least) the specified
+ * capacity (rounded up to a power of two), whose positions are published
+ * every "batchSize" items.
+ */
+RingBuffer * createRingBuffer(const size_t itemSize, const size_t capacity, const size_t batchSize);
+
+/**
+ * Destroy a ring and its resources (the items still in it are dropped).
+ */
+void destroyRingBuffer(RingBuffer * ring);
+
+/**
+ * Appends a copy of an item (only from the producer), waiting while the ring
+ * is full. Returns false if the consumer cancelled the ring, and then the
+ * item is not appended.
+ */
+boolean pushToRingBuffer(RingBuffer * ring, const void * item);
+
+/**
+ * Publishes the items pushed since the last batch (only from the producer).
+ */
+void flushRingBuffer(RingBuffer * ring);
+
+/**
+ * Publishes the last items, and tells the consumer that no more will come
+ * (only from the producer).
+ */
+void closeRingBuffer(RingBuffer * ring);
+
+/**
+ * Takes the next item into "item" (only from the consumer), waiting while
+ * the ring is empty. Returns false once the ring is closed and every item
+ * was taken.
+ */
+boolean popFromRingBuffer(RingBuffer * ring, void * item);
+
+/**
+ * Tells the producer that no more items will be taken (only from the
+ * consumer): its pushes fail from now on. The items still in the ring can be
+ * taken with "popFromRingBuffer" once the producer is done (e.g., to release
+ * them).
+ */
+void cancelRingBuffer(RingBuffer * ring);
+
+#endif
@@ -0,0 +1,328 @@
+#include "SharedResultCache.h"
+
+/* MODULE INTERNAL STATE */
+
+#define SEGMENT_MAGIC 0x5348524553554c54ULL
+#define SLOT_COUNT 512
+#define SLOT_SIZE (64 * 1024)
+#define BUCKET_COUNT (2 * SLOT_COUNT)
+#define PROBE_LENGTH 8
+#define READ_ATTEMPTS 4
+
+/**
+ * A bucket of the table. The sequence is even when the bucket is stable, and
+ * odd while a writer (identified by its process) holds it.
+ */
+typedef struct {
+	uint32_t sequence;
+	uint32_t slot;
+	uint64_t key;
+	uint32_t length;
+	int32_t writer;
+} SharedBucket;
+
+/**
+ * The header of a slot of the slab, followed by its bytes. A slot is owned by
+ * a bucket (zero if free), and claimed by a writer while it is being filled.
+ */
+typedef struct {
+	uint32_t bucket;
+	uint32_t referenced;
+	int32_t writer;
+	uint32_t padding;
+} SharedSlot;
+
+typedef struct {
+	uint64_t magic;
+	char buildIdentifier[64];
+	uint32_t clockHand;
+	uint32_t padding;
+	SharedBucket buckets[BUCKET_COUNT];
+} SegmentHeader;
+
+#define SLOT_STRIDE (sizeof(SharedSlot) + SLOT_SIZE)
+#define SEGMENT_SIZE (sizeof(SegmentHeader) + SLOT_COUNT * SLOT_STRIDE)
+
+static Logger * _logger = NULL;
+static SegmentHeader * _segment = NULL;
+static int _descriptor = -1;
+static char _name[64];
+
+void initializeSharedResultCacheModule() {
+	_logger = createLogger("SharedResultCache");
+}
+
+void shutdownSharedResultCacheModule() {
+	if (_segment != NULL) {
+		munmap(_segment, SEGMENT_SIZE);
+		_segment = NULL;
+	}
+	if (0 <= _descriptor) {
+		// If nobody else holds a shared lock, this is the last process attached.
+		if (flock(_descriptor, LOCK_EX | LOCK_NB) == 0) {
+			shm_unlink(_name);
+			logDebugging(_logger, "Removed the shared segment: %s", _name);
+		}
+		close(_descriptor);
+		_descriptor = -1;
+	}
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _acquireBucket(SharedBucket * bucket, uint32_t * sequence);
+static void _initializeSegment();
+static boolean _isDead(const int32_t writer);
+static void _releaseBucket(SharedBucket * bucket, const uint32_t sequence);
+static SharedSlot * _slot(const uint32_t index);
+static boolean _claimSlot(uint32_t * index);
+
+/**
+ * Acquires a bucket for writing with a single compare-and-swap, without
+ * waiting for other writers. If the bucket is held by a process that no
+ * longer exists, the lock is taken over. Returns the (odd) sequence of the
+ * acquired bucket, that must be given back to "_releaseBucket".
+ */
+static boolean _acquireBucket(SharedBucket * bucket, uint32_t * sequence) {
+	uint32_t expected = __atomic_load_n(&bucket->sequence, __ATOMIC_ACQUIRE);
+	if (expected & 1) {
+		if (!_isDead(__atomic_load_n(&bucket->writer, __ATOMIC_RELAXED))) {
+			return false;
+		}
+		// Stays odd: the crashed writer may have left the bucket half-written.
+		if (!__atomic_compare_exchange_n(&bucket->sequence, &expected, expected + 2, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return false;
+		}
+		__atomic_store_n(&bucket->writer, (int32_t) getpid(), __ATOMIC_RELAXED);
+		__atomic_store_n(&bucket->slot, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&bucket->key, 0, __ATOMIC_RELAXED);
+		addToStatistic("shared-cache.recoveries", 1);
+		*sequence = expected + 2;
+		return true;
+	}
+	if (!__atomic_compare_exchange_n(&bucket->sequence, &expected, expected + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return false;
+	}
+	__atomic_store_n(&bucket->writer, (int32_t) getpid(), __ATOMIC_RELAXED);
+	*sequence = expected + 1;
+	return true;
+}
+
+/**
+ * Finds a free slot with the clock algorithm: the hand sweeps the slab giving
+ * a second chance to every recently referenced slot. The slot found is
+ * claimed (no other writer can take it), and detached from its last bucket.
+ */
+static boolean _claimSlot(uint32_t * index) {
+	const int32_t self = (int32_t) getpid();
+	for (unsigned int k = 0; k < 2 * SLOT_COUNT; ++k) {
+		const uint32_t candidate = __atomic_fetch_add(&_segment->clockHand, 1, __ATOMIC_RELAXED) % SLOT_COUNT;
+		SharedSlot * slot = _slot(candidate);
+		int32_t writer = __atomic_load_n(&slot->writer, __ATOMIC_ACQUIRE);
+		if (writer != 0 && !_isDead(writer)) {
+			continue;
+		}
+		if (__atomic_exchange_n(&slot->referenced, 0, __ATOMIC_RELAXED)) {
+			continue;
+		}
+		if (!__atomic_compare_exchange_n(&slot->writer, &writer, self, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			continue;
+		}
+		const uint32_t owner = __atomic_load_n(&slot->bucket, __ATOMIC_RELAXED);
+		if (owner != 0) {
+			// Readers of the owner notice the change of sequence, and discard the copy.
+			SharedBucket * bucket = &_segment->buckets[owner - 1];
+			uint32_t sequence;
+			if (!_acquireBucket(bucket, &sequence)) {
+				__atomic_store_n(&slot->writer, 0, __ATOMIC_RELEASE);
+				continue;
+			}
+			if (__atomic_load_n(&bucket->slot, __ATOMIC_RELAXED) == candidate + 1) {
+				__atomic_store_n(&bucket->slot, 0, __ATOMIC_RELAXED);
+				__atomic_store_n(&bucket->key, 0, __ATOMIC_RELAXED);
+				addToStatistic("shared-cache.evictions", 1);
+			}
+			_releaseBucket(bucket, sequence);
+			__atomic_store_n(&slot->bucket, 0, __ATOMIC_RELAXED);
+		}
+		*index = candidate;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Fills the header of a new segment. Must be called by the only process
+ * attached to it (that is, holding the exclusive lock).
+ */
+static void _initializeSegment() {
+	memset(_segment, 0, SEGMENT_SIZE);
+	strncpy(_segment->buildIdentifier, compilerBuildIdentifier(), sizeof(_segment->buildIdentifier) - 1);
+	__atomic_store_n(&_segment->magic, SEGMENT_MAGIC, __ATOMIC_RELEASE);
+}
+
+/**
+ * Whether the process that holds a lock no longer exists.
+ */
+static boolean _isDead(const int32_t writer) {
+	return 0 < writer && kill((pid_t) writer, 0) < 0 && errno == ESRCH;
+}
+
+/**
+ * Releases a bucket acquired with "_acquireBucket", publishing its changes.
+ */
+static void _releaseBucket(SharedBucket * bucket, const uint32_t sequence) {
+	__atomic_store_n(&bucket->writer, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&bucket->sequence, sequence + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * The header of the slot with the specified index (its bytes follow it).
+ */
+static SharedSlot * _slot(const uint32_t index) {
+	return (SharedSlot *) (((char *) _segment) + sizeof(SegmentHeader) + index * SLOT_STRIDE);
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean attachSharedResultCache() {
+	if (_segment != NULL) {
+		return true;
+	}
+	// One segment per user and build, so incompatible compilers never meet.
+	snprintf(_name, sizeof(_name), "/flex-bison-compiler.%ld.%016llx",
+		(long) getuid(), (unsigned long long) hashString(compilerBuildIdentifier(), 0));
+	boolean created = true;
+	_descriptor = shm_open(_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (_descriptor < 0 && errno == EEXIST) {
+		created = false;
+		_descriptor = shm_open(_name, O_RDWR, 0600);
+	}
+	if (_descriptor < 0) {
+		logWarning(_logger, "Cannot open the shared segment: %s", _name);
+		return false;
+	}
+	// The creator initializes under an exclusive lock; the others wait for it.
+	if (flock(_descriptor, created ? LOCK_EX : LOCK_SH) < 0
+			|| (created && ftruncate(_descriptor, SEGMENT_SIZE) < 0)) {
+		logWarning(_logger, "Cannot lock the shared segment: %s", _name);
+		close(_descriptor);
+		_descriptor = -1;
+		return false;
+	}
+	struct stat status;
+	void * address = MAP_FAILED;
+	if (fstat(_descriptor, &status) == 0 && status.st_size == (off_t) SEGMENT_SIZE) {
+		address = mmap(NULL, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, _descriptor, 0);
+	}
+	if (address == MAP_FAILED) {
+		logWarning(_logger, "Cannot map the shared segment: %s", _name);
+		close(_descriptor);
+		_descriptor = -1;
+		return false;
+	}
+	_segment = address;
+	if (!created && __atomic_load_n(&_segment->magic, __ATOMIC_ACQUIRE) != SEGMENT_MAGIC) {
+		// The creator died while initializing: recover if nobody else is attached.
+		if (flock(_descriptor, LOCK_EX | LOCK_NB) == 0) {
+			created = true;
+		}
+		else {
+			logWarning(_logger, "The shared segment is not initialized: %s", _name);
+			munmap(_segment, SEGMENT_SIZE);
+			_segment = NULL;
+			close(_descriptor);
+			_descriptor = -1;
+			return false;
+		}
+	}
+	if (created) {
+		_initializeSegment();
+		flock(_descriptor, LOCK_SH);
+	}
+	logDebugging(_logger, "Attached to the shared segment: %s", _name);
+	return true;
+}
+
+boolean loadSharedResult(const uint64_t key, Buffer * output) {
+	if (_segment == NULL) {
+		return false;
+	}
+	const uint64_t effectiveKey = key == 0 ? 1 : key;
+	const size_t initialLength = output->length;
+	for (unsigned int p = 0; p < PROBE_LENGTH; ++p) {
+		SharedBucket * bucket = &_segment->buckets[(effectiveKey + p) % BUCKET_COUNT];
+		for (unsigned int attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+			const uint32_t sequence = __atomic_load_n(&bucket->sequence, __ATOMIC_ACQUIRE);
+			if (sequence & 1) {
+				continue;
+			}
+			if (__atomic_load_n(&bucket->key, __ATOMIC_RELAXED) != effectiveKey) {
+				break;
+			}
+			const uint32_t slot = __atomic_load_n(&bucket->slot, __ATOMIC_RELAXED);
+			const uint32_t length = __atomic_load_n(&bucket->length, __ATOMIC_RELAXED);
+			if (slot == 0 || SLOT_COUNT < slot || SLOT_SIZE < length) {
+				continue;
+			}
+			appendToBuffer(output, (const char *) (_slot(slot - 1) + 1), length);
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&bucket->sequence, __ATOMIC_RELAXED) == sequence) {
+				__atomic_store_n(&_slot(slot - 1)->referenced, 1, __ATOMIC_RELAXED);
+				addToStatistic("shared-cache.hits", 1);
+				return true;
+			}
+			// Overwritten while copying it.
+			output->length = initialLength;
+		}
+	}
+	addToStatistic("shared-cache.misses", 1);
+	return false;
+}
+
+void storeSharedResult(const uint64_t key, const char * result, const size_t length) {
+	if (_segment == NULL || SLOT_SIZE < length) {
+		return;
+	}
+	const uint64_t effectiveKey = key == 0 ? 1 : key;
+	// An empty bucket of the probe sequence, or its first one (which is replaced).
+	SharedBucket * target = &_segment->buckets[effectiveKey % BUCKET_COUNT];
+	for (unsigned int p = 0; p < PROBE_LENGTH; ++p) {
+		SharedBucket * bucket = &_segment->buckets[(effectiveKey + p) % BUCKET_COUNT];
+		const uint64_t candidate = __atomic_load_n(&bucket->key, __ATOMIC_RELAXED);
+		if (candidate == effectiveKey) {
+			return;
+		}
+		if (candidate == 0) {
+			target = bucket;
+			break;
+		}
+	}
+	uint32_t index;
+	if (!_claimSlot(&index)) {
+		return;
+	}
+	SharedSlot * slot = _slot(index);
+	memcpy(slot + 1, result, length);
+	uint32_t sequence;
+	if (!_acquireBucket(target, &sequence)) {
+		__atomic_store_n(&slot->writer, 0, __ATOMIC_RELEASE);
+		return;
+	}
+	const uint32_t replaced = __atomic_load_n(&target->slot, __ATOMIC_RELAXED);
+	if (replaced != 0 && replaced != index + 1) {
+		// The slot of the replaced result is free from now on.
+		__atomic_store_n(&_slot(replaced - 1)->bucket, 0, __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(&slot->bucket, (uint32_t) (target - _segment->buckets) + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->referenced, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&target->key, effectiveKey, __ATOMIC_RELAXED);
+	__atomic_store_n(&target->slot, index + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&target->length, (uint32_t) length, __ATOMIC_RELAXED);
+	_releaseBucket(target, sequence);
+	__atomic_store_n(&slot->writer, 0, __ATOMIC_RELEASE);
+	addToStatistic("shared-cache.stores", 1);
+}
@@ -0,0 +1,69 @@
+#ifndef SHARED_RESULT_CACHE_HEADER
+#define SHARED_RESULT_CACHE_HEADER
+
+#include "Buffer.h"
+#include "Hash.h"
+#include "Logger.h"
+#include "Statistics.h"
+#include "Type.h"
+#include "Version.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+void initializeSharedResultCacheModule();
+
+/** Shutdown module's internal state (detaches the segment, if attached). */
+void shutdownSharedResultCacheModule();
+
+/**
+ * A cache of compilation results shared by every compiler process of the same
+ * build and user, through a POSIX shared-memory segment. There is no daemon:
+ * the first process creates and initializes the segment, the following ones
+ * attach to it, and the last one to detach removes it.
+ *
+ * The segment holds a fixed-size slab of slots (one result per slot) and an
+ * open-addressing table of buckets that point to them. Each bucket is
+ * protected by a sequence lock: readers never block (they retry or miss if
+ * the sequence changed while copying), and writers acquire a bucket with a
+ * single compare-and-swap, giving up instead of waiting. Slots are recycled
+ * with the clock (second-chance) algorithm.
+ *
+ * Liveness is tracked with advisory locks on the segment, which the kernel
+ * releases when a process dies, and a lock left behind by a crashed writer is
+ * reclaimed once its process no longer exists.
+ *
+ * @see https://man7.org/linux/man-pages/man7/shm_overview.7.html
+ * @see https://en.wikipedia.org/wiki/Seqlock
+ * @see https://en.wikipedia.org/wiki/Page_replacement_algorithm#Clock
+ */
+
+/**
+ * Attaches to (or creates) the shared segment. Returns false if the shared
+ * cache cannot be used, in which case every other function is a no-op.
+ */
+boolean attachSharedResultCache();
+
+/**
+ * Appends the shared result of the key to the output and returns true, or
+ * returns false (leaving the output intact) if there is none.
+ */
+boolean loadSharedResult(const uint64_t key, Buffer * output);
+
+/**
+ * Publishes a result for other processes. Results bigger than a slot, and
+ * results whose bucket is being written by another process, are skipped.
+ */
+void storeSharedResult(const uint64_t key, const char * result, const size_t length);
+
+#endif
@@ -0,0 +1,95 @@
+#include "Statistics.h"
+
+/* MODULE INTERNAL STATE */
+
+#define MAXIMUM_STATISTICS 64
+
+typedef struct {
+	const char * name;
+	double value;
+} Statistic;
+
+static Logger * _logger = NULL;
+static boolean _logStatistics = false;
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+static Statistic _statistics[MAXIMUM_STATISTICS];
+static unsigned int _statisticsCount = 0;
+
+void initializeStatisticsModule() {
+	_logStatistics = getBooleanOrDefault("LOG_STATISTICS", _logStatistics);
+	_logger = createLogger("Statistics");
+	_statisticsCount = 0;
+}
+
+void shutdownStatisticsModule() {
+	if (_logStatistics) {
+		for (unsigned int k = 0; k < _statisticsCount; ++k) {
+			logInformation(_logger, "%s = %g", _statistics[k].name, _statistics[k].value);
+		}
+	}
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static Statistic * _findOrCreateStatistic(const char * name);
+
+/**
+ * Finds a statistic by name (linear search is fine, because there are only a
+ * few of them), or creates it. Returns NULL if there is no more room.
+ */
+static Statistic * _findOrCreateStatistic(const char * name) {
+	for (unsigned int k = 0; k < _statisticsCount; ++k) {
+		if (strcmp(_statistics[k].name, name) == 0) {
+			return &_statistics[k];
+		}
+	}
+	if (_statisticsCount == MAXIMUM_STATISTICS) {
+		return NULL;
+	}
+	Statistic * statistic = &_statistics[_statisticsCount++];
+	statistic->name = name;
+	statistic->value = 0;
+	return statistic;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void addToStatistic(const char * name, const double amount) {
+	pthread_mutex_lock(&_mutex);
+	Statistic * statistic = _findOrCreateStatistic(name);
+	if (statistic != NULL) {
+		statistic->value += amount;
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+void setStatistic(const char * name, const double value) {
+	pthread_mutex_lock(&_mutex);
+	Statistic * statistic = _findOrCreateStatistic(name);
+	if (statistic != NULL) {
+		statistic->value = value;
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+double getStatistic(const char * name) {
+	double value = 0;
+	pthread_mutex_lock(&_mutex);
+	for (unsigned int k = 0; k < _statisticsCount; ++k) {
+		if (strcmp(_statistics[k].name, name) == 0) {
+			value = _statistics[k].value;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&_mutex);
+	return value;
+}
+
+double monotonicTime() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
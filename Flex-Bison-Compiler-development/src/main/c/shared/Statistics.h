@@ -0,0 +1,45 @@
+#ifndef STATISTICS_HEADER
+#define STATISTICS_HEADER
+
+#include "Environment.h"
+#include "Logger.h"
+#include "Type.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Initialize module's internal state. */
+void initializeStatisticsModule();
+
+/**
+ * Shutdown module's internal state. If the "LOG_STATISTICS" variable is
+ * "true", every statistic collected so far is logged at INFORMATION level.
+ */
+void shutdownStatisticsModule();
+
+/**
+ * Adds an amount to the named statistic, creating it if needed. The name is
+ * not copied, so it must be a literal (or outlive the module). Statistics
+ * can be updated from any thread.
+ */
+void addToStatistic(const char * name, const double amount);
+
+/**
+ * Overwrites the value of the named statistic, creating it if needed.
+ */
+void setStatistic(const char * name, const double value);
+
+/**
+ * Retrieves the value of the named statistic, or zero if it doesn't exist.
+ */
+double getStatistic(const char * name);
+
+/**
+ * A monotonic clock, in seconds, to measure elapsed times.
+ *
+ * @see https://man7.org/linux/man-pages/man3/clock_gettime.3.html
+ */
+double monotonicTime();
+
+#endif
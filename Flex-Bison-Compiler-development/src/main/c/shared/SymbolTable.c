@@ -0,0 +1,188 @@
+#include "SymbolTable.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * An interned name, and its innermost binding (if the value is NULL, it's
+ * not bound). Names are never removed, so the table has no tombstones.
+ */
+typedef struct {
+	uint64_t hash;
+	void * value;
+	unsigned int depth;
+	char name[];
+} Symbol;
+
+/**
+ * A binding shadowed by a declaration, to restore when its scope is left.
+ */
+typedef struct {
+	Symbol * symbol;
+	void * value;
+	unsigned int depth;
+} Shadow;
+
+struct SymbolTable {
+	SymbolReleaser releaser;
+
+	// The interned names (open-addressing, linear probing).
+	Symbol ** symbols;
+	unsigned int capacity;
+	unsigned int count;
+
+	// The shadowed bindings, and where the ones of each frame start.
+	Shadow * shadows;
+	unsigned int shadowsCount;
+	unsigned int shadowsCapacity;
+	unsigned int * frames;
+	unsigned int depth;
+	unsigned int framesCapacity;
+};
+
+static Logger * _logger = NULL;
+
+void initializeSymbolTableModule() {
+	_logger = createLogger("SymbolTable");
+}
+
+void shutdownSymbolTableModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static Symbol * _intern(SymbolTable * symbolTable, const char * name);
+static void _rehash(SymbolTable * symbolTable);
+
+/**
+ * Finds the symbol of a name, interning it if needed.
+ */
+static Symbol * _intern(SymbolTable * symbolTable, const char * name) {
+	const uint64_t hash = hashString(name, 0);
+	const unsigned int mask = symbolTable->capacity - 1;
+	unsigned int k = hash & mask;
+	for (; symbolTable->symbols[k] != NULL; k = (k + 1) & mask) {
+		const Symbol * symbol = symbolTable->symbols[k];
+		if (symbol->hash == hash && strcmp(symbol->name, name) == 0) {
+			return symbolTable->symbols[k];
+		}
+	}
+	const size_t length = strlen(name);
+	Symbol * symbol = malloc(sizeof(Symbol) + length + 1);
+	symbol->hash = hash;
+	symbol->value = NULL;
+	symbol->depth = 0;
+	memcpy(symbol->name, name, length + 1);
+	symbolTable->symbols[k] = symbol;
+	if (symbolTable->capacity < 2 * ++symbolTable->count) {
+		_rehash(symbolTable);
+	}
+	return symbol;
+}
+
+/**
+ * Doubles the capacity of the table, keeping the load under a half.
+ */
+static void _rehash(SymbolTable * symbolTable) {
+	Symbol ** oldSymbols = symbolTable->symbols;
+	const unsigned int oldCapacity = symbolTable->capacity;
+	symbolTable->capacity = 2 * oldCapacity;
+	symbolTable->symbols = calloc(symbolTable->capacity, sizeof(Symbol *));
+	const unsigned int mask = symbolTable->capacity - 1;
+	for (unsigned int k = 0; k < oldCapacity; ++k) {
+		if (oldSymbols[k] != NULL) {
+			unsigned int j = oldSymbols[k]->hash & mask;
+			while (symbolTable->symbols[j] != NULL) {
+				j = (j + 1) & mask;
+			}
+			symbolTable->symbols[j] = oldSymbols[k];
+		}
+	}
+	free(oldSymbols);
+}
+
+/* PUBLIC FUNCTIONS */
+
+SymbolTable * createSymbolTable(SymbolReleaser releaser) {
+	SymbolTable * symbolTable = calloc(1, sizeof(SymbolTable));
+	symbolTable->releaser = releaser;
+	symbolTable->capacity = 64;
+	symbolTable->symbols = calloc(symbolTable->capacity, sizeof(Symbol *));
+	return symbolTable;
+}
+
+void destroySymbolTable(SymbolTable * symbolTable) {
+	if (symbolTable == NULL) {
+		return;
+	}
+	while (0 < symbolTable->depth) {
+		leaveScope(symbolTable);
+	}
+	for (unsigned int k = 0; k < symbolTable->capacity; ++k) {
+		Symbol * symbol = symbolTable->symbols[k];
+		if (symbol != NULL) {
+			if (symbol->value != NULL && symbolTable->releaser != NULL) {
+				symbolTable->releaser(symbol->value);
+			}
+			free(symbol);
+		}
+	}
+	free(symbolTable->symbols);
+	free(symbolTable->shadows);
+	free(symbolTable->frames);
+	free(symbolTable);
+}
+
+void enterScope(SymbolTable * symbolTable) {
+	if (symbolTable->depth == symbolTable->framesCapacity) {
+		symbolTable->framesCapacity = symbolTable->framesCapacity == 0 ? 16 : 2 * symbolTable->framesCapacity;
+		symbolTable->frames = realloc(symbolTable->frames, symbolTable->framesCapacity * sizeof(unsigned int));
+	}
+	symbolTable->frames[symbolTable->depth++] = symbolTable->shadowsCount;
+}
+
+void leaveScope(SymbolTable * symbolTable) {
+	if (symbolTable->depth == 0) {
+		logError(_logger, "There is no scope to leave.");
+		return;
+	}
+	const unsigned int start = symbolTable->frames[--symbolTable->depth];
+	while (start < symbolTable->shadowsCount) {
+		const Shadow * shadow = &symbolTable->shadows[--symbolTable->shadowsCount];
+		if (symbolTable->releaser != NULL) {
+			symbolTable->releaser(shadow->symbol->value);
+		}
+		shadow->symbol->value = shadow->value;
+		shadow->symbol->depth = shadow->depth;
+	}
+}
+
+boolean declareSymbol(SymbolTable * symbolTable, const char * name, void * value) {
+	Symbol * symbol = _intern(symbolTable, name);
+	if (symbol->value != NULL && symbol->depth == symbolTable->depth) {
+		return false;
+	}
+	if (0 < symbolTable->depth) {
+		// The global scope is never left, so it shadows nothing.
+		if (symbolTable->shadowsCount == symbolTable->shadowsCapacity) {
+			symbolTable->shadowsCapacity = symbolTable->shadowsCapacity == 0 ? 64 : 2 * symbolTable->shadowsCapacity;
+			symbolTable->shadows = realloc(symbolTable->shadows, symbolTable->shadowsCapacity * sizeof(Shadow));
+		}
+		symbolTable->shadows[symbolTable->shadowsCount++] = (Shadow) {
+			.symbol = symbol,
+			.value = symbol->value,
+			.depth = symbol->depth
+		};
+	}
+	symbol->value = value;
+	symbol->depth = symbolTable->depth;
+	addToStatistic("symbol-table.declarations", 1);
+	return true;
+}
+
+void * lookupSymbol(SymbolTable * symbolTable, const char * name) {
+	addToStatistic("symbol-table.lookups", 1);
+	return _intern(symbolTable, name)->value;
+}
@@ -0,0 +1,59 @@
+#ifndef SYMBOL_TABLE_HEADER
+#define SYMBOL_TABLE_HEADER
+
+#include "Hash.h"
+#include "Logger.h"
+#include "Statistics.h"
+#include "Type.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeSymbolTableModule();
+
+/** Shutdown module's internal state. */
+void shutdownSymbolTableModule();
+
+/**
+ * A table of symbols with lexical scopes. Every name is interned in an
+ * open-addressing table (so a lookup is a single probe sequence, no matter
+ * how many symbols or scopes there are), and each one holds its innermost
+ * binding. The scopes are a stack of frames: each frame remembers the
+ * bindings it shadowed, and restores them when it's left.
+ */
+typedef struct SymbolTable SymbolTable;
+
+/**
+ * Releases the value of a binding, once its scope is left (or the table is
+ * destroyed).
+ */
+typedef void (*SymbolReleaser)(void * value);
+
+SymbolTable * createSymbolTable(SymbolReleaser releaser);
+
+/**
+ * Leaves every scope still open, and destroys the table.
+ */
+void destroySymbolTable(SymbolTable * symbolTable);
+
+void enterScope(SymbolTable * symbolTable);
+
+/**
+ * Leaves the innermost scope, releasing its bindings.
+ */
+void leaveScope(SymbolTable * symbolTable);
+
+/**
+ * Binds a name to a value (that the table owns from now on) in the innermost
+ * scope. Returns false, without binding it, if the name was already declared
+ * in that same scope.
+ */
+boolean declareSymbol(SymbolTable * symbolTable, const char * name, void * value);
+
+/**
+ * The value of the innermost binding of a name, or NULL if there is none.
+ */
+void * lookupSymbol(SymbolTable * symbolTable, const char * name);
+
+#endif
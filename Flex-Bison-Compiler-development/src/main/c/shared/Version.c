@@ -0,0 +1,8 @@
+#include "Version.h"
+
+/* PUBLIC FUNCTIONS */
+
+const char * compilerBuildIdentifier() {
+	// Expanded in a single translation unit, so it's the same for everyone.
+	return COMPILER_VERSION " (" __DATE__ " " __TIME__ ")";
+}
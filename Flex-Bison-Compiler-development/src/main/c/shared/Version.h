@@ -0,0 +1,16 @@
+#ifndef VERSION_HEADER
+#define VERSION_HEADER
+
+/**
+ * The released version of the compiler.
+ */
+#define COMPILER_VERSION "1.1.0"
+
+/**
+ * An identifier of this exact build of the compiler (the version plus the
+ * moment of compilation). Everything persisted by the compiler that depends
+ * on its internal layout (e.g., caches) must be invalidated when it changes.
+ */
+const char * compilerBuildIdentifier();
+
+#endif